@@ -0,0 +1,21 @@
+/**
+ * @file airlines.cpp
+ * Implementation of airline dictionary class.
+ */
+
+#include "airlines.h"
+
+int AirlineDictionary::intern(string_view name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it -> second;
+    }
+
+    names.emplace_back(name);
+    ids.emplace(names.back(), names.size() - 1);
+    return names.size() - 1;
+}
+
+vector<string> AirlineDictionary::get_names() const {
+    return vector<string>(names.begin(), names.end());
+}
@@ -0,0 +1,69 @@
+/**
+ * @file airlines.h
+ * Definition of airline dictionary class.
+ */
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Interned airline names, numbered in the order they are first seen.
+ *
+ * Every route of an airline shares one copy of its name, and routes only
+ * store the airline ID. Names never move once interned, so references to
+ * them stay valid for the lifetime of the dictionary.
+ * @author Vaibhav Gupta
+ */
+class AirlineDictionary {
+    public:
+        AirlineDictionary() = default;
+        AirlineDictionary(const AirlineDictionary &other) = delete;
+        AirlineDictionary &operator=(const AirlineDictionary &other) = delete;
+
+        /**
+         * Returns the ID of an airline, adding it if it is not known yet.
+         * @param name Name of airline.
+         * @returns Airline ID.
+         */
+        int intern(string_view name);
+
+        /**
+         * Returns name of an airline.
+         * @param id Airline ID.
+         * @returns Reference to name of airline.
+         */
+        const string &get_name(int id) const;
+
+        /**
+         * Returns the names of every airline.
+         * @returns Vector of names indexed by airline ID.
+         */
+        vector<string> get_names() const;
+
+        /**
+         * Returns number of airlines.
+         * @returns Number of airlines.
+         */
+        unsigned long size() const;
+
+    private:
+        deque<string> names;
+
+        // Views of the names, which live in the deque.
+        unordered_map<string_view, int> ids;
+};
+
+inline const string &AirlineDictionary::get_name(int id) const {
+    return names[id];
+}
+
+inline unsigned long AirlineDictionary::size() const {
+    return names.size();
+}
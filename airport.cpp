@@ -3,39 +3,63 @@
  * Implementation of airport class.
  */
 
+#include <algorithm>
 #include <iostream>
 
 #include "airport.h"
 
-Airport::Airport(int id, string name, string city) {
+Airport::Airport(int id, string_view name, string_view city) {
     this -> id = id;
     this -> name = name;
     this -> city = city;
 }
 
-Airport::~Airport() {
-    for (Route *route : routes) {
-        delete route;
-    }
+void Airport::reserve_routes(unsigned long num_routes, unsigned long num_incoming) {
+    routes.reserve(num_routes);
+    incoming_routes.reserve(num_incoming);
 }
 
 void Airport::add_route(Route *route) {
     routes.push_back(route);
 }
 
-vector<Route*> Airport::get_routes() const {
+bool Airport::remove_route(Route *route) {
+    auto it = std::find(routes.begin(), routes.end(), route);
+    if (it == routes.end()) {
+        return false;
+    }
+    routes.erase(it);
+    return true;
+}
+
+void Airport::remove_incoming_route(Route *route) {
+    auto it = std::find(incoming_routes.begin(), incoming_routes.end(), route);
+    if (it != incoming_routes.end()) {
+        incoming_routes.erase(it);
+    }
+}
+
+const vector<Route*> &Airport::get_routes() const {
     return routes;
 }
 
+void Airport::add_incoming_route(Route *route) {
+    incoming_routes.push_back(route);
+}
+
+const vector<Route*> &Airport::get_incoming_routes() const {
+    return incoming_routes;
+}
+
 int Airport::get_id() const {
     return id;
 }
 
-string Airport::get_name() const {
+string_view Airport::get_name() const {
     return name;
 }
 
-string Airport::get_city() const {
+string_view Airport::get_city() const {
     return city;
 }
 
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "route.h"
@@ -19,15 +20,22 @@ using namespace std;
 class Airport {
     public:
         /**
-         * Constructor to create airport.
+         * Constructor to create airport. Routes are owned by the graph
+         * that created them, not by their airports.
          * @param id Unique numerical identifier for airport.
-         * @param name Name of airport.
-         * @param city City in which airport is located in.
+         * @param name Name of airport, which must outlive the airport.
+         * @param city City in which airport is located in, which must
+         * outlive the airport.
          */
-        Airport(int id, string name, string city);
+        Airport(int id, string_view name, string_view city);
 
-        // Destructor to delete airport.
-        ~Airport();
+        /**
+         * Reserves space for routes, avoiding repeated growth when the
+         * number of routes is known in advance.
+         * @param num_routes Number of outgoing routes.
+         * @param num_incoming Number of incoming routes.
+         */
+        void reserve_routes(unsigned long num_routes, unsigned long num_incoming);
 
         /**
          * Adds route to airport.
@@ -36,11 +44,40 @@ class Airport {
          */ 
         void add_route(Route *route);
 
+        /**
+         * Removes route from airport, keeping the order of other routes.
+         * @param route Pointer to route which has this airport as 
+         * its source airport.
+         * @returns Boolean representing if the route was found or not.
+         */ 
+        bool remove_route(Route *route);
+
+        /**
+         * Removes incoming route from airport.
+         * @param route Pointer to route which has this airport as 
+         * its destination airport.
+         */ 
+        void remove_incoming_route(Route *route);
+
         /**
          * Returns all airport routes.
-         * @returns Vector of pointers to routes of the airport.
+         * @returns Reference to vector of pointers to routes of the airport.
+         */ 
+        const vector<Route*> &get_routes() const;
+
+        /**
+         * Adds incoming route to airport, which remains owned by its
+         * source airport.
+         * @param route Pointer to route which has this airport as 
+         * its destination airport.
+         */ 
+        void add_incoming_route(Route *route);
+
+        /**
+         * Returns all routes arriving at the airport.
+         * @returns Reference to vector of pointers to incoming routes.
          */ 
-        vector<Route*> get_routes() const;
+        const vector<Route*> &get_incoming_routes() const;
 
         /**
          * Returns ID of airport.
@@ -50,21 +87,22 @@ class Airport {
 
         /**
          * Returns name of airport.
-         * @returns Name of airport.
+         * @returns View of name of airport.
          */
-        string get_name() const;
+        string_view get_name() const;
 
         /**
          * Returns city of airport.
-         * @returns City of airport.
+         * @returns View of city of airport.
          */ 
-        string get_city() const;
+        string_view get_city() const;
         
     private:
         int id;
-        string name, city;
+        string_view name, city;
 
         vector<Route*> routes;
+        vector<Route*> incoming_routes;
 };
 
 /**
@@ -0,0 +1,364 @@
+/**
+ * @file approx_betweenness.cpp
+ * Implementation of sampled betweenness centrality class.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "approx_betweenness.h"
+
+// Constant of the Riondato-Kornaropoulos sample bound.
+static const double SAMPLE_CONSTANT = 0.5;
+
+// Samples of the first round, doubled every round after.
+static const unsigned long FIRST_ROUND = 1024;
+
+// Relative margin by which the searches overshoot the shortest cost, so
+// that airports tied at both last costs are not lost to rounding.
+static const double COST_TOLERANCE = 1e-9;
+
+/**
+ * Small random number generator (SplitMix64) seeded per sample, so that
+ * samples do not depend on which thread draws them.
+ */
+struct SampleRandom {
+    uint64_t state;
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+void ApproxBetweenness::run(const CSR &csr, const CSR &reverse_csr, double epsilon,
+        double delta, ThreadPool &pool, uint64_t seed) {
+    unsigned long n = csr.num_airports();
+    this -> seed = seed;
+    scores.assign(n, 0);
+    num_samples = max_samples = 0;
+    error_bound = 0;
+    reachable_fraction = 0;
+    counters = PhaseMetrics();
+
+    if (!(epsilon > 0 && epsilon < 1 && delta > 0 && delta < 1)) {
+        return;
+    }
+
+    // Without a route between two different airports no pair is reachable.
+    bool has_pair = false;
+    for (unsigned long u = 0; u < n && !has_pair; u++) {
+        for (unsigned e = csr.get_begin(u); e < csr.get_end(u) && !has_pair; e++) {
+            has_pair = csr.get_dest(e) != (int)u;
+        }
+    }
+    if (!has_pair) {
+        return;
+    }
+
+    // Shortest paths have at most V airports, bounding the vertex diameter.
+    double diameter_term = std::floor(std::log2(std::max(2.0, n - 2.0))) + 1;
+    max_samples = (unsigned long)std::ceil(SAMPLE_CONSTANT / (epsilon * epsilon) *
+        (diameter_term + std::log(2 / delta)));
+    unsigned long num_rounds = 1;
+    for (unsigned long m = std::min(FIRST_ROUND, max_samples); m < max_samples; m *= 2) {
+        num_rounds++;
+    }
+
+    vector<Scratch> scratch(pool.size());
+    for (Scratch &state : scratch) {
+        state.counts.assign(n, 0);
+        state.end_counts.assign(n, 0);
+    }
+    vector<unsigned long> counts(n, 0), end_counts(n, 0);
+    error_bound = epsilon;
+
+    // Each airport is checked after every round, so the adaptive half of
+    // delta is divided between all airports and rounds.
+    double log_term = std::log(4 * n * num_rounds / (delta / 2));
+    unsigned long target = std::min(FIRST_ROUND, max_samples);
+    while (num_samples < max_samples) {
+        unsigned long first = num_samples;
+        pool.parallel_for(target - first, [&](unsigned long i, unsigned thread) {
+            sample(csr, reverse_csr, first + i, scratch[thread]);
+        });
+        num_samples = target;
+        if (num_samples >= max_samples) {
+            break;
+        }
+
+        // Sample variance is largest for the airport credited closest to
+        // half of the samples, which therefore has the widest bound.
+        std::fill(counts.begin(), counts.end(), 0);
+        for (const Scratch &state : scratch) {
+            for (unsigned long v = 0; v < n; v++) {
+                counts[v] += state.counts[v];
+            }
+        }
+        double m = num_samples, widest = 0;
+        for (unsigned long v = 0; v < n; v++) {
+            double p = counts[v] / m;
+            widest = std::max(widest, p * (1 - p));
+        }
+        double variance = widest * m / (m - 1);
+        double radius = std::sqrt(2 * variance * log_term / m) + 7 * log_term / (3 * (m - 1));
+        if (radius <= epsilon) {
+            error_bound = radius;
+            break;
+        }
+        target = std::min(2 * target, max_samples);
+    }
+
+    unsigned long attempts = 0;
+    std::fill(counts.begin(), counts.end(), 0);
+    for (const Scratch &state : scratch) {
+        for (unsigned long v = 0; v < n; v++) {
+            counts[v] += state.counts[v];
+            end_counts[v] += state.end_counts[v];
+        }
+        attempts += state.attempts;
+        counters.add(state.counters);
+        counters.add_heap(state.heaps[0].get_counters());
+        counters.add_heap(state.heaps[1].get_counters());
+    }
+    for (unsigned long v = 0; v < n; v++) {
+        unsigned long other_samples = num_samples - end_counts[v];
+        scores[v] = other_samples > 0 ? (double)counts[v] / other_samples : 0;
+    }
+    reachable_fraction = (double)num_samples / attempts;
+}
+
+const vector<double> &ApproxBetweenness::get_scores() const {
+    return scores;
+}
+
+unsigned long ApproxBetweenness::get_num_samples() const {
+    return num_samples;
+}
+
+unsigned long ApproxBetweenness::get_max_samples() const {
+    return max_samples;
+}
+
+double ApproxBetweenness::get_error_bound() const {
+    return error_bound;
+}
+
+double ApproxBetweenness::get_reachable_fraction() const {
+    return reachable_fraction;
+}
+
+const PhaseMetrics &ApproxBetweenness::get_counters() const {
+    return counters;
+}
+
+void ApproxBetweenness::sample(const CSR &csr, const CSR &reverse_csr, unsigned long index,
+        Scratch &scratch) const {
+    unsigned long n = csr.num_airports();
+    SampleRandom random{seed ^ (index * 0xd1b54a32d192ed03ull)};
+    Heap *heaps = scratch.heaps;
+    vector<double> *num_paths = scratch.num_paths;
+    const CSR *adjacency[2] = {&csr, &reverse_csr};
+    for (int side = 0; side < 2; side++) {
+        scratch.costs[side].resize(n);
+        num_paths[side].resize(n);
+    }
+
+    // Last cost popped by each side, and cost of the shortest path found.
+    int ends[2];
+    double last[2];
+    double best = INF_COST;
+    while (best == INF_COST) {
+        scratch.attempts++;
+        ends[0] = random.next() % n;
+        ends[1] = random.next() % (n - 1);
+        ends[1] += ends[1] >= ends[0];
+
+        unsigned long scanned[2] = {0, 0};
+        for (int side = 0; side < 2; side++) {
+            heaps[side].reset(n, ends[side]);
+            scratch.order[side].clear();
+            last[side] = 0;
+        }
+
+        while (true) {
+            // An exhausted side has settled everything it can reach, leaving
+            // the pair unreachable if the sides never met.
+            if (heaps[0].empty() || heaps[1].empty()) {
+                last[heaps[0].empty() ? 0 : 1] = INF_COST;
+                break;
+            }
+            int side = scanned[0] <= scanned[1] ? 0 : 1;
+            int current = heaps[side].pop();
+            double cost = heaps[side].get_cost(current);
+            last[side] = cost;
+
+            // Every shortest path now has an airport settled by each side,
+            // counting ties since the sum is strictly greater.
+            if (last[0] + last[1] > best * (1 + COST_TOLERANCE)) {
+                break;
+            }
+            scratch.order[side].push_back(current);
+            const CSR &routes = *adjacency[side];
+            scanned[side] += routes.get_end(current) - routes.get_begin(current);
+            scratch.counters.airports_settled++;
+            scratch.counters.edges_scanned += routes.get_end(current) - routes.get_begin(current);
+
+            for (unsigned e = routes.get_begin(current); e < routes.get_end(current); e++) {
+                int next_id = routes.get_dest(e);
+                if (next_id == current) {
+                    continue;
+                }
+                double curr_cost = cost + routes.get_weight(e);
+                if (curr_cost < heaps[side].get_cost(next_id)) {
+                    heaps[side].update(next_id, curr_cost);
+                }
+
+                // Path costs are always summed as forward cost plus route plus
+                // backward cost, so that equal paths compare equal below.
+                double other = heaps[1 - side].get_cost(next_id);
+                if (other != INF_COST) {
+                    double total = side == 0 ? curr_cost + other :
+                        (other + routes.get_weight(e)) + cost;
+                    best = std::min(best, total);
+                }
+            }
+        }
+    }
+
+    scratch.end_counts[ends[0]]++;
+    scratch.end_counts[ends[1]]++;
+
+    // Airports cheaper than the last cost of a side are settled with exact
+    // path counts. A shortest path lies entirely on one side, or leaves the
+    // forward side over exactly one route into the backward side.
+    auto settled = [&](int side, int id) {
+        return heaps[side].get_cost(id) < last[side];
+    };
+
+    // Settled airports come first in the order of each side. Their paths
+    // are counted once the search is done, over routes from airports the
+    // PathOrder of the side puts earlier, so that no path goes around a
+    // cycle of zero-cost routes. Counts are only read for settled airports,
+    // so they need no clearing between searches.
+    for (int side = 0; side < 2; side++) {
+        vector<int> &order = scratch.order[side];
+        vector<double> &costs = scratch.costs[side];
+        unsigned long num_settled = 0;
+        while (num_settled < order.size() && settled(side, order[num_settled])) {
+            costs[order[num_settled]] = heaps[side].get_cost(order[num_settled]);
+            num_settled++;
+        }
+        order.resize(num_settled);
+
+        const CSR &back = *adjacency[1 - side];
+        PathOrder &path_order = scratch.path_orders[side];
+        path_order.sort(*adjacency[side], back, costs, ends[side], order);
+        for (int current : order) {
+            num_paths[side][current] = current == ends[side];
+            for (unsigned e = back.get_begin(current); e < back.get_end(current); e++) {
+                int prev_id = back.get_dest(e);
+                if (path_order.precedes(prev_id, current) &&
+                        costs[prev_id] + back.get_weight(e) == costs[current]) {
+                    num_paths[side][current] += num_paths[side][prev_id];
+                }
+            }
+        }
+    }
+    if (settled(0, ends[1])) {
+        walk(ends[1], reverse_csr, 0, ends, random, scratch);
+        return;
+    }
+    if (settled(1, ends[0])) {
+        walk(ends[0], csr, 1, ends, random, scratch);
+        return;
+    }
+
+    // Visits every route leaving the forward side into the backward side,
+    // from the side that settled fewer airports, with the cost and number
+    // of the paths over it. Each shortest path crosses exactly one.
+    auto for_each_cut = [&](auto visit) {
+        int side = scratch.order[0].size() <= scratch.order[1].size() ? 0 : 1;
+        const CSR &routes = *adjacency[side];
+        for (int current : scratch.order[side]) {
+            if (!settled(side, current)) {
+                continue;
+            }
+            for (unsigned e = routes.get_begin(current); e < routes.get_end(current); e++) {
+                int from = side == 0 ? current : routes.get_dest(e);
+                int to = side == 0 ? routes.get_dest(e) : current;
+                if (from == to || !settled(0, from) || !settled(1, to)) {
+                    continue;
+                }
+                double cost = heaps[0].get_cost(from) + routes.get_weight(e);
+                if (cost >= last[0] && visit(from, to, cost + heaps[1].get_cost(to),
+                        num_paths[0][from] * num_paths[1][to])) {
+                    return;
+                }
+            }
+        }
+    };
+
+    // The shortest cost is taken over the cut itself, since the cost found
+    // by the search may have been summed over other routes and differ in
+    // rounding.
+    double shortest = INF_COST, total = 0;
+    for_each_cut([&](int, int, double cost, double paths) {
+        if (cost < shortest) {
+            shortest = cost;
+            total = 0;
+        }
+        total += cost == shortest ? paths : 0;
+        return false;
+    });
+    double pick = random.uniform() * total;
+    int cut[2] = {-1, -1};
+    for_each_cut([&](int from, int to, double cost, double paths) {
+        if (cost == shortest) {
+            cut[0] = from;
+            cut[1] = to;
+            pick -= paths;
+        }
+        return pick < 0;
+    });
+    walk(cut[0], reverse_csr, 0, ends, random, scratch);
+    walk(cut[1], csr, 1, ends, random, scratch);
+}
+
+void ApproxBetweenness::walk(int id, const CSR &adjacency, int side, const int pair_ends[2],
+        SampleRandom &random, Scratch &scratch) const {
+    const vector<double> &costs = scratch.costs[side];
+    const vector<double> &num_paths = scratch.num_paths[side];
+    const PathOrder &path_order = scratch.path_orders[side];
+    for (int current = id; ; ) {
+        if (current != pair_ends[0] && current != pair_ends[1]) {
+            scratch.counts[current]++;
+        }
+        if (current == pair_ends[side]) {
+            break;
+        }
+
+        // Chooses the previous airport among those the paths were counted
+        // from, with probability proportional to its path count.
+        double pick = random.uniform() * num_paths[current];
+        int chosen = -1;
+        for (unsigned e = adjacency.get_begin(current); e < adjacency.get_end(current); e++) {
+            int prev_id = adjacency.get_dest(e);
+            if (path_order.precedes(prev_id, current) &&
+                    costs[prev_id] + adjacency.get_weight(e) == costs[current]) {
+                chosen = prev_id;
+                pick -= num_paths[prev_id];
+                if (pick < 0) {
+                    break;
+                }
+            }
+        }
+        current = chosen;
+    }
+}
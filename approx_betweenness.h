@@ -0,0 +1,153 @@
+/**
+ * @file approx_betweenness.h
+ * Definition of sampled betweenness centrality class.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "heap.h"
+#include "csr.h"
+#include "path_order.h"
+#include "metrics.h"
+#include "threadpool.h"
+
+using namespace std;
+
+struct SampleRandom;
+
+/**
+ * Betweenness centrality estimated from randomly sampled shortest paths,
+ * for networks too large for an exact computation.
+ *
+ * Each sample picks a pair of airports uniformly among the pairs whose
+ * destination is reachable from their source, then one of their shortest
+ * paths uniformly by path counts, and credits the airports inside it. The
+ * fraction of samples crediting an airport estimates its share of all
+ * shortest paths. Scores divide by the samples that neither start nor end
+ * at the airport instead, like the score computed by Graph::brandes().
+ *
+ * Pairs are searched from both ends at once, always growing the side that
+ * has scanned fewer routes, so that on hub-and-spoke networks both sides
+ * meet at a few hubs after settling a small part of the graph. Shortest
+ * paths are then counted across the routes joining the two sides.
+ *
+ * With probability at least 1 - delta, every share is within epsilon,
+ * which bounds the scores up to the fraction of pairs ending at each
+ * airport, about 2/V on networks where most pairs are reachable. Samples are drawn in doubling rounds, stopping once the
+ * empirical Bernstein bound of every airport is within epsilon, and at the
+ * latest after the Riondato-Kornaropoulos bound on the number of samples,
+ * each half of the guarantee using delta / 2.
+ * @author Vaibhav Gupta
+ */
+class ApproxBetweenness {
+    public:
+        /**
+         * Estimates the centrality of every airport, replacing any previous
+         * scores. Samples are drawn in parallel and are deterministic for
+         * a given seed regardless of the number of threads.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph of the same graph.
+         * @param epsilon Maximum absolute error of each score, in (0, 1).
+         * @param delta Maximum probability of any score exceeding the error,
+         * in (0, 1), otherwise every score is left 0.
+         * @param pool Reference to thread pool to sample on.
+         * @param seed Seed of the random samples.
+         */
+        void run(const CSR &csr, const CSR &reverse_csr, double epsilon, double delta,
+            ThreadPool &pool, uint64_t seed = 42);
+
+        /**
+         * Returns the estimated centrality of every airport.
+         * @returns Reference to vector of scores indexed by airport ID.
+         */
+        const vector<double> &get_scores() const;
+
+        /**
+         * Returns the number of paths sampled.
+         * @returns Number of samples.
+         */
+        unsigned long get_num_samples() const;
+
+        /**
+         * Returns the number of samples that guarantees the error without
+         * stopping early.
+         * @returns Maximum number of samples.
+         */
+        unsigned long get_max_samples() const;
+
+        /**
+         * Returns the largest error of any score guaranteed by the samples
+         * drawn, at most epsilon.
+         * @returns Error bound.
+         */
+        double get_error_bound() const;
+
+        /**
+         * Returns the fraction of sampled pairs whose destination was
+         * reachable from their source.
+         * @returns Fraction of reachable pairs.
+         */
+        double get_reachable_fraction() const;
+
+        /**
+         * Returns the work done by the searches of the last run.
+         * @returns Reference to counters of the searches.
+         */
+        const PhaseMetrics &get_counters() const;
+
+    private:
+        /**
+         * Search state and sample counts of one thread.
+         */
+        struct Scratch {
+            // Forward search from the source and backward search from the
+            // destination, with the number of shortest paths to each airport
+            // and the order they are counted in.
+            Heap heaps[2];
+            vector<double> costs[2], num_paths[2];
+            vector<int> order[2];
+            PathOrder path_orders[2];
+            vector<unsigned long> counts, end_counts;
+            unsigned long attempts = 0;
+            PhaseMetrics counters;
+        };
+
+        /**
+         * Helper function to draw one sample, retrying pairs until the
+         * destination is reachable, and credit the airports inside its path.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph.
+         * @param index Index of sample, which seeds its random numbers.
+         * @param scratch Reference to state of the calling thread.
+         */
+        void sample(const CSR &csr, const CSR &reverse_csr, unsigned long index,
+            Scratch &scratch) const;
+
+        /**
+         * Helper function to walk from an airport back to the airport one of
+         * the searches started at, choosing each step among the routes its
+         * paths were counted over with probability proportional to their
+         * path count, and credit the
+         * airports passed other than the ends of the sampled pair.
+         * @param id Airport ID to walk from.
+         * @param adjacency Reference to routes leading back towards the
+         * start of the search, the reverse CSR for the forward search.
+         * @param side 0 for the forward search, 1 for the backward search.
+         * @param pair_ends IDs of the source and destination of the pair.
+         * @param random Reference to random number state of the sample.
+         * @param scratch Reference to state of the calling thread.
+         */
+        void walk(int id, const CSR &adjacency, int side, const int pair_ends[2],
+            SampleRandom &random, Scratch &scratch) const;
+
+        uint64_t seed = 0;
+        vector<double> scores;
+        unsigned long num_samples = 0;
+        unsigned long max_samples = 0;
+        double error_bound = 0;
+        double reachable_fraction = 0;
+        PhaseMetrics counters;
+};
@@ -0,0 +1,337 @@
+/**
+ * @file apsp.cpp
+ * Implementation of blocked all-pairs shortest-path classes.
+ */
+
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
+#include <new>
+
+#include "apsp.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define APSP_X86
+#include <immintrin.h>
+#endif
+
+template <typename T>
+DistanceMatrix<T>::DistanceMatrix(unsigned long size, unsigned tile) {
+    this -> tile = std::max(16u, (tile + 15) / 16 * 16);
+    n = size;
+    stride = (n + this -> tile - 1) / this -> tile * this -> tile;
+
+    void *dist_mem = NULL, *next_mem = NULL;
+    if (posix_memalign(&dist_mem, 64, stride * stride * sizeof(T)) != 0 ||
+            posix_memalign(&next_mem, 64, stride * stride * sizeof(int)) != 0) {
+        free(dist_mem);
+        throw bad_alloc();
+    }
+    dist = static_cast<T*>(dist_mem);
+    next = static_cast<int*>(next_mem);
+
+    std::fill(dist, dist + stride * stride, numeric_limits<T>::infinity());
+    std::fill(next, next + stride * stride, -1);
+    for (unsigned long i = 0; i < n; i++) {
+        set(i, i, 0, i);
+    }
+}
+
+template <typename T>
+DistanceMatrix<T>::~DistanceMatrix() {
+    free(dist);
+    free(next);
+}
+
+template <typename T>
+void DistanceMatrix<T>::load(const CSR &csr) {
+    for (unsigned long i = 0; i < csr.num_airports(); i++) {
+        for (unsigned e = csr.get_begin(i); e < csr.get_end(i); e++) {
+            int dest_id = csr.get_dest(e);
+            if ((T)csr.get_weight(e) < get(i, dest_id)) {
+                set(i, dest_id, csr.get_weight(e), dest_id);
+            }
+        }
+    }
+}
+
+template <typename T>
+T DistanceMatrix<T>::get(unsigned long src_id, unsigned long dest_id) const {
+    return dist[src_id * stride + dest_id];
+}
+
+template <typename T>
+int DistanceMatrix<T>::get_next(unsigned long src_id, unsigned long dest_id) const {
+    return next[src_id * stride + dest_id];
+}
+
+template <typename T>
+void DistanceMatrix<T>::set(unsigned long src_id, unsigned long dest_id, T cost, int next) {
+    dist[src_id * stride + dest_id] = cost;
+    this -> next[src_id * stride + dest_id] = next;
+}
+
+template <typename T>
+unsigned long DistanceMatrix<T>::size() const {
+    return n;
+}
+
+template <typename T>
+unsigned DistanceMatrix<T>::get_tile() const {
+    return tile;
+}
+
+template <typename T>
+unsigned long DistanceMatrix<T>::num_tiles() const {
+    return stride / tile;
+}
+
+template <typename T>
+T *DistanceMatrix<T>::get_row(unsigned long row) {
+    return dist + row * stride;
+}
+
+template <typename T>
+int *DistanceMatrix<T>::get_next_row(unsigned long row) {
+    return next + row * stride;
+}
+
+template <typename T>
+unsigned long DistanceMatrix<T>::get_stride() const {
+    return stride;
+}
+
+/**
+ * Portable tile kernel. The branch on the route into the tile is hoisted
+ * out of the innermost loop, which the compiler is then free to vectorize.
+ */
+template <typename T>
+static void relax_tile_scalar(T *c, int *c_next, const T *a, const int *a_next,
+        const T *b, unsigned long stride, unsigned tile) {
+    for (unsigned k = 0; k < tile; k++) {
+        const T *b_row = b + k * stride;
+        for (unsigned i = 0; i < tile; i++) {
+            T a_ik = a[i * stride + k];
+            if (a_ik == numeric_limits<T>::infinity()) {
+                continue;
+            }
+
+            int next_ik = a_next[i * stride + k];
+            T *c_row = c + i * stride;
+            int *c_next_row = c_next + i * stride;
+            for (unsigned j = 0; j < tile; j++) {
+                T cost = a_ik + b_row[j];
+                if (cost < c_row[j]) {
+                    c_row[j] = cost;
+                    c_next_row[j] = next_ik;
+                }
+            }
+        }
+    }
+}
+
+#ifdef APSP_X86
+__attribute__((target("avx2")))
+static void relax_tile_avx2(double *c, int *c_next, const double *a, const int *a_next,
+        const double *b, unsigned long stride, unsigned tile) {
+    // Gathers the low half of each 64-bit comparison mask into 32-bit lanes.
+    const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    for (unsigned k = 0; k < tile; k++) {
+        const double *b_row = b + k * stride;
+        for (unsigned i = 0; i < tile; i++) {
+            double a_ik = a[i * stride + k];
+            if (a_ik == numeric_limits<double>::infinity()) {
+                continue;
+            }
+
+            __m256d a_vec = _mm256_set1_pd(a_ik);
+            __m128i next_vec = _mm_set1_epi32(a_next[i * stride + k]);
+            double *c_row = c + i * stride;
+            int *c_next_row = c_next + i * stride;
+            for (unsigned j = 0; j < tile; j += 4) {
+                __m256d cost = _mm256_add_pd(a_vec, _mm256_load_pd(b_row + j));
+                __m256d curr = _mm256_load_pd(c_row + j);
+                __m256d mask = _mm256_cmp_pd(cost, curr, _CMP_LT_OQ);
+                _mm256_store_pd(c_row + j, _mm256_blendv_pd(curr, cost, mask));
+
+                __m128i mask32 = _mm256_castsi256_si128(
+                    _mm256_permutevar8x32_epi32(_mm256_castpd_si256(mask), pack));
+                __m128i *next_ptr = reinterpret_cast<__m128i*>(c_next_row + j);
+                _mm_store_si128(next_ptr, _mm_blendv_epi8(_mm_load_si128(next_ptr),
+                    next_vec, mask32));
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void relax_tile_avx2(float *c, int *c_next, const float *a, const int *a_next,
+        const float *b, unsigned long stride, unsigned tile) {
+    for (unsigned k = 0; k < tile; k++) {
+        const float *b_row = b + k * stride;
+        for (unsigned i = 0; i < tile; i++) {
+            float a_ik = a[i * stride + k];
+            if (a_ik == numeric_limits<float>::infinity()) {
+                continue;
+            }
+
+            __m256 a_vec = _mm256_set1_ps(a_ik);
+            __m256 next_vec = _mm256_castsi256_ps(_mm256_set1_epi32(a_next[i * stride + k]));
+            float *c_row = c + i * stride;
+            int *c_next_row = c_next + i * stride;
+            for (unsigned j = 0; j < tile; j += 8) {
+                __m256 cost = _mm256_add_ps(a_vec, _mm256_load_ps(b_row + j));
+                __m256 curr = _mm256_load_ps(c_row + j);
+                __m256 mask = _mm256_cmp_ps(cost, curr, _CMP_LT_OQ);
+                _mm256_store_ps(c_row + j, _mm256_blendv_ps(curr, cost, mask));
+
+                float *next_ptr = reinterpret_cast<float*>(c_next_row + j);
+                _mm256_store_ps(next_ptr, _mm256_blendv_ps(_mm256_load_ps(next_ptr),
+                    next_vec, mask));
+            }
+        }
+    }
+}
+
+static bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+template <typename T>
+void relax_tile(T *c, int *c_next, const T *a, const int *a_next, const T *b,
+        unsigned long stride, unsigned tile) {
+#ifdef APSP_X86
+    if (has_avx2()) {
+        relax_tile_avx2(c, c_next, a, a_next, b, stride, tile);
+        return;
+    }
+#endif
+    relax_tile_scalar(c, c_next, a, a_next, b, stride, tile);
+}
+
+template <typename T>
+void blocked_floyd_warshall(DistanceMatrix<T> &matrix, ThreadPool &pool) {
+    unsigned tile = matrix.get_tile();
+    unsigned long tiles = matrix.num_tiles(), stride = matrix.get_stride();
+
+    auto relax = [&](unsigned long ci, unsigned long cj, unsigned long ai,
+            unsigned long aj, unsigned long bi, unsigned long bj) {
+        relax_tile(matrix.get_row(ci * tile) + cj * tile,
+            matrix.get_next_row(ci * tile) + cj * tile,
+            matrix.get_row(ai * tile) + aj * tile,
+            matrix.get_next_row(ai * tile) + aj * tile,
+            matrix.get_row(bi * tile) + bj * tile, stride, tile);
+    };
+
+    for (unsigned long k = 0; k < tiles; k++) {
+        // Phase 1: paths within the diagonal tile.
+        relax(k, k, k, k, k, k);
+
+        // Phase 2: tiles in row k and column k depend only on the diagonal tile.
+        pool.parallel_for(2 * tiles, [&](unsigned long idx) {
+            unsigned long other = idx / 2;
+            if (other == k) {
+                return;
+            } else if (idx % 2 == 0) {
+                relax(k, other, k, k, k, other);
+            } else {
+                relax(other, k, other, k, k, k);
+            }
+        });
+
+        // Phase 3: every other tile depends only on its row and column tiles.
+        pool.parallel_for(tiles, [&](unsigned long i) {
+            if (i == k) {
+                return;
+            }
+            for (unsigned long j = 0; j < tiles; j++) {
+                if (j != k) {
+                    relax(i, j, i, k, k, j);
+                }
+            }
+        });
+    }
+}
+
+template <typename T>
+void untangle_next(DistanceMatrix<T> &matrix, const CSR &csr, const CSR &reverse_csr,
+        ThreadPool &pool) {
+    enum State : char { UNSEEN, WALKING, REACHES, LOOPS };
+    unsigned long n = matrix.size();
+
+    pool.parallel_for(n, [&](unsigned long k) {
+        vector<char> state(n, UNSEEN);
+        vector<int> chain, loops;
+        state[k] = REACHES;
+
+        // Follows next airports from every airport, marking each chain by
+        // whether it reaches the destination or runs into a loop.
+        for (unsigned long i = 0; i < n; i++) {
+            if (state[i] != UNSEEN || matrix.get_next(i, k) < 0) {
+                continue;
+            }
+            chain.clear();
+            int current = i;
+            while (state[current] == UNSEEN) {
+                state[current] = WALKING;
+                chain.push_back(current);
+                current = matrix.get_next(current, k);
+            }
+            char result = state[current] == REACHES ? REACHES : LOOPS;
+            for (int id : chain) {
+                state[id] = result;
+                if (result == LOOPS) {
+                    loops.push_back(id);
+                }
+            }
+        }
+        if (loops.empty()) {
+            return;
+        }
+
+        // Grows the airports that reach the destination backwards along
+        // routes of shortest paths into the looping ones.
+        auto tight = [&](int from_id, int to_id, double weight) {
+            return matrix.get(to_id, k) + (T)weight == matrix.get(from_id, k);
+        };
+        vector<int> queue;
+        for (int id : loops) {
+            for (unsigned e = csr.get_begin(id); e < csr.get_end(id); e++) {
+                int dest_id = csr.get_dest(e);
+                if (state[dest_id] == REACHES && tight(id, dest_id, csr.get_weight(e))) {
+                    matrix.set(id, k, matrix.get(id, k), dest_id);
+                    state[id] = REACHES;
+                    queue.push_back(id);
+                    break;
+                }
+            }
+        }
+        for (unsigned long head = 0; head < queue.size(); head++) {
+            int current = queue[head];
+            for (unsigned e = reverse_csr.get_begin(current); e < reverse_csr.get_end(current);
+                    e++) {
+                int prev_id = reverse_csr.get_dest(e);
+                if (state[prev_id] == LOOPS && tight(prev_id, current, reverse_csr.get_weight(e))) {
+                    matrix.set(prev_id, k, matrix.get(prev_id, k), current);
+                    state[prev_id] = REACHES;
+                    queue.push_back(prev_id);
+                }
+            }
+        }
+    });
+}
+
+template class DistanceMatrix<float>;
+template class DistanceMatrix<double>;
+template void blocked_floyd_warshall(DistanceMatrix<float> &matrix, ThreadPool &pool);
+template void blocked_floyd_warshall(DistanceMatrix<double> &matrix, ThreadPool &pool);
+template void untangle_next(DistanceMatrix<float> &matrix, const CSR &csr,
+    const CSR &reverse_csr, ThreadPool &pool);
+template void untangle_next(DistanceMatrix<double> &matrix, const CSR &csr,
+    const CSR &reverse_csr, ThreadPool &pool);
+template void relax_tile(float *c, int *c_next, const float *a, const int *a_next,
+    const float *b, unsigned long stride, unsigned tile);
+template void relax_tile(double *c, int *c_next, const double *a, const int *a_next,
+    const double *b, unsigned long stride, unsigned tile);
@@ -0,0 +1,158 @@
+/**
+ * @file apsp.h
+ * Definition of blocked all-pairs shortest-path classes.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "csr.h"
+#include "threadpool.h"
+
+using namespace std;
+
+/**
+ * Dense, flat distance matrix with a next-hop matrix for path recovery.
+ *
+ * Rows are padded to a whole number of tiles and aligned to 64 bytes so
+ * tiles can be processed with aligned vector loads. Unreachable pairs
+ * hold +infinity, which needs no special casing in min-plus arithmetic.
+ * @author Vaibhav Gupta
+ */
+template <typename T>
+class DistanceMatrix {
+    public:
+        /**
+         * Constructor to create a matrix with every pair unreachable
+         * except each airport to itself.
+         * @param size Number of airports.
+         * @param tile Side length of a tile, rounded up to a multiple of 16.
+         */
+        DistanceMatrix(unsigned long size, unsigned tile = 64);
+
+        // Destructor to free matrix storage.
+        ~DistanceMatrix();
+
+        DistanceMatrix(const DistanceMatrix &other) = delete;
+        DistanceMatrix &operator=(const DistanceMatrix &other) = delete;
+
+        /**
+         * Initializes the matrix with the routes of a CSR snapshot,
+         * keeping the cheapest route between each pair of airports.
+         * @param csr Reference to CSR snapshot.
+         */
+        void load(const CSR &csr);
+
+        /**
+         * Returns cost of the shortest path between two airports.
+         * @param src_id ID of source airport.
+         * @param dest_id ID of destination airport.
+         * @returns Cost of shortest path, +infinity if unreachable.
+         */
+        T get(unsigned long src_id, unsigned long dest_id) const;
+
+        /**
+         * Returns next airport on the shortest path between two airports.
+         * @param src_id ID of source airport.
+         * @param dest_id ID of destination airport.
+         * @returns ID of next airport, -1 if unreachable.
+         */
+        int get_next(unsigned long src_id, unsigned long dest_id) const;
+
+        /**
+         * Sets cost and next airport of the path between two airports.
+         * @param src_id ID of source airport.
+         * @param dest_id ID of destination airport.
+         * @param cost Cost of path.
+         * @param next ID of next airport on path.
+         */
+        void set(unsigned long src_id, unsigned long dest_id, T cost, int next);
+
+        /**
+         * Returns number of airports.
+         * @returns Number of airports.
+         */
+        unsigned long size() const;
+
+        /**
+         * Returns side length of a tile.
+         * @returns Side length of a tile.
+         */
+        unsigned get_tile() const;
+
+        /**
+         * Returns number of tiles along each side of the matrix.
+         * @returns Number of tiles per row.
+         */
+        unsigned long num_tiles() const;
+
+        /**
+         * Returns pointer to the first cost of a row.
+         * @param row Row index.
+         * @returns Pointer to row of costs, padded to the tile size.
+         */
+        T *get_row(unsigned long row);
+
+        /**
+         * Returns pointer to the first next airport of a row.
+         * @param row Row index.
+         * @returns Pointer to row of next airports, padded to the tile size.
+         */
+        int *get_next_row(unsigned long row);
+
+        /**
+         * Returns number of elements between the starts of two rows.
+         * @returns Row stride.
+         */
+        unsigned long get_stride() const;
+
+    private:
+        unsigned long n, stride;
+        unsigned tile;
+        T *dist;
+        int *next;
+};
+
+/**
+ * Computes all-pairs shortest paths in place with the three-phase blocked
+ * Floyd-Warshall algorithm. For each diagonal tile k, the diagonal tile is
+ * closed first, then the tiles in row and column k, then all remaining
+ * tiles, with the independent tiles of each phase run in parallel. Tiles
+ * are relaxed with AVX2 min-plus kernels when the processor supports them.
+ * @param matrix Reference to distance matrix initialized with route costs.
+ * @param pool Reference to thread pool to run tiles on.
+ */
+template <typename T>
+void blocked_floyd_warshall(DistanceMatrix<T> &matrix, ThreadPool &pool);
+
+/**
+ * Redirects next airports that lead around a cycle of zero-cost routes
+ * forever. Ties between equal-cost paths can leave such loops behind, as
+ * every airport of the cycle has the same cost to the destination. Each
+ * airport on or into a loop is given a route of its shortest path to an
+ * airport whose next airports do reach the destination.
+ * @param matrix Reference to distance matrix closed by Floyd-Warshall.
+ * @param csr Reference to CSR snapshot the matrix was loaded from.
+ * @param reverse_csr Reference to reverse CSR snapshot of the same graph.
+ * @param pool Reference to thread pool to run destinations on.
+ */
+template <typename T>
+void untangle_next(DistanceMatrix<T> &matrix, const CSR &csr, const CSR &reverse_csr,
+    ThreadPool &pool);
+
+/**
+ * Relaxes tile C with paths through the airports of tile A's columns and
+ * tile B's rows, setting C[i][j] = min(C[i][j], A[i][k] + B[k][j]) and
+ * taking the next airport of A[i][k] on improvement.
+ * @param c Pointer to first cost of tile C.
+ * @param c_next Pointer to first next airport of tile C.
+ * @param a Pointer to first cost of tile A.
+ * @param a_next Pointer to first next airport of tile A.
+ * @param b Pointer to first cost of tile B.
+ * @param stride Row stride shared by all tiles.
+ * @param tile Side length of tiles.
+ */
+template <typename T>
+void relax_tile(T *c, int *c_next, const T *a, const int *a_next, const T *b,
+    unsigned long stride, unsigned tile);
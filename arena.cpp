@@ -0,0 +1,46 @@
+/**
+ * @file arena.cpp
+ * Implementation of string arena class.
+ */
+
+#include <cstring>
+
+#include "arena.h"
+
+StringArena::StringArena(unsigned long block_size) {
+    this -> block_size = block_size;
+    used = 0;
+    current = NULL;
+    reserved = 0;
+}
+
+string_view StringArena::store(string_view text) {
+    if (text.size() > block_size) {
+        blocks.emplace_back(new char[text.size()]);
+        reserved += text.size();
+        std::memcpy(blocks.back().get(), text.data(), text.size());
+        return string_view(blocks.back().get(), text.size());
+    }
+
+    if (current == NULL || used + text.size() > block_size) {
+        blocks.emplace_back(new char[block_size]);
+        reserved += block_size;
+        current = blocks.back().get();
+        used = 0;
+    }
+    char *copy = current + used;
+    std::memcpy(copy, text.data(), text.size());
+    used += text.size();
+    return string_view(copy, text.size());
+}
+
+void StringArena::clear() {
+    blocks.clear();
+    used = 0;
+    current = NULL;
+    reserved = 0;
+}
+
+unsigned long StringArena::bytes() const {
+    return reserved;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file arena.h
+ * Definition of arena allocator classes.
+ */
+
+#pragma once
+
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Pool of objects of one type allocated from large blocks.
+ *
+ * Objects are constructed in place one after another, so creating one
+ * does not call the allocator and objects created together sit next to
+ * each other in memory. Objects cannot be freed individually, and all of
+ * them are destroyed and their blocks freed together with the arena.
+ * @author Vaibhav Gupta
+ */
+template <typename T>
+class Arena {
+    public:
+        /**
+         * Constructor to create an empty arena.
+         * @param block_size Number of objects in each block.
+         */
+        Arena(unsigned long block_size = 1024);
+
+        // Destructor to destroy every object and free the blocks.
+        ~Arena();
+
+        Arena(const Arena &other) = delete;
+        Arena &operator=(const Arena &other) = delete;
+
+        /**
+         * Constructs an object in the arena, which owns it from then on.
+         * @param args Arguments passed to the constructor of the object.
+         * @returns Pointer to object, valid for the lifetime of the arena.
+         */
+        template <typename... Args>
+        T *create(Args&&... args);
+
+        /**
+         * Returns number of objects created in the arena.
+         * @returns Number of objects.
+         */
+        unsigned long size() const;
+
+        /**
+         * Returns the memory reserved by the blocks of the arena.
+         * @returns Number of bytes.
+         */
+        unsigned long bytes() const;
+
+    private:
+        typedef typename aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+        vector<unique_ptr<Slot[]>> blocks;
+        unsigned long block_size;
+        unsigned long count;
+};
+
+/**
+ * Pool of immutable strings copied into large blocks, returned as views
+ * that stay valid for the lifetime of the pool.
+ * @author Vaibhav Gupta
+ */
+class StringArena {
+    public:
+        /**
+         * Constructor to create an empty pool.
+         * @param block_size Number of characters in each block, strings
+         * longer than it are given a block of their own.
+         */
+        StringArena(unsigned long block_size = 1 << 16);
+
+        StringArena(const StringArena &other) = delete;
+        StringArena &operator=(const StringArena &other) = delete;
+
+        /**
+         * Copies a string into the pool.
+         * @param text String to copy.
+         * @returns View of the copy.
+         */
+        string_view store(string_view text);
+
+        /**
+         * Frees every string, invalidating all views returned so far.
+         */
+        void clear();
+
+        /**
+         * Returns the memory reserved by the blocks of the pool.
+         * @returns Number of bytes.
+         */
+        unsigned long bytes() const;
+
+    private:
+        vector<unique_ptr<char[]>> blocks;
+        unsigned long block_size;
+
+        // Characters used of the last block that is not dedicated to one string.
+        unsigned long used;
+        char *current;
+        unsigned long reserved;
+};
+
+template <typename T>
+Arena<T>::Arena(unsigned long block_size) {
+    this -> block_size = block_size;
+    count = 0;
+}
+
+template <typename T>
+Arena<T>::~Arena() {
+    if (!is_trivially_destructible<T>::value) {
+        for (unsigned long i = 0; i < count; i++) {
+            reinterpret_cast<T*>(&blocks[i / block_size][i % block_size]) -> ~T();
+        }
+    }
+}
+
+template <typename T>
+template <typename... Args>
+T *Arena<T>::create(Args&&... args) {
+    if (count == blocks.size() * block_size) {
+        blocks.emplace_back(new Slot[block_size]);
+    }
+    Slot *slot = &blocks[count / block_size][count % block_size];
+    T *object = new (slot) T(std::forward<Args>(args)...);
+    count++;
+    return object;
+}
+
+template <typename T>
+unsigned long Arena<T>::size() const {
+    return count;
+}
+
+template <typename T>
+unsigned long Arena<T>::bytes() const {
+    return blocks.size() * block_size * sizeof(Slot);
+}
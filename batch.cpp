@@ -0,0 +1,152 @@
+/**
+ * @file batch.cpp
+ * Implementation of batch router class.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "batch.h"
+
+BatchRouter::BatchRouter(const Graph &graph, unsigned num_threads)
+    : graph(graph), pool(num_threads) {
+    contexts.resize(pool.size());
+}
+
+bool BatchRouter::read_queries(const string &file_path, vector<vector<int>> &queries) const {
+    ifstream file(file_path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    vector<vector<CSVError>> errors(1);
+    string line;
+    unsigned long line_num = 0;
+    while (std::getline(file, line)) {
+        line_num++;
+        unsigned long start = line.find_first_not_of(" \t\r");
+        if (start == string::npos || line[start] == '#') {
+            continue;
+        }
+
+        std::replace(line.begin(), line.end(), ',', ' ');
+        stringstream tokens(line);
+        vector<int> query;
+        string token, error;
+        while (error.empty() && tokens >> token) {
+            int id;
+            if (!CSVReader::parse_int(token, id)) {
+                error = "invalid airport ID '" + token + "'";
+            } else if (!is_airport(graph, id)) {
+                error = "unknown airport ID " + token;
+            }
+            query.push_back(id);
+        }
+        if (error.empty() && query.size() < 2) {
+            error = "expected at least two airport IDs";
+        }
+
+        if (error.empty()) {
+            queries.push_back(query);
+        } else {
+            errors[0].push_back({line_num, error});
+        }
+    }
+    Graph::report_errors(file_path, errors);
+    return true;
+}
+
+vector<PathResult> BatchRouter::route(const vector<vector<int>> &queries) {
+    // Built before searching, since threads may not rebuild it concurrently.
+    const CSR &csr = graph.get_csr();
+
+    vector<pair<int, int>> legs;
+    for (const vector<int> &query : queries) {
+        for (unsigned long i = 0; i + 1 < query.size(); i++) {
+            legs.emplace_back(query[i], query[i + 1]);
+        }
+    }
+    std::sort(legs.begin(), legs.end());
+    legs.erase(std::unique(legs.begin(), legs.end()), legs.end());
+
+    sources.clear();
+    leg_begin.clear();
+    leg_dests.clear();
+    for (unsigned long i = 0; i < legs.size(); i++) {
+        if (sources.empty() || legs[i].first != sources.back()) {
+            sources.push_back(legs[i].first);
+            leg_begin.push_back(i);
+        }
+        leg_dests.push_back(legs[i].second);
+    }
+    leg_begin.push_back(legs.size());
+    leg_routes.assign(legs.size(), vector<unsigned>());
+    leg_found.assign(legs.size(), false);
+
+    pool.parallel_for(sources.size(), [this](unsigned long source, unsigned thread) {
+        route_source(source, contexts[thread]);
+    });
+
+    // Legs are joined in query order, stopping at the first unreachable one.
+    vector<PathResult> results(queries.size());
+    for (unsigned long i = 0; i < queries.size(); i++) {
+        const vector<int> &query = queries[i];
+        PathResult &result = results[i];
+        unsigned long num_legs = 0;
+        for (; num_legs + 1 < query.size(); num_legs++) {
+            unsigned long leg = std::lower_bound(legs.begin(), legs.end(),
+                make_pair(query[num_legs], query[num_legs + 1])) - legs.begin();
+            if (!leg_found[leg]) {
+                break;
+            }
+            for (unsigned route : leg_routes[leg]) {
+                result.routes.push_back(csr.get_route(route));
+            }
+        }
+
+        result.complete = num_legs + 1 >= query.size();
+        for (Route *route : result.routes) {
+            result.cost += route -> get_weight();
+        }
+    }
+    return results;
+}
+
+unsigned long BatchRouter::num_legs() const {
+    return leg_dests.size();
+}
+
+unsigned long BatchRouter::num_sources() const {
+    return sources.size();
+}
+
+unsigned BatchRouter::num_threads() const {
+    return pool.size();
+}
+
+void BatchRouter::route_source(unsigned long source, SearchContext &context) {
+    const CSR &csr = graph.get_csr();
+    int src_id = sources[source];
+
+    // Origins reaching none of their destinations need no tree at all.
+    bool any_reachable = false;
+    for (unsigned long leg = leg_begin[source]; leg < leg_begin[source + 1]; leg++) {
+        any_reachable = any_reachable || graph.is_reachable(src_id, leg_dests[leg], context);
+    }
+    if (!any_reachable) {
+        return;
+    }
+
+    shared_ptr<const ShortestPathTree> tree = graph.shortest_path_tree(src_id, context);
+    for (unsigned long leg = leg_begin[source]; leg < leg_begin[source + 1]; leg++) {
+        int dest_id = leg_dests[leg];
+        if (tree -> costs[dest_id] != INF_COST) {
+            context.clear_path();
+            context.append_path(csr, tree -> predecessor, src_id, dest_id);
+            leg_routes[leg].assign(context.get_path().begin(), context.get_path().end());
+            leg_found[leg] = true;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file batch.h
+ * Definition of batch router class.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "queries.h"
+#include "threadpool.h"
+
+using namespace std;
+
+/**
+ * Answers many shortest-path queries against a graph at once.
+ *
+ * Every query is split into legs between consecutive airports, and legs
+ * are grouped by their starting airport so that a single shortest-path
+ * tree answers every destination sharing that origin. Origins are
+ * searched in parallel on a thread pool, with each thread reusing its
+ * own search context since the graph is only read. Trees are those of
+ * Graph::shortest_path_tree(), so the heap type, search type, path cache
+ * and metrics of the graph all apply.
+ * @author Vaibhav Gupta
+ */
+class BatchRouter {
+    public:
+        /**
+         * Constructor to create a router for a graph.
+         * @param graph Reference to initialized graph, which must outlive
+         * the router.
+         * @param num_threads Number of threads to use, 0 for one per core.
+         */
+        BatchRouter(const Graph &graph, unsigned num_threads = 0);
+
+        /**
+         * Reads a query file with one query per line, each being two or
+         * more airport IDs separated by commas or spaces. Blank lines and
+         * lines starting with '#' are ignored, while malformed lines are
+         * reported with their line numbers and skipped.
+         * @param file_path File path to read.
+         * @param queries Reference to vector to append the airport IDs of
+         * each query to.
+         * @returns Boolean representing if the file was opened or not.
+         */
+        bool read_queries(const string &file_path, vector<vector<int>> &queries) const;
+
+        /**
+         * Finds the shortest path of every query, visiting its airports
+         * in sequential order as find_path() does.
+         * @param queries Reference to vector of airport IDs of each query.
+         * @returns Result of each query, in the same order as the queries.
+         */
+        vector<PathResult> route(const vector<vector<int>> &queries);
+
+        /**
+         * Returns number of distinct legs searched by the last batch.
+         * @returns Number of legs.
+         */
+        unsigned long num_legs() const;
+
+        /**
+         * Returns number of distinct origins searched by the last batch.
+         * @returns Number of shortest-path trees generated.
+         */
+        unsigned long num_sources() const;
+
+        /**
+         * Returns number of threads used to search origins.
+         * @returns Number of threads.
+         */
+        unsigned num_threads() const;
+
+    private:
+        /**
+         * Helper function to generate the shortest-path tree of one origin
+         * with Graph::shortest_path_tree(), and store the route of each leg.
+         * Origins that reach none of their destinations are not searched.
+         * @param source Index of origin in sources.
+         * @param context Reference to search context of the calling thread.
+         */
+        void route_source(unsigned long source, SearchContext &context);
+
+        const Graph &graph;
+        ThreadPool pool;
+
+        // Search state owned by each thread and reused between origins.
+        vector<SearchContext> contexts;
+
+        // Distinct origins, with the legs of sources[i] in
+        // [leg_begin[i], leg_begin[i + 1]).
+        vector<int> sources;
+        vector<unsigned long> leg_begin;
+
+        // Destination, route indices and whether a path exists for each leg.
+        vector<int> leg_dests;
+        vector<vector<unsigned>> leg_routes;
+        vector<char> leg_found;
+};
@@ -0,0 +1,47 @@
+/**
+ * @file alt_bench.cpp
+ * Benchmark of bidirectional Dijkstra and A* search with landmarks (ALT)
+ * against Dijkstra's Algorithm on random point-to-point queries over the
+ * airport dataset.
+ *
+ * Usage: ./alt_bench [num_queries] [num_landmarks]
+ * Landmarks chosen by farthest-point selection are saved next to the
+ * dataset, where Graph::initialize loads them from.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "../graph.h"
+#include "query_bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    unsigned long num_queries = argc > 1 ? std::stoul(argv[1]) : 10000;
+    unsigned num_landmarks = argc > 2 ? std::stoi(argv[2]) : 16;
+
+    Graph graph;
+    graph.initialize();
+    unsigned long num_airports = graph.get_csr().num_airports();
+
+    vector<vector<int>> queries = random_queries(num_airports, num_queries);
+
+    cout << endl << "Running " << num_queries << " random queries" << endl;
+    QueryRun dijkstra = run_queries(graph, SearchType::DIJKSTRA, queries);
+    report_baseline("Dijkstra", dijkstra);
+
+    report("Bidirectional", run_queries(graph, SearchType::BIDIRECTIONAL, queries), dijkstra);
+
+    graph.build_landmarks(num_landmarks, LandmarkSelection::DEGREE);
+    report("ALT (highest degree)", run_queries(graph, SearchType::ALT, queries), dijkstra);
+
+    graph.build_landmarks(num_landmarks, LandmarkSelection::FARTHEST);
+    report("ALT (farthest point)", run_queries(graph, SearchType::ALT, queries), dijkstra);
+
+    const string landmarks_path = "data/graph.landmarks";
+    if (graph.save_landmarks(landmarks_path, 
+            DatasetFingerprint::of("data/airports.csv", "data/routes.csv"))) {
+        cout << endl << "Saved landmarks to " << landmarks_path << endl;
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * @file apsp_bench.cpp
+ * Benchmark of the blocked Floyd-Warshall kernel against the original
+ * nested-vector loop.
+ *
+ * Usage: ./apsp_bench [num_airports] [num_threads]
+ * Without arguments the airport dataset is used, otherwise a random
+ * network with 8 routes per airport is generated.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "../graph.h"
+
+using namespace std;
+
+// Original Floyd-Warshall relaxation with INT_MAX sentinels, kept for comparison.
+vector<vector<double>> legacy_floyd_warshall(const CSR &csr) {
+    unsigned long n = csr.num_airports();
+    vector<vector<double>> adj_matrix(n, vector<double>(n, INT_MAX));
+    vector<vector<int>> successor(n, vector<int>(n, -1));
+
+    for (unsigned long i = 0; i < n; i++) {
+        adj_matrix[i][i] = 0;
+        successor[i][i] = i;
+        for (unsigned e = csr.get_begin(i); e < csr.get_end(i); e++) {
+            int dest_id = csr.get_dest(e);
+            if (csr.get_weight(e) < adj_matrix[i][dest_id]) {
+                adj_matrix[i][dest_id] = csr.get_weight(e);
+                successor[i][dest_id] = dest_id;
+            }
+        }
+    }
+
+    for (unsigned long i = 0; i < n; i++) {
+        for (unsigned long j = 0; j < n; j++) {
+            if (i != j && adj_matrix[j][i] < INT_MAX) {
+                for (unsigned long k = 0; k < n; k++) {
+                    if (j != k && k != i && adj_matrix[i][k] < INT_MAX) {
+                        double new_cost = adj_matrix[j][i] + adj_matrix[i][k];
+                        if (new_cost < adj_matrix[j][k]) {
+                            adj_matrix[j][k] = new_cost;
+                            successor[j][k] = i;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return adj_matrix;
+}
+
+template <typename T>
+double time_blocked(const CSR &csr, ThreadPool &pool, unsigned tile,
+        const vector<vector<double>> &expected) {
+    DistanceMatrix<T> matrix(csr.num_airports(), tile);
+    matrix.load(csr);
+
+    auto start = chrono::steady_clock::now();
+    blocked_floyd_warshall(matrix, pool);
+    auto end = chrono::steady_clock::now();
+
+    double max_error = 0;
+    for (unsigned long i = 0; i < csr.num_airports(); i++) {
+        for (unsigned long j = 0; j < csr.num_airports(); j++) {
+            double cost = matrix.get(i, j);
+            if (std::isinf(cost) != (expected[i][j] >= INT_MAX)) {
+                max_error = INFINITY;
+            } else if (!std::isinf(cost)) {
+                max_error = std::max(max_error, std::fabs(cost - expected[i][j]) /
+                    std::max(1.0, expected[i][j]));
+            }
+        }
+    }
+
+    double ms = chrono::duration<double, milli>(end - start).count();
+    cout << (sizeof(T) == 4 ? "float32" : "float64") << " tile " << matrix.get_tile()
+        << ": " << ms << "ms (max relative error " << max_error << ")" << endl;
+    return ms;
+}
+
+int main(int argc, char **argv) {
+    Graph graph;
+    if (argc > 1) {
+        int num_airports = std::stoi(argv[1]);
+        mt19937 rng(42);
+        uniform_int_distribution<int> pick(0, num_airports - 1);
+        uniform_real_distribution<double> cost(0.1, 5.0);
+
+        for (int i = 0; i < num_airports; i++) {
+            graph.create_airport("Airport " + to_string(i), "City");
+        }
+        for (int i = 0; i < num_airports; i++) {
+            for (int r = 0; r < 8; r++) {
+                graph.create_route(i, pick(rng), "Airline", cost(rng));
+            }
+        }
+        cout << "Generated " << num_airports << " airports" << endl;
+    } else {
+        graph.initialize();
+    }
+
+    unsigned num_threads = argc > 2 ? std::stoi(argv[2]) : 0;
+    ThreadPool pool(num_threads);
+    const CSR &csr = graph.get_csr();
+    cout << "Using " << pool.size() << " thread(s)" << endl << endl;
+
+    auto start = chrono::steady_clock::now();
+    vector<vector<double>> expected = legacy_floyd_warshall(csr);
+    auto end = chrono::steady_clock::now();
+    double legacy_ms = chrono::duration<double, milli>(end - start).count();
+    cout << "legacy loop: " << legacy_ms << "ms" << endl;
+
+    for (unsigned tile : {32u, 64u, 128u}) {
+        double ms = time_blocked<double>(csr, pool, tile, expected);
+        cout << "  speedup " << legacy_ms / ms << "x" << endl;
+        ms = time_blocked<float>(csr, pool, tile, expected);
+        cout << "  speedup " << legacy_ms / ms << "x" << endl;
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ * @file benchmark.cpp
+ * Benchmark suite covering loading, Dijkstra's, Prim's and Brandes'
+ * algorithms and approximate centrality on the airport dataset or a
+ * generated network.
+ *
+ * Usage: ./benchmark [directory] [repetitions] [warmup]
+ * Reads airports.csv and routes.csv from the directory, data by default.
+ * Every case is run warmup times without being measured and then
+ * repetitions times, and the percentiles of the measured times are
+ * reported. Dijkstra's Algorithm is measured per random query and is run
+ * QUERIES_PER_REPETITION times as often. Approximate centrality is measured
+ * on every network, with the default error of main.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "../graph.h"
+
+using namespace std;
+
+// Random queries measured per repetition of the other cases.
+const unsigned QUERIES_PER_REPETITION = 100;
+
+// Largest network whose centrality is measured, since Brandes' Algorithm
+// searches from every airport.
+const unsigned long CENTRALITY_LIMIT = 10000;
+
+/**
+ * Runs a case warmup times and then measures it repetitions times.
+ * @param name Name of case printed in the report.
+ * @param warmup Number of runs before measuring.
+ * @param repetitions Number of measured runs.
+ * @param run Function running the case once, given the run number.
+ */
+template <typename Run>
+void measure(const string &name, unsigned long warmup, unsigned long repetitions, Run run) {
+    for (unsigned long i = 0; i < warmup; i++) {
+        run(i);
+    }
+
+    vector<double> samples;
+    for (unsigned long i = 0; i < repetitions; i++) {
+        auto start = chrono::steady_clock::now();
+        run(warmup + i);
+        auto end = chrono::steady_clock::now();
+        samples.push_back(chrono::duration<double, milli>(end - start).count());
+    }
+    if (samples.empty()) {
+        return;
+    }
+
+    // Nearest-rank percentiles of the sorted samples.
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+        unsigned long rank = (unsigned long)std::ceil(p / 100 * samples.size());
+        return samples[std::max(1ul, rank) - 1];
+    };
+    double total = 0;
+    for (double sample : samples) {
+        total += sample;
+    }
+
+    cout << left << setw(22) << name << right << setw(8) << samples.size();
+    for (double value : {samples.front(), percentile(50), percentile(90), percentile(99),
+            samples.back(), total / samples.size()}) {
+        cout << setw(12) << value;
+    }
+    cout << endl;
+}
+
+/**
+ * Reads the network of a directory into a graph and builds its CSR.
+ */
+void load(Graph &graph, const string &directory) {
+    graph.set_log(NULL);
+    graph.read_airports(directory + "/airports.csv");
+    graph.read_routes(directory + "/routes.csv");
+    graph.get_csr();
+}
+
+int main(int argc, char **argv) {
+    string directory = argc > 1 ? argv[1] : "data";
+    unsigned long repetitions = argc > 2 ? std::stoul(argv[2]) : 10;
+    unsigned long warmup = argc > 3 ? std::stoul(argv[3]) : 1;
+
+    Graph graph;
+    load(graph, directory);
+    const CSR &csr = graph.get_csr();
+    unsigned long num_airports = csr.num_airports();
+    if (num_airports == 0) {
+        cout << "No airports read from " << directory << endl;
+        return 1;
+    }
+    cout << "Network: " << num_airports << " airports, " << csr.num_routes()
+        << " routes from " << directory << endl;
+    cout << "Times in ms over " << repetitions << " repetition(s) after " << warmup
+        << " warmup run(s)" << endl << endl;
+    cout << left << setw(22) << "case" << right << setw(8) << "runs" << setw(12) << "min"
+        << setw(12) << "p50" << setw(12) << "p90" << setw(12) << "p99" << setw(12) << "max"
+        << setw(12) << "mean" << endl << fixed << setprecision(3);
+
+    measure("load", warmup, repetitions, [&](unsigned long) {
+        Graph loaded;
+        load(loaded, directory);
+    });
+
+    // Prim's Algorithm starts at the airport with the most routes, which
+    // is in the largest component of a generated network.
+    int hub = 0;
+    for (unsigned long id = 0; id < num_airports; id++) {
+        if (csr.get_end(id) - csr.get_begin(id) > csr.get_end(hub) - csr.get_begin(hub)) {
+            hub = id;
+        }
+    }
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick(0, num_airports - 1);
+    vector<vector<int>> queries;
+    for (unsigned long i = 0; i < (warmup + repetitions) * QUERIES_PER_REPETITION; i++) {
+        queries.push_back({pick(rng), pick(rng)});
+    }
+
+    const pair<string, HeapType> heaps[] = {{"binary", HeapType::BINARY},
+        {"quaternary", HeapType::QUATERNARY}, {"pairing", HeapType::PAIRING},
+        {"lazy", HeapType::LAZY}};
+    for (const auto &heap : heaps) {
+        graph.set_heap_type(heap.second);
+        SearchContext context;
+        measure("dijkstra " + heap.first, warmup * QUERIES_PER_REPETITION,
+            repetitions * QUERIES_PER_REPETITION, [&](unsigned long i) {
+                graph.shortest_path(queries[i], context);
+            });
+        measure("prim " + heap.first, warmup, repetitions, [&](unsigned long) {
+            Graph mst;
+            mst.set_log(NULL);
+            graph.prim_mst(mst, hub);
+        });
+    }
+    graph.set_heap_type(HeapType::QUATERNARY);
+
+    if (num_airports <= CENTRALITY_LIMIT) {
+        measure("centrality brandes", warmup, repetitions, [&](unsigned long) {
+            graph.brandes();
+        });
+    } else {
+        cout << "centrality brandes: skipped above " << CENTRALITY_LIMIT << " airports" << endl;
+    }
+    measure("centrality approx", warmup, repetitions, [&](unsigned long) {
+        graph.approximate_centrality(0.05, 0.1);
+    });
+}
@@ -0,0 +1,42 @@
+/**
+ * @file ch_bench.cpp
+ * Benchmark of contraction hierarchy (CH) queries against Dijkstra's
+ * Algorithm on random point-to-point queries over the airport dataset.
+ *
+ * Usage: ./ch_bench [num_queries]
+ * Reports the preprocessing time and size of the hierarchy, the speedup of
+ * queries, and any paths whose cost or routes differ from Dijkstra's.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "../graph.h"
+#include "query_bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    unsigned long num_queries = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+    Graph graph;
+    graph.initialize();
+    unsigned long num_airports = graph.get_csr().num_airports();
+
+    vector<vector<int>> queries = random_queries(num_airports, num_queries);
+
+    cout << endl;
+    graph.build_hierarchy();
+    const ContractionHierarchy &hierarchy = graph.get_hierarchy();
+    cout << "Index: " << hierarchy.num_shortcuts() << " shortcuts, " 
+        << hierarchy.bytes() / 1024.0 << " KB" << endl;
+
+    cout << endl << "Running " << num_queries << " random queries" << endl;
+    QueryRun dijkstra = run_queries(graph, SearchType::DIJKSTRA, queries);
+    QueryRun ch = run_queries(graph, SearchType::CH, queries);
+
+    report_baseline("Dijkstra", dijkstra);
+    report("CH", ch, dijkstra);
+    cout << "CH routes: " << count_different_routes(ch, dijkstra)
+        << " equal-cost path(s) with other routes" << endl;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file delta_bench.cpp
+ * Benchmark of delta-stepping shortest-path trees against Dijkstra's
+ * Algorithm on the airport dataset or a generated network.
+ *
+ * Usage: ./delta_bench [directory] [num_sources]
+ * Reads airports.csv and routes.csv from the directory, data by default.
+ * Reports the tuned bucket width, the time per complete tree and per
+ * random query with each search, any costs that differ from Dijkstra's,
+ * any incoming routes that do not lead back to the source at the cost of
+ * the airport, and how many airports and query paths of equal cost take
+ * other routes than Dijkstra's, which keeps whichever tied route it
+ * settles first.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "../graph.h"
+#include "query_bench.h"
+
+using namespace std;
+
+/**
+ * Returns if two costs are equal up to rounding.
+ */
+bool same_cost(double expected, double cost) {
+    return std::isinf(expected) == std::isinf(cost) && (std::isinf(cost) ||
+        std::fabs(cost - expected) <= 1e-9 * std::max(1.0, expected));
+}
+
+/**
+ * Counts airports whose incoming routes do not add up to their cost.
+ */
+unsigned long count_broken_paths(const CSR &csr, const ShortestPathTree &tree) {
+    unsigned long broken = 0;
+    for (unsigned long id = 0; id < tree.costs.size(); id++) {
+        if (tree.costs[id] == INF_COST) {
+            continue;
+        }
+        double cost = 0;
+        unsigned long num_routes = 0;
+        int current = id;
+        while (current != tree.src_id && num_routes <= csr.num_airports()) {
+            unsigned route = tree.predecessor[current];
+            if (route == NO_ROUTE) {
+                break;
+            }
+            cost += csr.get_weight(route);
+            current = csr.get_src(route);
+            num_routes++;
+        }
+        if (current != tree.src_id || !same_cost(tree.costs[id], cost)) {
+            broken++;
+        }
+    }
+    return broken;
+}
+
+/**
+ * Counts airports of equal cost to the expected tree reached over another
+ * incoming route.
+ */
+unsigned long count_different_routes(const ShortestPathTree &tree,
+        const ShortestPathTree &expected) {
+    unsigned long different_routes = 0;
+    for (unsigned long id = 0; id < tree.costs.size(); id++) {
+        different_routes += same_cost(expected.costs[id], tree.costs[id]) &&
+            tree.predecessor[id] != expected.predecessor[id];
+    }
+    return different_routes;
+}
+
+int main(int argc, char **argv) {
+    string directory = argc > 1 ? argv[1] : "data";
+    Graph graph;
+    graph.set_log(NULL);
+    graph.read_airports(directory + "/airports.csv");
+    graph.read_routes(directory + "/routes.csv");
+    const CSR &csr = graph.get_csr();
+    unsigned long num_airports = csr.num_airports();
+    unsigned long num_sources = argc > 2 ? std::stoul(argv[2]) : 10;
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick(0, num_airports - 1);
+    vector<int> src_ids;
+    vector<vector<int>> queries;
+    for (unsigned long i = 0; i < num_sources; i++) {
+        src_ids.push_back(pick(rng));
+        queries.push_back({pick(rng), pick(rng)});
+    }
+
+    cout << endl << "Network: " << num_airports << " airports, " << csr.num_routes()
+        << " routes" << endl;
+    cout << "Bucket width: " << DeltaStepping::tune_width(csr) << " on "
+        << std::max(1u, thread::hardware_concurrency()) << " thread(s)" << endl;
+
+    vector<shared_ptr<const ShortestPathTree>> expected;
+    double ms[2];
+    unsigned long mismatches = 0, broken = 0, different_routes = 0;
+    const SearchType types[2] = {SearchType::DIJKSTRA, SearchType::DELTA_STEPPING};
+    for (int i = 0; i < 2; i++) {
+        graph.set_search_type(types[i]);
+        auto start = chrono::steady_clock::now();
+        for (unsigned long j = 0; j < num_sources; j++) {
+            shared_ptr<const ShortestPathTree> tree = graph.shortest_path_tree(src_ids[j]);
+            if (i == 0) {
+                expected.push_back(tree);
+                continue;
+            }
+            for (unsigned long id = 0; id < num_airports; id++) {
+                mismatches += !same_cost(expected[j] -> costs[id], tree -> costs[id]);
+            }
+            broken += count_broken_paths(csr, *tree);
+            different_routes += count_different_routes(*tree, *expected[j]);
+        }
+        auto end = chrono::steady_clock::now();
+        ms[i] = chrono::duration<double, milli>(end - start).count() / num_sources;
+    }
+    cout << "Trees from " << num_sources << " source(s): Dijkstra " << ms[0]
+        << "ms, delta-stepping " << ms[1] << "ms (" << ms[0] / std::max(1e-9, ms[1])
+        << "x faster), " << mismatches << " cost mismatch(es), " << broken
+        << " broken path(s), " << different_routes << " airport(s) of equal cost with other routes"
+        << endl;
+
+    QueryRun runs[2];
+    for (int i = 0; i < 2; i++) {
+        runs[i] = run_queries(graph, types[i], queries);
+    }
+    cout << "Random queries: Dijkstra " << runs[0].ms / num_sources << "ms, delta-stepping "
+        << runs[1].ms / num_sources << "ms (" << runs[0].ms / std::max(1e-9, runs[1].ms)
+        << "x faster), " << count_mismatches(runs[0].costs, runs[1].costs)
+        << " cost mismatch(es), " << count_different_routes(runs[1], runs[0])
+        << " equal-cost path(s) with other routes" << endl;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file disk_apsp_bench.cpp
+ * Benchmark of the out-of-core all-pairs table against the in-memory
+ * blocked Floyd-Warshall algorithm on the airport dataset or a generated
+ * network.
+ *
+ * Usage: ./disk_apsp_bench [directory] [rounds_per_run]
+ * Reads airports.csv and routes.csv from the directory, data by default.
+ * The table is computed into a temporary file a few rounds at a time,
+ * reopening it between runs as an interrupted computation would, and is
+ * removed afterwards. Reports the time of each computation, any costs or
+ * next airports that differ from the in-memory matrix, and the time per
+ * random lookup.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../graph.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    const string file_path = "disk_apsp_bench.apsp";
+    string directory = argc > 1 ? argv[1] : "data";
+    Graph graph;
+    graph.set_log(NULL);
+    graph.read_airports(directory + "/airports.csv");
+    graph.read_routes(directory + "/routes.csv");
+    const CSR &csr = graph.get_csr();
+    unsigned long n = csr.num_airports();
+    unsigned long rounds_per_run = argc > 2 ? std::stoul(argv[2]) : 4;
+
+    cout << endl << "Network: " << n << " airports, " << csr.num_routes() << " routes" << endl;
+    ThreadPool pool;
+
+    auto start = chrono::steady_clock::now();
+    DistanceMatrix<double> matrix(n);
+    matrix.load(csr);
+    blocked_floyd_warshall(matrix, pool);
+    auto end = chrono::steady_clock::now();
+    double memory_ms = chrono::duration<double, milli>(end - start).count();
+
+    std::remove(file_path.c_str());
+    unsigned long runs = 0, rounds_done = 0;
+    start = chrono::steady_clock::now();
+    for (bool complete = false; !complete; runs++) {
+        DiskAPSP table;
+        complete = table.compute(file_path, csr, DatasetFingerprint(), pool, rounds_per_run);
+        if (!complete && table.get_progress().first <= rounds_done) {
+            cerr << "Could not write " << file_path << endl;
+            return 1;
+        }
+        rounds_done = table.get_progress().first;
+    }
+    end = chrono::steady_clock::now();
+    double disk_ms = chrono::duration<double, milli>(end - start).count();
+
+    DiskAPSP table;
+    if (!table.open(file_path, csr, DatasetFingerprint())) {
+        cerr << "Could not open " << file_path << endl;
+        return 1;
+    }
+    unsigned long mismatches = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        for (unsigned long j = 0; j < n; j++) {
+            mismatches += table.get(i, j) != matrix.get(i, j) ||
+                table.get_next(i, j) != matrix.get_next(i, j);
+        }
+    }
+    cout << "All pairs: in memory " << memory_ms << "ms, on disk " << disk_ms << "ms over "
+        << runs << " run(s) of " << rounds_per_run << " round(s), " << table.bytes() / 1024
+        << " KB, " << mismatches << " mismatch(es)" << endl;
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick(0, n - 1);
+    const unsigned long num_lookups = 1000000;
+    double total = 0;
+    start = chrono::steady_clock::now();
+    for (unsigned long i = 0; i < num_lookups; i++) {
+        double cost = table.get(pick(rng), pick(rng));
+        total += std::isinf(cost) ? 0 : cost;
+    }
+    end = chrono::steady_clock::now();
+    cout << "Random lookups: " << chrono::duration<double, nano>(end - start).count() / num_lookups
+        << "ns each (checksum " << total << ")" << endl;
+
+    table.close();
+    std::remove(file_path.c_str());
+}
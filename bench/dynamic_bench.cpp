@@ -0,0 +1,142 @@
+/**
+ * @file dynamic_bench.cpp
+ * Benchmark of incremental all-pairs shortest-path and centrality updates
+ * against recomputing them from scratch after every change.
+ *
+ * Usage: ./dynamic_bench [num_updates]
+ * Applies random route repricings, removals and insertions, and reports the
+ * sources searched again per update, the time per update, and any costs or
+ * centralities that differ from a from-scratch computation. The maintained
+ * centralities are also checked on a random forest with zero-cost routes,
+ * self-loops and cycles, against Floyd-Warshall's when built and against
+ * Brandes' Algorithm after zero-cost routes are repriced.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "../graph.h"
+#include "zero_cost.h"
+
+using namespace std;
+
+/**
+ * Returns if two values differ by more than the relative tolerance.
+ */
+bool differs(double expected, double value) {
+    if (std::isinf(expected) || std::isinf(value)) {
+        return std::isinf(expected) != std::isinf(value);
+    }
+    return std::fabs(value - expected) > 1e-9 * std::max(1.0, std::fabs(expected));
+}
+
+/**
+ * Counts centralities maintained on a random forest with zero-cost routes
+ * that differ from a from-scratch computation, once when built and once
+ * after repricing some of its routes.
+ */
+unsigned long check_zero_cost_routes(unsigned long num_airports) {
+    Graph graph;
+    graph.set_log(NULL);
+    build_zero_cost_forest(graph, num_airports);
+    graph.enable_dynamic_apsp();
+    const DynamicAPSP &dynamic = graph.get_dynamic_apsp();
+
+    unsigned long mismatches = 0;
+    vector<double> expected = graph.floyd_warshall(), centralities = dynamic.get_centralities();
+    for (unsigned long i = 0; i < num_airports; i++) {
+        mismatches += differs(expected[i], centralities[i]);
+    }
+
+    // Repricing turns some paths into several of equal cost, which only
+    // Brandes' Algorithm counts.
+    mt19937 rng(7);
+    vector<Route*> routes;
+    for (Airport *airport : graph.get_airports()) {
+        routes.insert(routes.end(), airport -> get_routes().begin(), airport -> get_routes().end());
+    }
+    for (unsigned long i = 0; i < routes.size() / 10; i++) {
+        Route *route = routes[rng() % routes.size()];
+        graph.set_route_weight(route, route -> get_weight() == 0 ? 1 : 0);
+    }
+    expected = graph.brandes();
+    centralities = dynamic.get_centralities();
+    for (unsigned long i = 0; i < num_airports; i++) {
+        mismatches += differs(expected[i], centralities[i]);
+    }
+    return mismatches;
+}
+
+int main(int argc, char **argv) {
+    unsigned long num_updates = argc > 1 ? std::stoul(argv[1]) : 300;
+
+    Graph graph;
+    graph.initialize();
+    unsigned long num_airports = graph.get_csr().num_airports();
+
+    cout << endl;
+    graph.enable_dynamic_apsp();
+    const DynamicAPSP &dynamic = graph.get_dynamic_apsp();
+
+    vector<Route*> routes;
+    for (Airport *airport : graph.get_airports()) {
+        routes.insert(routes.end(), airport -> get_routes().begin(), airport -> get_routes().end());
+    }
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick_airport(0, num_airports - 1);
+    uniform_real_distribution<double> scale(0.5, 2.0);
+
+    cout << endl << "Applying " << num_updates << " random updates" << endl;
+    auto start = chrono::steady_clock::now();
+    for (unsigned long i = 0; i < num_updates; i++) {
+        uniform_int_distribution<unsigned long> pick_route(0, routes.size() - 1);
+        unsigned long index = pick_route(rng);
+        Route *route = routes[index];
+        switch (i % 3) {
+            case 0:
+                graph.set_route_weight(route, route -> get_weight() * scale(rng));
+                break;
+            case 1:
+                graph.remove_route(route);
+                routes[index] = routes.back();
+                routes.pop_back();
+                break;
+            default:
+                routes.push_back(graph.create_route(pick_airport(rng), pick_airport(rng),
+                    "XX", route -> get_weight() * scale(rng)));
+                break;
+        }
+    }
+    vector<double> centralities = dynamic.get_centralities();
+    auto end = chrono::steady_clock::now();
+    double dynamic_ms = chrono::duration<double, milli>(end - start).count();
+
+    start = chrono::steady_clock::now();
+    vector<double> expected_centralities = graph.brandes();
+    end = chrono::steady_clock::now();
+    double brandes_ms = chrono::duration<double, milli>(end - start).count();
+
+    DynamicAPSP expected;
+    expected.build(graph.get_csr(), graph.get_reverse_csr());
+    unsigned long cost_mismatches = 0, centrality_mismatches = 0;
+    for (unsigned long s = 0; s < num_airports; s++) {
+        for (unsigned long t = 0; t < num_airports; t++) {
+            cost_mismatches += differs(expected.get(s, t), dynamic.get(s, t));
+        }
+        centrality_mismatches += differs(expected_centralities[s], centralities[s]);
+    }
+
+    cout << "Incremental: " << (double)dynamic.get_num_searches() / num_updates
+        << " of " << num_airports << " sources searched per update, "
+        << dynamic_ms / num_updates << "ms per update" << endl;
+    cout << "From scratch: " << brandes_ms << "ms per update ("
+        << brandes_ms * num_updates / std::max(1e-9, dynamic_ms) << "x slower), "
+        << cost_mismatches << " cost mismatch(es), " << centrality_mismatches
+        << " centrality mismatch(es)" << endl;
+    cout << "Zero-cost routes: " << check_zero_cost_routes(200)
+        << " centrality mismatch(es) against a from-scratch computation" << endl;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file generate.cpp
+ * Writes a synthetic hub-and-spoke airline network in the CSV format of
+ * the airport dataset, for benchmarking at larger scales.
+ *
+ * Usage: ./generate [num_airports] [directory] [connections] [seed]
+ * Writes airports.csv and routes.csv to the directory, data/synthetic by
+ * default, which can then be benchmarked with ./benchmark [directory].
+ */
+
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "generator.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    NetworkOptions options;
+    if (argc > 1) {
+        options.num_airports = std::stoul(argv[1]);
+    }
+    string directory = argc > 2 ? argv[2] : "data/synthetic";
+    if (argc > 3) {
+        options.connections = std::stoul(argv[3]);
+    }
+    if (argc > 4) {
+        options.seed = std::stoul(argv[4]);
+    }
+
+    error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    auto start = chrono::steady_clock::now();
+    unsigned long num_routes = generate_network(options, directory + "/airports.csv",
+        directory + "/routes.csv");
+    auto end = chrono::steady_clock::now();
+    if (num_routes == 0) {
+        cout << "Could not write network to " << directory << endl;
+        return 1;
+    }
+
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    cout << "Generated " << options.num_airports << " airports and " << num_routes
+        << " routes in " << directory << " in " << time << "ms" << endl;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file generator.cpp
+ * Implementation of synthetic airline network generator.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "generator.h"
+
+// Mean radius of the Earth in thousands of kilometres.
+static const double EARTH_RADIUS = 6.371;
+
+/**
+ * Position of an airport on the globe in radians.
+ */
+struct Position {
+    double latitude, longitude;
+};
+
+/**
+ * Returns the great-circle distance between two positions.
+ */
+static double distance(const Position &a, const Position &b) {
+    double dlat = std::sin((b.latitude - a.latitude) / 2);
+    double dlon = std::sin((b.longitude - a.longitude) / 2);
+    double h = dlat * dlat + std::cos(a.latitude) * std::cos(b.latitude) * dlon * dlon;
+    return 2 * EARTH_RADIUS * std::asin(std::sqrt(std::min(1.0, h)));
+}
+
+unsigned long generate_network(const NetworkOptions &options, const string &airports_path,
+        const string &routes_path) {
+    ofstream airports_file(airports_path), routes_file(routes_path);
+    if (!airports_file || !routes_file) {
+        return 0;
+    }
+
+    mt19937_64 rng(options.seed);
+    uniform_real_distribution<double> uniform(0, 1);
+    unsigned long n = options.num_airports;
+    unsigned per_city = std::max(1u, options.airports_per_city);
+
+    // Uniform on the sphere, with the airports of a city close together.
+    vector<Position> positions(n);
+    char line[256];
+    for (unsigned long i = 0; i < n; i++) {
+        if (i % per_city == 0) {
+            positions[i] = {std::asin(2 * uniform(rng) - 1), 2 * M_PI * uniform(rng) - M_PI};
+        } else {
+            positions[i] = {positions[i - 1].latitude + 0.002 * (uniform(rng) - 0.5),
+                positions[i - 1].longitude + 0.002 * (uniform(rng) - 0.5)};
+        }
+        int length = snprintf(line, sizeof(line), "Synthetic Airport %lu,City %lu,\n",
+            i, i / per_city);
+        airports_file.write(line, length);
+    }
+
+    // Every route endpoint is listed once, so a uniform pick from the list
+    // chooses an airport with probability proportional to its routes.
+    vector<unsigned long> endpoints;
+    endpoints.reserve(2 * n * options.connections);
+    unsigned long num_routes = 0;
+    auto add_routes = [&](unsigned long from, unsigned long to) {
+        double cost = distance(positions[from], positions[to]);
+        unsigned long airline = to % std::max(1u, options.num_airlines);
+        int length = snprintf(line, sizeof(line), "%lu,%lu,Airline %lu,%.17g,\n%lu,%lu,Airline %lu,%.17g,\n",
+            from, to, airline, cost, to, from, airline, cost);
+        routes_file.write(line, length);
+        endpoints.push_back(from);
+        endpoints.push_back(to);
+        num_routes += 2;
+    };
+
+    for (unsigned long i = 1; i < n; i++) {
+        unsigned connections = (unsigned)std::min<unsigned long>(options.connections, i);
+        for (unsigned c = 0; c < connections; c++) {
+            unsigned long to = endpoints.empty() ? 0 :
+                endpoints[(unsigned long)(uniform(rng) * endpoints.size())];
+            if (to == i) {
+                to = (unsigned long)(uniform(rng) * i);
+            }
+            add_routes(i, to);
+        }
+    }
+
+    airports_file.close();
+    routes_file.close();
+    return airports_file && routes_file ? num_routes : 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file generator.h
+ * Definition of synthetic airline network generator.
+ */
+
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+/**
+ * Parameters of a synthetic airline network.
+ */
+struct NetworkOptions {
+    unsigned long num_airports = 10000;
+
+    // Airports each new airport connects to, each connection adding a
+    // route in both directions.
+    unsigned connections = 3;
+
+    // Airlines, each operating the routes of the airports it is based at.
+    unsigned num_airlines = 100;
+
+    // Airports sharing a city, as around large cities in the dataset.
+    unsigned airports_per_city = 2;
+
+    unsigned seed = 42;
+};
+
+/**
+ * Generates a hub-and-spoke airline network and writes it in the format
+ * of data/airports.csv and data/routes.csv.
+ *
+ * Airports are placed at random on the globe and added one at a time,
+ * connecting to existing airports chosen with probability proportional to
+ * their number of routes (preferential attachment). Early airports grow
+ * into hubs and route counts follow a power law, as in real airline
+ * networks. Routes cost their great-circle distance in thousands of
+ * kilometres and belong to the airline based at the airport connected to,
+ * so hubs are dominated by their carrier. Generation is deterministic for
+ * a given seed.
+ * @param options Reference to network parameters.
+ * @param airports_path File path to write airports to.
+ * @param routes_path File path to write routes to.
+ * @returns Number of routes written, 0 if a file could not be written.
+ */
+unsigned long generate_network(const NetworkOptions &options, const string &airports_path,
+    const string &routes_path);
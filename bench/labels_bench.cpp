@@ -0,0 +1,64 @@
+/**
+ * @file labels_bench.cpp
+ * Benchmark of hub label cost queries and paths against Dijkstra's
+ * Algorithm on random point-to-point queries over the airport dataset.
+ *
+ * Usage: ./labels_bench [num_queries]
+ * Reports the preprocessing time and label sizes, the time per cost query,
+ * the speedup of paths recovered from the labels, and any costs that
+ * differ from Dijkstra's. Labels are saved to data/graph.labels, which
+ * later runs load instead of building.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <string>
+
+#include "../graph.h"
+#include "query_bench.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    const string labels_path = "data/graph.labels";
+    unsigned long num_queries = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+    Graph graph;
+    graph.initialize();
+    unsigned long num_airports = graph.get_csr().num_airports();
+
+    vector<vector<int>> queries = random_queries(num_airports, num_queries);
+
+    cout << endl;
+    if (graph.get_hub_labels().empty()) {
+        graph.build_hub_labels();
+        if (graph.save_hub_labels(labels_path, DatasetFingerprint::of("data/airports.csv",
+                "data/routes.csv"))) {
+            cout << "Saved hub labels to " << labels_path << endl;
+        }
+    }
+    const HubLabels &labels = graph.get_hub_labels();
+    cout << "Index: " << labels.num_entries() << " entries, "
+        << (double)labels.num_entries() / (2 * num_airports) << " per label, "
+        << labels.max_label_size() << " largest, " << labels.bytes() / 1024.0 << " KB" << endl;
+
+    cout << endl << "Running " << num_queries << " random queries" << endl;
+    QueryRun dijkstra = run_queries(graph, SearchType::DIJKSTRA, queries);
+    QueryRun paths = run_queries(graph, SearchType::LABELS, queries);
+
+    vector<double> costs;
+    auto start = chrono::steady_clock::now();
+    for (const vector<int> &query : queries) {
+        costs.push_back(graph.shortest_cost(query[0], query[1]));
+    }
+    auto end = chrono::steady_clock::now();
+    double cost_ms = chrono::duration<double, milli>(end - start).count();
+
+    report_baseline("Dijkstra", dijkstra);
+    cout << "Label costs: " << 1000 * cost_ms / num_queries << "us per query ("
+        << dijkstra.ms / std::max(1e-9, cost_ms) << "x faster), "
+        << count_mismatches(dijkstra.costs, costs) << " cost mismatch(es)" << endl;
+    cout << "Label paths: " << paths.ms << "ms (" << dijkstra.ms / std::max(1e-9, paths.ms)
+        << "x faster), " << count_mismatches(dijkstra.costs, paths.costs)
+        << " cost mismatch(es)" << endl;
+}
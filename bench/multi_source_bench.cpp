@@ -0,0 +1,119 @@
+/**
+ * @file multi_source_bench.cpp
+ * Benchmark of batched multi-source shortest-path costs against one
+ * Dijkstra search per source on the airport dataset or a generated network.
+ *
+ * Usage: ./multi_source_bench [directory] [num_sources]
+ * Reads airports.csv and routes.csv from the directory, data by default.
+ * Reports the time of both methods on one thread, the rounds needed per
+ * batch, and any costs that differ from Dijkstra's. Brandes' Algorithm,
+ * which orders airports by their batched costs, is also checked against
+ * Floyd-Warshall's on a random forest with zero-cost routes, self-loops and
+ * cycles of zero-cost routes, where every shortest path is unique and both
+ * must agree.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#include "../graph.h"
+#include "zero_cost.h"
+
+using namespace std;
+
+/**
+ * Counts centralities of Brandes' Algorithm differing from Floyd-Warshall's
+ * on a random forest with zero-cost routes, self-loops and cycles.
+ */
+unsigned long check_zero_cost_routes(unsigned long num_airports) {
+    Graph graph;
+    graph.set_log(NULL);
+    build_zero_cost_forest(graph, num_airports);
+    vector<double> expected = graph.floyd_warshall(), centralities = graph.brandes();
+    unsigned long mismatches = 0;
+    for (unsigned long i = 0; i < num_airports; i++) {
+        mismatches += !(std::fabs(centralities[i] - expected[i]) <= 1e-9);
+    }
+    return mismatches;
+}
+
+int main(int argc, char **argv) {
+    string directory = argc > 1 ? argv[1] : "data";
+    Graph graph;
+    graph.set_log(NULL);
+    graph.read_airports(directory + "/airports.csv");
+    graph.read_routes(directory + "/routes.csv");
+    const CSR &csr = graph.get_csr();
+    unsigned long num_airports = csr.num_airports();
+    unsigned long num_sources = argc > 2 ? std::stoul(argv[2]) : num_airports;
+    num_sources = std::min(num_sources, num_airports);
+
+    vector<int> src_ids(num_sources);
+    for (unsigned long i = 0; i < num_sources; i++) {
+        src_ids[i] = i * num_airports / num_sources;
+    }
+
+    // Dijkstra's Algorithm to every airport, one source at a time.
+    vector<double> expected(num_sources * num_airports);
+    auto start = chrono::steady_clock::now();
+    Heap heap;
+    for (unsigned long i = 0; i < num_sources; i++) {
+        heap.reset(num_airports, src_ids[i]);
+        while (!heap.empty()) {
+            int current = heap.pop();
+            double cost = heap.get_cost(current);
+            for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+                if (cost + csr.get_weight(e) < heap.get_cost(csr.get_dest(e))) {
+                    heap.update(csr.get_dest(e), cost + csr.get_weight(e));
+                }
+            }
+        }
+        for (unsigned long id = 0; id < num_airports; id++) {
+            expected[i * num_airports + id] = heap.get_cost(id);
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    double dijkstra_ms = chrono::duration<double, milli>(end - start).count();
+
+    MultiSourceSearch search;
+    search.build(csr);
+    ThreadPool pool(1);
+    PhaseMetrics counters;
+    vector<double> costs(num_sources * num_airports);
+    unsigned long num_rounds = 0, num_batches = 0;
+    start = chrono::steady_clock::now();
+    search.search_all(src_ids, pool, counters,
+            [&](unsigned long first, const MultiSourceSearch::Batch &batch, unsigned) {
+        for (unsigned lane = 0; lane < MultiSourceSearch::LANES && first + lane < num_sources; lane++) {
+            for (unsigned long id = 0; id < num_airports; id++) {
+                costs[(first + lane) * num_airports + id] = batch.get_cost(lane, id);
+            }
+        }
+        num_rounds += batch.num_rounds;
+        num_batches++;
+    });
+    end = chrono::steady_clock::now();
+    double batched_ms = chrono::duration<double, milli>(end - start).count();
+
+    unsigned long mismatches = 0;
+    for (unsigned long i = 0; i < costs.size(); i++) {
+        if (std::isinf(expected[i]) != std::isinf(costs[i]) || (!std::isinf(costs[i]) &&
+                std::fabs(costs[i] - expected[i]) > 1e-9 * std::max(1.0, expected[i]))) {
+            mismatches++;
+        }
+    }
+
+    cout << endl << "Network: " << num_airports << " airports, " << csr.num_routes()
+        << " routes, " << search.num_routes() << " compact routes" << endl;
+    cout << "Computing costs from " << num_sources << " source(s) on one thread" << endl;
+    cout << "Dijkstra: " << dijkstra_ms << "ms" << endl;
+    cout << "Batched: " << batched_ms << "ms (" << dijkstra_ms / std::max(1e-9, batched_ms)
+        << "x faster), " << (double)num_rounds / std::max(1ul, num_batches)
+        << " rounds per batch of " << MultiSourceSearch::LANES << ", " << mismatches
+        << " cost mismatch(es)" << endl;
+    cout << "Brandes on zero-cost routes: " << check_zero_cost_routes(200)
+        << " centrality mismatch(es) against Floyd-Warshall" << endl;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file query_bench.cpp
+ * Implementation of helpers shared by the point-to-point query benchmarks.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "query_bench.h"
+
+vector<vector<int>> random_queries(unsigned long num_airports, unsigned long num_queries,
+        unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pick(0, num_airports - 1);
+    vector<vector<int>> queries;
+    for (unsigned long i = 0; i < num_queries; i++) {
+        queries.push_back({pick(rng), pick(rng)});
+    }
+    return queries;
+}
+
+QueryRun run_queries(Graph &graph, SearchType type, const vector<vector<int>> &queries) {
+    graph.set_search_type(type);
+    SearchContext context;
+    QueryRun run;
+
+    const CSR &csr = graph.get_csr();
+    unsigned long settled = context.get_num_settled();
+    auto start = chrono::steady_clock::now();
+    for (const vector<int> &query : queries) {
+        double cost = INF_COST;
+        if (graph.shortest_path(query, context)) {
+            cost = 0;
+            for (unsigned route : context.get_path()) {
+                cost += csr.get_weight(route);
+            }
+        }
+        run.costs.push_back(cost);
+        run.paths.push_back(context.get_path());
+    }
+    auto end = chrono::steady_clock::now();
+
+    run.settled = context.get_num_settled() - settled;
+    run.ms = chrono::duration<double, milli>(end - start).count();
+    return run;
+}
+
+/**
+ * Returns if a cost equals the expected cost up to rounding.
+ */
+static bool same_cost(double expected, double cost) {
+    if (std::isinf(expected) || std::isinf(cost)) {
+        return std::isinf(expected) == std::isinf(cost);
+    }
+    return std::fabs(cost - expected) <= 1e-9 * std::max(1.0, expected);
+}
+
+unsigned long count_mismatches(const vector<double> &expected, const vector<double> &costs) {
+    unsigned long mismatches = 0;
+    for (unsigned long i = 0; i < expected.size(); i++) {
+        mismatches += !same_cost(expected[i], costs[i]);
+    }
+    return mismatches;
+}
+
+unsigned long count_different_routes(const QueryRun &run, const QueryRun &baseline) {
+    unsigned long different_routes = 0;
+    for (unsigned long i = 0; i < baseline.costs.size(); i++) {
+        different_routes += same_cost(baseline.costs[i], run.costs[i]) &&
+            run.paths[i] != baseline.paths[i];
+    }
+    return different_routes;
+}
+
+void report_baseline(const string &name, const QueryRun &run) {
+    cout << name << ": " << (double)run.settled / std::max(1ul, run.costs.size())
+        << " airports settled per query, " << run.ms << "ms" << endl;
+}
+
+void report(const string &name, const QueryRun &run, const QueryRun &baseline) {
+    cout << name << ": " << (double)run.settled / std::max(1ul, run.costs.size())
+        << " airports settled per query (" << (double)baseline.settled / std::max(1ul, run.settled)
+        << "x fewer), " << run.ms << "ms (" << baseline.ms / std::max(1e-9, run.ms)
+        << "x faster), " << count_mismatches(baseline.costs, run.costs) << " cost mismatch(es)"
+        << endl;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file query_bench.h
+ * Definition of helpers shared by the point-to-point query benchmarks.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../graph.h"
+
+using namespace std;
+
+/**
+ * Results of running every query with one search algorithm.
+ */
+struct QueryRun {
+    vector<double> costs;
+    vector<vector<unsigned>> paths;
+    unsigned long settled = 0;
+    double ms = 0;
+};
+
+/**
+ * Generates random queries between two airports, the same for a given seed.
+ * @param num_airports Number of airports to pick from.
+ * @param num_queries Number of queries to generate.
+ * @param seed Seed of random number generator.
+ * @returns Queries as pairs of airport IDs.
+ */
+vector<vector<int>> random_queries(unsigned long num_airports, unsigned long num_queries,
+    unsigned seed = 42);
+
+/**
+ * Runs every query with a search algorithm, recording the cost and routes
+ * of each path and the airports settled.
+ * @param graph Reference to graph, whose search type is set.
+ * @param type Search algorithm to run.
+ * @param queries Reference to queries as airport IDs.
+ * @returns Results of the queries, INF_COST for unreachable ones.
+ */
+QueryRun run_queries(Graph &graph, SearchType type, const vector<vector<int>> &queries);
+
+/**
+ * Counts costs differing from the expected costs by more than rounding.
+ * @param expected Reference to expected costs.
+ * @param costs Reference to costs to check.
+ * @returns Number of mismatched costs.
+ */
+unsigned long count_mismatches(const vector<double> &expected, const vector<double> &costs);
+
+/**
+ * Counts paths of equal cost to the baseline taking other routes.
+ * @param run Reference to results to check.
+ * @param baseline Reference to expected results.
+ * @returns Number of equal-cost paths with other routes.
+ */
+unsigned long count_different_routes(const QueryRun &run, const QueryRun &baseline);
+
+/**
+ * Prints the airports settled per query and time of the baseline run.
+ * @param name Name of search algorithm.
+ * @param run Reference to baseline results.
+ */
+void report_baseline(const string &name, const QueryRun &run);
+
+/**
+ * Prints the airports settled per query, time and cost mismatches of a
+ * run compared to the baseline run.
+ * @param name Name of search algorithm.
+ * @param run Reference to results to report.
+ * @param baseline Reference to baseline results.
+ */
+void report(const string &name, const QueryRun &run, const QueryRun &baseline);
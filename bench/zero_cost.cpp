@@ -0,0 +1,37 @@
+/**
+ * @file zero_cost.cpp
+ * Implementation of zero-cost route network used to check path counting.
+ */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "zero_cost.h"
+
+void build_zero_cost_forest(Graph &graph, unsigned long num_airports, unsigned seed) {
+    mt19937 rng(seed);
+    vector<int> ids(num_airports);
+    for (unsigned long i = 0; i < num_airports; i++) {
+        graph.create_airport("Airport " + to_string(i), "City " + to_string(i));
+        ids[i] = i;
+    }
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    // Routes back to the parent keep the forest a tree when directions are
+    // ignored, so paths stay unique.
+    for (unsigned long i = 1; i < num_airports; i++) {
+        if (rng() % 8 != 0) {
+            int parent = ids[rng() % i];
+            double weight = rng() % 3 == 0 ? 0 : 1 + rng() % 5;
+            graph.create_route(parent, ids[i], "Airline", weight);
+            if (weight == 0 && rng() % 2 == 0) {
+                graph.create_route(ids[i], parent, "Airline", 0);
+            }
+        }
+        if (i % 5 == 0) {
+            graph.create_route(ids[i], ids[i], "Airline", 0);
+        }
+    }
+}
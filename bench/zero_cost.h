@@ -0,0 +1,27 @@
+/**
+ * @file zero_cost.h
+ * Definition of zero-cost route network used to check path counting.
+ */
+
+#pragma once
+
+#include "../graph.h"
+
+using namespace std;
+
+/**
+ * Adds a random forest of airports to an empty graph in which every
+ * shortest path is unique, yet many routes cost nothing, so that
+ * centralities counting every shortest path must equal those following
+ * one path per pair.
+ *
+ * Parents are picked in a shuffled order of IDs, so zero-cost routes lead
+ * to lower IDs as often as higher ones. A third of the routes cost
+ * nothing, half of those are paired with a zero-cost route back to the
+ * parent, forming cycles of zero-cost routes, and every fifth airport has
+ * a zero-cost self-loop.
+ * @param graph Reference to empty graph to add airports and routes to.
+ * @param num_airports Number of airports to add.
+ * @param seed Seed of random number generator.
+ */
+void build_zero_cost_forest(Graph &graph, unsigned long num_airports, unsigned seed = 42);
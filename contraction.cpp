@@ -0,0 +1,297 @@
+/**
+ * @file contraction.cpp
+ * Implementation of contraction hierarchy class.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "contraction.h"
+
+// Airports settled by a witness search before giving up and adding the
+// shortcut, which keeps contraction fast at the cost of a few extra shortcuts.
+static const unsigned long WITNESS_LIMIT = 500;
+
+void ContractionHierarchy::build(const CSR &csr) {
+    unsigned long n = csr.num_airports();
+    clear();
+    out_edges.assign(n, vector<unsigned>());
+    in_edges.assign(n, vector<unsigned>());
+    contracted.assign(n, false);
+
+    // Only the cheapest of parallel routes can be on a shortest path, and the
+    // first one is kept on ties as Dijkstra's Algorithm would.
+    vector<unsigned> edge_to(n, NO_ROUTE);
+    for (unsigned long u = 0; u < n; u++) {
+        for (unsigned e = csr.get_begin(u); e < csr.get_end(u); e++) {
+            int w = csr.get_dest(e);
+            if (w == (int)u) {
+                continue;
+            }
+            if (edge_to[w] == NO_ROUTE) {
+                edge_to[w] = edges.size();
+                edges.push_back({(int)u, w, csr.get_weight(e), e, NO_ROUTE, NO_ROUTE});
+                out_edges[u].push_back(edge_to[w]);
+                in_edges[w].push_back(edge_to[w]);
+            } else if (csr.get_weight(e) < edges[edge_to[w]].weight) {
+                edges[edge_to[w]].weight = csr.get_weight(e);
+                edges[edge_to[w]].route = e;
+            }
+        }
+        for (unsigned e : out_edges[u]) {
+            edge_to[edges[e].dest] = NO_ROUTE;
+        }
+    }
+
+    // Airports are contracted by edge difference plus contracted neighbours,
+    // with priorities updated lazily when they reach the top of the queue.
+    vector<long> deleted_neighbours(n, 0);
+    auto priority = [&](int id) {
+        long degree = 0;
+        for (unsigned e : out_edges[id]) {
+            degree += !contracted[edges[e].dest];
+        }
+        for (unsigned e : in_edges[id]) {
+            degree += !contracted[edges[e].src];
+        }
+        return (long)contract(id, false) - degree + deleted_neighbours[id];
+    };
+
+    typedef pair<long, int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> queue;
+    for (unsigned long id = 0; id < n; id++) {
+        queue.push(Entry(priority(id), id));
+    }
+
+    vector<unsigned> rank(n);
+    unsigned order = 0;
+    while (!queue.empty()) {
+        int id = queue.top().second;
+        queue.pop();
+
+        long current = priority(id);
+        if (!queue.empty() && current > queue.top().first) {
+            queue.push(Entry(current, id));
+            continue;
+        }
+
+        contract(id, true);
+        contracted[id] = true;
+        rank[id] = order++;
+        for (unsigned e : out_edges[id]) {
+            deleted_neighbours[edges[e].dest]++;
+        }
+        for (unsigned e : in_edges[id]) {
+            deleted_neighbours[edges[e].src]++;
+        }
+    }
+
+    // Every remaining edge is searched from its lower-ranked end: forwards
+    // when it leads upwards, backwards from its destination otherwise.
+    up_offsets.assign(n + 1, 0);
+    down_offsets.assign(n + 1, 0);
+    for (unsigned long u = 0; u < n; u++) {
+        for (unsigned e : out_edges[u]) {
+            int w = edges[e].dest;
+            if (rank[w] > rank[u]) {
+                up_offsets[u + 1]++;
+            } else {
+                down_offsets[w + 1]++;
+            }
+        }
+    }
+    for (unsigned long i = 0; i < n; i++) {
+        up_offsets[i + 1] += up_offsets[i];
+        down_offsets[i + 1] += down_offsets[i];
+    }
+
+    up_edges.resize(up_offsets[n]);
+    down_edges.resize(down_offsets[n]);
+    vector<unsigned> up_next(up_offsets.begin(), up_offsets.end() - 1);
+    vector<unsigned> down_next(down_offsets.begin(), down_offsets.end() - 1);
+    for (unsigned long u = 0; u < n; u++) {
+        for (unsigned e : out_edges[u]) {
+            int w = edges[e].dest;
+            if (rank[w] > rank[u]) {
+                up_edges[up_next[u]++] = e;
+            } else {
+                down_edges[down_next[w]++] = e;
+            }
+        }
+    }
+
+    out_edges.clear();
+    in_edges.clear();
+    contracted.clear();
+}
+
+void ContractionHierarchy::clear() {
+    edges.clear();
+    up_offsets.clear();
+    up_edges.clear();
+    down_offsets.clear();
+    down_edges.clear();
+}
+
+bool ContractionHierarchy::empty() const {
+    return up_offsets.empty();
+}
+
+bool ContractionHierarchy::find_path(int src_id, int dest_id, SearchContext &context) const {
+    unsigned long n = up_offsets.size() - 1;
+    SearchContext &reverse = context.get_reverse();
+    Heap &forward_heap = context.start<Heap>(n, src_id);
+    Heap &backward_heap = reverse.start<Heap>(n, dest_id);
+
+    // Each direction stops once its closest airport costs at least as much
+    // as the best path found, since any later meeting would cost more.
+    double best = INF_COST;
+    int meeting = -1;
+    bool forward_done = false, backward_done = false;
+    for (bool forward = true; !forward_done || !backward_done; forward = !forward) {
+        if (forward ? forward_done : backward_done) {
+            continue;
+        }
+
+        Heap &heap = forward ? forward_heap : backward_heap;
+        const Heap &other = forward ? backward_heap : forward_heap;
+        if (heap.empty()) {
+            (forward ? forward_done : backward_done) = true;
+            continue;
+        }
+
+        int current = heap.pop();
+        double cost = heap.get_cost(current);
+        if (cost >= best) {
+            (forward ? forward_done : backward_done) = true;
+            continue;
+        }
+        (forward ? context : reverse).settle(current);
+
+        if (cost + other.get_cost(current) < best) {
+            best = cost + other.get_cost(current);
+            meeting = current;
+        }
+
+        const vector<unsigned> &offsets = forward ? up_offsets : down_offsets;
+        const vector<unsigned> &adjacent = forward ? up_edges : down_edges;
+        (forward ? context : reverse).scan(offsets[current + 1] - offsets[current]);
+        for (unsigned i = offsets[current]; i < offsets[current + 1]; i++) {
+            const Edge &edge = edges[adjacent[i]];
+            int next_id = forward ? edge.dest : edge.src;
+            if (cost + edge.weight < heap.get_cost(next_id)) {
+                heap.update(next_id, cost + edge.weight);
+                (forward ? context : reverse).set_predecessor(next_id, adjacent[i]);
+            }
+        }
+    }
+
+    if (meeting == -1) {
+        return false;
+    }
+
+    unpack_upward(src_id, meeting, context);
+    for (int id = meeting; id != dest_id; id = edges[reverse.get_predecessor(id)].dest) {
+        unpack(reverse.get_predecessor(id), context);
+    }
+    return true;
+}
+
+unsigned long ContractionHierarchy::num_shortcuts() const {
+    unsigned long shortcuts = 0;
+    for (const Edge &edge : edges) {
+        shortcuts += edge.route == NO_ROUTE;
+    }
+    return shortcuts;
+}
+
+unsigned long ContractionHierarchy::bytes() const {
+    return edges.size() * sizeof(Edge) + (up_offsets.size() + up_edges.size() +
+        down_offsets.size() + down_edges.size()) * sizeof(unsigned);
+}
+
+unsigned long ContractionHierarchy::contract(int id, bool add) {
+    unsigned long n = contracted.size();
+    double max_out = 0;
+    for (unsigned e : out_edges[id]) {
+        if (!contracted[edges[e].dest]) {
+            max_out = std::max(max_out, edges[e].weight);
+        }
+    }
+
+    unsigned long shortcuts = 0;
+    for (unsigned long i = 0; i < in_edges[id].size(); i++) {
+        unsigned in = in_edges[id][i];
+        int u = edges[in].src;
+        if (contracted[u]) {
+            continue;
+        }
+
+        // Searches from the neighbour for paths avoiding the airport that
+        // are no more expensive than the routes through it.
+        double limit = edges[in].weight + max_out;
+        Heap &heap = witness.start<Heap>(n, u);
+        for (unsigned long settled = 0; !heap.empty() && settled < WITNESS_LIMIT; settled++) {
+            int current = heap.pop();
+            double cost = heap.get_cost(current);
+            if (cost > limit) {
+                break;
+            }
+            for (unsigned e : out_edges[current]) {
+                int next_id = edges[e].dest;
+                if (next_id != id && !contracted[next_id] &&
+                        cost + edges[e].weight < heap.get_cost(next_id)) {
+                    heap.update(next_id, cost + edges[e].weight);
+                }
+            }
+        }
+
+        for (unsigned long j = 0; j < out_edges[id].size(); j++) {
+            unsigned out = out_edges[id][j];
+            int w = edges[out].dest;
+            double via = edges[in].weight + edges[out].weight;
+            if (contracted[w] || w == u || heap.get_cost(w) <= via) {
+                continue;
+            }
+
+            shortcuts++;
+            if (!add) {
+                continue;
+            }
+
+            // A cheaper shortcut replaces an existing edge between the same
+            // airports, which stays in the edge list for unpacking.
+            unsigned shortcut = edges.size();
+            edges.push_back({u, w, via, NO_ROUTE, in, out});
+            auto existing = std::find_if(out_edges[u].begin(), out_edges[u].end(),
+                [&](unsigned e) { return edges[e].dest == w; });
+            if (existing != out_edges[u].end()) {
+                std::replace(in_edges[w].begin(), in_edges[w].end(), *existing, shortcut);
+                *existing = shortcut;
+            } else {
+                out_edges[u].push_back(shortcut);
+                in_edges[w].push_back(shortcut);
+            }
+        }
+    }
+    return shortcuts;
+}
+
+void ContractionHierarchy::unpack_upward(int src_id, int id, SearchContext &context) const {
+    if (id != src_id) {
+        unsigned edge = context.get_predecessor(id);
+        unpack_upward(src_id, edges[edge].src, context);
+        unpack(edge, context);
+    }
+}
+
+void ContractionHierarchy::unpack(unsigned edge, SearchContext &context) const {
+    if (edges[edge].route != NO_ROUTE) {
+        context.append_route(edges[edge].route);
+    } else {
+        unpack(edges[edge].first, context);
+        unpack(edges[edge].second, context);
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file contraction.h
+ * Definition of contraction hierarchy class.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "csr.h"
+#include "search.h"
+
+using namespace std;
+
+/**
+ * Contraction hierarchy (CH) index for fast point-to-point queries.
+ *
+ * Airports are contracted one at a time in order of importance. Whenever
+ * removing an airport would lengthen a shortest path between two of its
+ * neighbours, a shortcut replacing the two routes through it is added.
+ * Queries then only search upwards in this order from both ends and meet
+ * at the most important airport of the path, settling a small fraction of
+ * the graph. Shortcuts remember the two edges they replace, so paths are
+ * unpacked back into the original routes with their airlines.
+ * @author Vaibhav Gupta
+ */
+class ContractionHierarchy {
+    public:
+        /**
+         * Orders and contracts every airport of a graph, replacing any
+         * previous index.
+         * @param csr Reference to CSR graph.
+         */
+        void build(const CSR &csr);
+
+        /**
+         * Removes the index, which must be rebuilt after the graph changes.
+         */
+        void clear();
+
+        /**
+         * Returns if no index has been built.
+         * @returns Boolean representing if index is empty or not.
+         */
+        bool empty() const;
+
+        /**
+         * Finds the shortest path between two airports and appends its
+         * original route indices to the path of a search context.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context, whose reverse context
+         * is used for the backward search.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        bool find_path(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Returns number of shortcuts added by contraction.
+         * @returns Number of shortcuts.
+         */
+        unsigned long num_shortcuts() const;
+
+        /**
+         * Returns the memory used by the index.
+         * @returns Number of bytes.
+         */
+        unsigned long bytes() const;
+
+    private:
+        /**
+         * Route of the original graph or shortcut replacing two edges.
+         */
+        struct Edge {
+            int src, dest;
+            double weight;
+
+            // Route index of an original route, NO_ROUTE for shortcuts.
+            unsigned route;
+
+            // Edge indices of the first and second half of a shortcut.
+            unsigned first, second;
+        };
+
+        /**
+         * Helper function to count or add the shortcuts needed to contract
+         * an airport, using local witness searches between its neighbours.
+         * @param id Airport ID to contract.
+         * @param add Whether to add the shortcuts or only count them.
+         * @returns Number of shortcuts needed.
+         */
+        unsigned long contract(int id, bool add);
+
+        /**
+         * Helper function to append the original routes of the forward
+         * search path from the source airport up to an airport.
+         * @param src_id ID of source airport of the forward search.
+         * @param id ID of airport settled by the forward search.
+         * @param context Reference to search context of the forward search.
+         */
+        void unpack_upward(int src_id, int id, SearchContext &context) const;
+
+        /**
+         * Helper function to append the original routes of an edge to the
+         * path of a search context, unpacking shortcuts recursively.
+         * @param edge Edge index.
+         * @param context Reference to search context.
+         */
+        void unpack(unsigned edge, SearchContext &context) const;
+
+        vector<Edge> edges;
+
+        // Upward edges leaving each airport, and upward edges entering each
+        // airport that are followed backwards, indexed like a CSR.
+        vector<unsigned> up_offsets, up_edges;
+        vector<unsigned> down_offsets, down_edges;
+
+        // Working graph while building: edges leaving and entering each airport.
+        vector<vector<unsigned>> out_edges, in_edges;
+        vector<char> contracted;
+        SearchContext witness;
+};
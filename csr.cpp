@@ -0,0 +1,114 @@
+/**
+ * @file csr.cpp
+ * Implementation of compressed sparse row graph class.
+ */
+
+#include "csr.h"
+
+void CSR::build(const vector<Airport*> &airports, const AirlineDictionary &airlines) {
+    owned_offsets.assign(1, 0);
+    owned_srcs.clear();
+    owned_dests.clear();
+    owned_airline_ids.clear();
+    owned_weights.clear();
+    routes.clear();
+    this -> airlines = airlines.get_names();
+    forward_ids.clear();
+
+    unsigned long num_routes = 0;
+    for (Airport *airport : airports) {
+        if (airport != NULL) {
+            num_routes += airport -> get_routes().size();
+        }
+    }
+    owned_offsets.reserve(airports.size() + 1);
+    owned_srcs.reserve(num_routes);
+    owned_dests.reserve(num_routes);
+    owned_airline_ids.reserve(num_routes);
+    owned_weights.reserve(num_routes);
+    routes.reserve(num_routes);
+
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        if (airports[i] != NULL) {
+            for (Route *route : airports[i] -> get_routes()) {
+                owned_srcs.push_back(i);
+                owned_dests.push_back(route -> get_dest() -> get_id());
+                owned_airline_ids.push_back(route -> get_airline());
+                owned_weights.push_back(route -> get_weight());
+                routes.push_back(route);
+            }
+        }
+        owned_offsets.push_back(owned_dests.size());
+    }
+
+    airport_count = airports.size();
+    route_count = owned_dests.size();
+    offsets = owned_offsets.data();
+    srcs = owned_srcs.data();
+    dests = owned_dests.data();
+    airline_ids = owned_airline_ids.data();
+    weights = owned_weights.data();
+}
+
+void CSR::build_reverse(const CSR &forward) {
+    unsigned long num_routes = forward.num_routes();
+    owned_offsets.assign(forward.num_airports() + 1, 0);
+    owned_srcs.resize(num_routes);
+    owned_dests.resize(num_routes);
+    owned_airline_ids.resize(num_routes);
+    owned_weights.resize(num_routes);
+    routes.resize(num_routes);
+    forward_ids.resize(num_routes);
+    airlines.clear();
+    for (unsigned long i = 0; i < forward.num_airlines(); i++) {
+        airlines.push_back(forward.get_airline_name(i));
+    }
+
+    // Counting sort by destination, keeping the forward order within each.
+    for (unsigned long e = 0; e < num_routes; e++) {
+        owned_offsets[forward.get_dest(e) + 1]++;
+    }
+    for (unsigned long i = 0; i < forward.num_airports(); i++) {
+        owned_offsets[i + 1] += owned_offsets[i];
+    }
+    vector<unsigned> next(owned_offsets.begin(), owned_offsets.end() - 1);
+    for (unsigned long e = 0; e < num_routes; e++) {
+        unsigned idx = next[forward.get_dest(e)]++;
+        owned_srcs[idx] = forward.get_dest(e);
+        owned_dests[idx] = forward.get_src(e);
+        owned_airline_ids[idx] = forward.get_airline(e);
+        owned_weights[idx] = forward.get_weight(e);
+        routes[idx] = forward.get_route(e);
+        forward_ids[idx] = e;
+    }
+
+    airport_count = forward.num_airports();
+    route_count = num_routes;
+    offsets = owned_offsets.data();
+    srcs = owned_srcs.data();
+    dests = owned_dests.data();
+    airline_ids = owned_airline_ids.data();
+    weights = owned_weights.data();
+}
+
+void CSR::attach(unsigned long num_airports, unsigned long num_routes,
+        const unsigned *offsets, const int *srcs, const int *dests,
+        const double *weights, const int *airline_ids,
+        const vector<string> &airlines, const vector<Route*> &routes) {
+    owned_offsets.clear();
+    owned_srcs.clear();
+    owned_dests.clear();
+    owned_airline_ids.clear();
+    owned_weights.clear();
+    forward_ids.clear();
+
+    airport_count = num_airports;
+    route_count = num_routes;
+    this -> offsets = offsets;
+    this -> srcs = srcs;
+    this -> dests = dests;
+    this -> weights = weights;
+    this -> airline_ids = airline_ids;
+    this -> airlines = airlines;
+    this -> routes = routes;
+}
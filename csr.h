@@ -0,0 +1,269 @@
+/**
+ * @file csr.h
+ * Definition of compressed sparse row graph class.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "airport.h"
+#include "route.h"
+#include "airlines.h"
+
+using namespace std;
+
+// Route index standing for no route, such as the route into a source airport.
+const unsigned NO_ROUTE = static_cast<unsigned>(-1);
+
+/**
+ * Immutable compressed sparse row (CSR) snapshot of the route network.
+ *
+ * The outgoing routes of airport i are stored contiguously at indices
+ * [get_begin(i), get_end(i)) of the destination, weight and airline
+ * arrays, so traversals scan flat arrays instead of chasing pointers.
+ * Route pointers are kept alongside for presenting results.
+ *
+ * The arrays are either owned by the snapshot or borrowed from memory
+ * that outlives it, such as a memory-mapped graph snapshot file.
+ * @author Vaibhav Gupta
+ */
+class CSR {
+    public:
+        CSR() = default;
+        CSR(const CSR &other) = delete;
+        CSR &operator=(const CSR &other) = delete;
+
+        /**
+         * Builds the snapshot from the airports of a graph, replacing
+         * any previous contents.
+         * @param airports Reference to vector of pointers to airports,
+         * indexed by airport ID.
+         * @param airlines Reference to dictionary the airline IDs of the
+         * routes belong to.
+         */
+        void build(const vector<Airport*> &airports, const AirlineDictionary &airlines);
+
+        /**
+         * Builds the reverse of another snapshot, replacing any previous
+         * contents. Every route is stored under its destination airport
+         * with its source and destination swapped, so searches follow
+         * routes backwards. Route objects keep their original direction,
+         * and get_forward() maps each route back to its forward index.
+         * @param forward Reference to snapshot to reverse.
+         */
+        void build_reverse(const CSR &forward);
+
+        /**
+         * Points the snapshot at arrays owned by the caller, replacing any
+         * previous contents. The arrays must outlive the snapshot or the
+         * next call to build() or attach().
+         * @param num_airports Number of airports.
+         * @param num_routes Number of routes.
+         * @param offsets Pointer to num_airports + 1 route offsets.
+         * @param srcs Pointer to source airport ID of each route.
+         * @param dests Pointer to destination airport ID of each route.
+         * @param weights Pointer to cost of each route.
+         * @param airline_ids Pointer to airline ID of each route.
+         * @param airlines Names of airlines, indexed by airline ID.
+         * @param routes Route objects in the same order as the arrays.
+         */
+        void attach(unsigned long num_airports, unsigned long num_routes,
+            const unsigned *offsets, const int *srcs, const int *dests,
+            const double *weights, const int *airline_ids,
+            const vector<string> &airlines, const vector<Route*> &routes);
+
+        /**
+         * Returns number of airports in the snapshot.
+         * @returns Number of airports.
+         */
+        unsigned long num_airports() const;
+
+        /**
+         * Returns number of routes in the snapshot.
+         * @returns Number of routes.
+         */
+        unsigned long num_routes() const;
+
+        /**
+         * Returns index of the first outgoing route of an airport.
+         * @param id Airport ID.
+         * @returns Route index of first outgoing route.
+         */
+        unsigned get_begin(int id) const;
+
+        /**
+         * Returns index past the last outgoing route of an airport.
+         * @param id Airport ID.
+         * @returns Route index past last outgoing route.
+         */
+        unsigned get_end(int id) const;
+
+        /**
+         * Returns source airport ID of a route.
+         * @param idx Route index.
+         * @returns Source airport ID.
+         */
+        int get_src(unsigned idx) const;
+
+        /**
+         * Returns destination airport ID of a route.
+         * @param idx Route index.
+         * @returns Destination airport ID.
+         */
+        int get_dest(unsigned idx) const;
+
+        /**
+         * Returns cost of a route.
+         * @param idx Route index.
+         * @returns Cost of route.
+         */
+        double get_weight(unsigned idx) const;
+
+        /**
+         * Returns airline ID of a route.
+         * @param idx Route index.
+         * @returns Airline ID, an index into get_airline_name().
+         */
+        int get_airline(unsigned idx) const;
+
+        /**
+         * Returns name of an airline.
+         * @param airline Airline ID.
+         * @returns Reference to name of airline.
+         */
+        const string &get_airline_name(int airline) const;
+
+        /**
+         * Returns number of distinct airlines.
+         * @returns Number of airlines.
+         */
+        unsigned long num_airlines() const;
+
+        /**
+         * Returns route object of a route index, used for presentation.
+         * @param idx Route index.
+         * @returns Pointer to route.
+         */
+        Route *get_route(unsigned idx) const;
+
+        /**
+         * Returns the index a route of a reverse snapshot has in the
+         * snapshot it was built from.
+         * @param idx Route index in the reverse snapshot.
+         * @returns Route index in the forward snapshot.
+         */
+        unsigned get_forward(unsigned idx) const;
+
+        /**
+         * Returns pointer to the route offsets of every airport.
+         * @returns Pointer to num_airports() + 1 offsets.
+         */
+        const unsigned *get_offsets() const;
+
+        /**
+         * Returns pointer to the source airport ID of every route.
+         * @returns Pointer to num_routes() source IDs.
+         */
+        const int *get_srcs() const;
+
+        /**
+         * Returns pointer to the destination airport ID of every route.
+         * @returns Pointer to num_routes() destination IDs.
+         */
+        const int *get_dests() const;
+
+        /**
+         * Returns pointer to the cost of every route.
+         * @returns Pointer to num_routes() costs.
+         */
+        const double *get_weights() const;
+
+        /**
+         * Returns pointer to the airline ID of every route.
+         * @returns Pointer to num_routes() airline IDs.
+         */
+        const int *get_airline_ids() const;
+
+    private:
+        unsigned long airport_count = 0, route_count = 0;
+        const unsigned *offsets = NULL;
+        const int *srcs = NULL, *dests = NULL, *airline_ids = NULL;
+        const double *weights = NULL;
+
+        vector<unsigned> owned_offsets;
+        vector<int> owned_srcs, owned_dests, owned_airline_ids;
+        vector<double> owned_weights;
+        vector<Route*> routes;
+        vector<string> airlines;
+        vector<unsigned> forward_ids;
+};
+
+inline unsigned long CSR::num_airports() const {
+    return airport_count;
+}
+
+inline unsigned long CSR::num_routes() const {
+    return route_count;
+}
+
+inline unsigned CSR::get_begin(int id) const {
+    return offsets[id];
+}
+
+inline unsigned CSR::get_end(int id) const {
+    return offsets[id + 1];
+}
+
+inline int CSR::get_src(unsigned idx) const {
+    return srcs[idx];
+}
+
+inline int CSR::get_dest(unsigned idx) const {
+    return dests[idx];
+}
+
+inline double CSR::get_weight(unsigned idx) const {
+    return weights[idx];
+}
+
+inline int CSR::get_airline(unsigned idx) const {
+    return airline_ids[idx];
+}
+
+inline const string &CSR::get_airline_name(int airline) const {
+    return airlines[airline];
+}
+
+inline unsigned long CSR::num_airlines() const {
+    return airlines.size();
+}
+
+inline Route *CSR::get_route(unsigned idx) const {
+    return routes[idx];
+}
+
+inline unsigned CSR::get_forward(unsigned idx) const {
+    return forward_ids[idx];
+}
+
+inline const unsigned *CSR::get_offsets() const {
+    return offsets;
+}
+
+inline const int *CSR::get_srcs() const {
+    return srcs;
+}
+
+inline const int *CSR::get_dests() const {
+    return dests;
+}
+
+inline const double *CSR::get_weights() const {
+    return weights;
+}
+
+inline const int *CSR::get_airline_ids() const {
+    return airline_ids;
+}
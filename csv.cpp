@@ -0,0 +1,87 @@
+/**
+ * @file csv.cpp
+ * Implementation of memory-mapped CSV reader class.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+#include "csv.h"
+
+// Chunks smaller than this are not worth handing to another thread.
+static const unsigned long MIN_CHUNK_SIZE = 1 << 20;
+
+bool CSVReader::open(const string &file_path, unsigned long num_chunks) {
+    boundaries.clear();
+    first_lines.clear();
+    if (!file.open(file_path)) {
+        return false;
+    }
+
+    const char *data = file.data();
+    unsigned long size = file.size();
+    unsigned long chunk_size = std::max(MIN_CHUNK_SIZE, size / std::max(1ul, num_chunks) + 1);
+
+    // Each chunk boundary is moved forward to just past the next newline.
+    boundaries.push_back(0);
+    while (boundaries.back() < size) {
+        unsigned long pos = std::min(size, boundaries.back() + chunk_size);
+        const char *newline = static_cast<const char*>(memchr(data + pos, '\n', size - pos));
+        boundaries.push_back(newline != NULL ? newline - data + 1 : size);
+    }
+
+    // Line numbers of each chunk start after the newlines of all earlier chunks.
+    first_lines.push_back(1);
+    for (unsigned long i = 0; i + 1 < boundaries.size(); i++) {
+        first_lines.push_back(first_lines.back() +
+            std::count(data + boundaries[i], data + boundaries[i + 1], '\n'));
+    }
+    return true;
+}
+
+unsigned long CSVReader::num_chunks() const {
+    return boundaries.empty() ? 0 : boundaries.size() - 1;
+}
+
+bool CSVReader::parse_int(string_view field, int &value) {
+    const char *end = field.data() + field.size();
+    from_chars_result result = std::from_chars(field.data(), end, value);
+    return !field.empty() && result.ec == errc() && result.ptr == end;
+}
+
+bool CSVReader::parse_double(string_view field, double &value) {
+    if (field.empty()) {
+        return false;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const char *end = field.data() + field.size();
+    from_chars_result result = std::from_chars(field.data(), end, value);
+    return result.ec == errc() && result.ptr == end;
+#else
+    // strtod needs a terminated string, and the mapped field is not one.
+    char buffer[64];
+    if (field.size() >= sizeof(buffer)) {
+        return false;
+    }
+    memcpy(buffer, field.data(), field.size());
+    buffer[field.size()] = '\0';
+
+    char *end;
+    value = strtod(buffer, &end);
+    return end == buffer + field.size();
+#endif
+}
+
+void CSVReader::split(string_view line, CSVRow &row) {
+    row.num_fields = 0;
+    while (row.num_fields < MAX_CSV_FIELDS) {
+        unsigned long comma = line.find(',');
+        row.fields[row.num_fields++] = line.substr(0, comma);
+        if (comma == string_view::npos) {
+            break;
+        }
+        line.remove_prefix(comma + 1);
+    }
+}
@@ -0,0 +1,126 @@
+/**
+ * @file csv.h
+ * Definition of memory-mapped CSV reader class.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// Maximum number of fields read from each CSV row, the rest are ignored.
+const unsigned MAX_CSV_FIELDS = 8;
+
+/**
+ * Fields of one CSV row, viewing the memory-mapped file.
+ */
+struct CSVRow {
+    unsigned long line;
+    unsigned num_fields;
+    string_view fields[MAX_CSV_FIELDS];
+};
+
+/**
+ * Row of a CSV file that could not be read.
+ */
+struct CSVError {
+    unsigned long line;
+    string message;
+};
+
+/**
+ * Reads a CSV file by memory-mapping it and tokenizing rows in place.
+ *
+ * The file is split into chunks at newline boundaries which are parsed
+ * in parallel. Fields are views into the mapping, so no strings are
+ * allocated unless the caller copies a field.
+ * @author Vaibhav Gupta
+ */
+class CSVReader {
+    public:
+        /**
+         * Maps a file and splits it into chunks.
+         * @param file_path File path to read.
+         * @param num_chunks Number of chunks to aim for, fewer are used
+         * for small files.
+         * @returns Boolean representing if the file was opened or not.
+         */
+        bool open(const string &file_path, unsigned long num_chunks);
+
+        /**
+         * Returns number of chunks the file was split into.
+         * @returns Number of chunks.
+         */
+        unsigned long num_chunks() const;
+
+        /**
+         * Calls a function for every non-empty row of the file. Chunks are
+         * parsed in parallel, and rows within a chunk in file order.
+         * @param pool Reference to thread pool to parse chunks on.
+         * @param parse Function called with the chunk index and each row.
+         */
+        template <typename Parse>
+        void for_each_row(ThreadPool &pool, Parse parse) const;
+
+        /**
+         * Parses a whole field as an integer.
+         * @param field Field to parse.
+         * @param value Reference to integer to store the result in.
+         * @returns Boolean representing if the field is a valid integer or not.
+         */
+        static bool parse_int(string_view field, int &value);
+
+        /**
+         * Parses a whole field as a floating-point number.
+         * @param field Field to parse.
+         * @param value Reference to double to store the result in.
+         * @returns Boolean representing if the field is a valid number or not.
+         */
+        static bool parse_double(string_view field, double &value);
+
+    private:
+        /**
+         * Helper function to split a line into fields at commas.
+         * @param line Line without its newline.
+         * @param row Reference to row to store the fields in.
+         */
+        static void split(string_view line, CSVRow &row);
+
+        MappedFile file;
+        vector<unsigned long> boundaries;
+        vector<unsigned long> first_lines;
+};
+
+template <typename Parse>
+void CSVReader::for_each_row(ThreadPool &pool, Parse parse) const {
+    pool.parallel_for(num_chunks(), [&](unsigned long chunk) {
+        const char *data = file.data();
+        unsigned long pos = boundaries[chunk], end = boundaries[chunk + 1];
+
+        CSVRow row;
+        row.line = first_lines[chunk];
+        while (pos < end) {
+            const char *newline = static_cast<const char*>(memchr(data + pos, '\n', end - pos));
+            unsigned long line_end = newline != NULL ? newline - data : end;
+
+            string_view line(data + pos, line_end - pos);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (!line.empty()) {
+                split(line, row);
+                parse(chunk, row);
+            }
+
+            pos = line_end + 1;
+            row.line++;
+        }
+    });
+}
@@ -0,0 +1,247 @@
+/**
+ * @file delta_stepping.cpp
+ * Implementation of parallel delta-stepping shortest-path class.
+ */
+
+#include <algorithm>
+
+#include "delta_stepping.h"
+
+// Airports handled by each claim of a thread, large enough that claiming
+// costs far less than relaxing the routes of the airports claimed.
+static const unsigned long CHUNK_SIZE = 256;
+
+// Most buckets a single route may span, which bounds the number of buckets
+// when a few routes cost far more than the rest.
+static const double MAX_BUCKETS_PER_ROUTE = 1024;
+
+DeltaStepping::DeltaStepping(unsigned num_threads)
+    : num_threads(num_threads), capacity(0), width(0) { }
+
+bool DeltaStepping::find_path(const CSR &csr, const CSR &reverse_csr, int src_id, int dest_id,
+        SearchContext &context) {
+    lock_guard<mutex> guard(lock);
+    context.scan(search(csr, src_id, dest_id));
+    double cost = costs[dest_id].load(memory_order_relaxed);
+    if (cost == INF_COST) {
+        return false;
+    }
+    link(reverse_csr, src_id, cost);
+    context.append_path(csr, predecessor, src_id, dest_id);
+    return true;
+}
+
+shared_ptr<ShortestPathTree> DeltaStepping::build_tree(const CSR &csr, const CSR &reverse_csr,
+        int src_id, SearchContext &context) {
+    lock_guard<mutex> guard(lock);
+    context.scan(search(csr, src_id, -1));
+    link(reverse_csr, src_id, INF_COST);
+
+    shared_ptr<ShortestPathTree> tree(new ShortestPathTree());
+    tree -> src_id = src_id;
+    tree -> costs.resize(csr.num_airports());
+    for (unsigned long i = 0; i < csr.num_airports(); i++) {
+        tree -> costs[i] = costs[i].load(memory_order_relaxed);
+    }
+    tree -> predecessor = predecessor;
+    return tree;
+}
+
+unsigned long DeltaStepping::search(const CSR &csr, int src_id, int dest_id) {
+    unsigned long n = csr.num_airports();
+    if (pool == NULL) {
+        pool.reset(new ThreadPool(num_threads));
+        threads = vector<ThreadBuckets>(pool -> size());
+    }
+    if (width == 0) {
+        width = tune_width(csr);
+    }
+    if (capacity < n) {
+        costs.reset(new atomic<double>[n]);
+        capacity = n;
+    }
+
+    unsigned long num_chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    pool -> parallel_for(num_chunks, [&](unsigned long chunk) {
+        unsigned long end = std::min(n, (chunk + 1) * CHUNK_SIZE);
+        for (unsigned long i = chunk * CHUNK_SIZE; i < end; i++) {
+            costs[i].store(INF_COST, memory_order_relaxed);
+        }
+    });
+    for (ThreadBuckets &thread : threads) {
+        thread.num_scanned = 0;
+    }
+
+    costs[src_id].store(0, memory_order_relaxed);
+    frontier.assign(1, src_id);
+    for (unsigned long bucket = 0; !frontier.empty(); ) {
+        // Airports whose cost fell below the bucket since they were added
+        // were already searched from an earlier bucket.
+        double lowest = bucket * width;
+        pool -> parallel_for((frontier.size() + CHUNK_SIZE - 1) / CHUNK_SIZE,
+                [&](unsigned long chunk, unsigned thread) {
+            ThreadBuckets &local = threads[thread];
+            unsigned long end = std::min(frontier.size(), (chunk + 1) * CHUNK_SIZE);
+            for (unsigned long i = chunk * CHUNK_SIZE; i < end; i++) {
+                int current = frontier[i];
+                double cost = costs[current].load(memory_order_relaxed);
+                if (cost < lowest) {
+                    continue;
+                }
+                local.num_scanned += csr.get_end(current) - csr.get_begin(current);
+
+                for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+                    int next_id = csr.get_dest(e);
+                    double curr_cost = cost + csr.get_weight(e);
+                    double old_cost = costs[next_id].load(memory_order_relaxed);
+                    while (curr_cost < old_cost) {
+                        if (costs[next_id].compare_exchange_weak(old_cost, curr_cost,
+                                memory_order_relaxed)) {
+                            unsigned long index = curr_cost / width;
+                            if (index >= local.buckets.size()) {
+                                local.buckets.resize(index + 1);
+                            }
+                            local.buckets[index].push_back(next_id);
+                            break;
+                        }
+                    }
+                }
+            }
+        });
+
+        // Routes never lower a cost, so the next bucket is the cheapest
+        // non-empty one from the current bucket on.
+        unsigned long next = -1;
+        for (const ThreadBuckets &thread : threads) {
+            for (unsigned long i = bucket; i < thread.buckets.size() && i < next; i++) {
+                if (!thread.buckets[i].empty()) {
+                    next = i;
+                    break;
+                }
+            }
+        }
+        frontier.clear();
+        if (next == (unsigned long)-1) {
+            break;
+        }
+
+        // Every airport still to be searched costs at least the start of
+        // the next bucket, so cheaper destinations are final.
+        if (dest_id != -1 && costs[dest_id].load(memory_order_relaxed) < next * width) {
+            for (ThreadBuckets &thread : threads) {
+                for (vector<int> &airports : thread.buckets) {
+                    airports.clear();
+                }
+            }
+            break;
+        }
+        for (ThreadBuckets &thread : threads) {
+            if (next < thread.buckets.size()) {
+                frontier.insert(frontier.end(), thread.buckets[next].begin(),
+                    thread.buckets[next].end());
+                thread.buckets[next].clear();
+            }
+        }
+        bucket = next;
+    }
+
+    unsigned long num_scanned = 0;
+    for (const ThreadBuckets &thread : threads) {
+        num_scanned += thread.num_scanned;
+    }
+    return num_scanned;
+}
+
+void DeltaStepping::link(const CSR &reverse_csr, int src_id, double limit) {
+    unsigned long n = reverse_csr.num_airports();
+    predecessor.resize(n);
+    for (ThreadBuckets &thread : threads) {
+        thread.pending.clear();
+    }
+
+    // Routes from cheaper airports cannot form a cycle. An airport only
+    // reached at its own cost, over a route costing nothing, waits until
+    // the airport it is reached from has a route of its own.
+    unsigned long num_chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    pool -> parallel_for(num_chunks, [&](unsigned long chunk, unsigned thread) {
+        unsigned long end = std::min(n, (chunk + 1) * CHUNK_SIZE);
+        for (unsigned long i = chunk * CHUNK_SIZE; i < end; i++) {
+            predecessor[i] = NO_ROUTE;
+            double cost = costs[i].load(memory_order_relaxed);
+            if ((int)i == src_id || cost == INF_COST || cost > limit) {
+                continue;
+            }
+
+            double best = INF_COST;
+            unsigned best_route = NO_ROUTE;
+            for (unsigned e = reverse_csr.get_begin(i); e < reverse_csr.get_end(i); e++) {
+                double prev_cost = costs[reverse_csr.get_dest(e)].load(memory_order_relaxed);
+                if (prev_cost + reverse_csr.get_weight(e) == cost && (prev_cost < best ||
+                        (prev_cost == best && reverse_csr.get_forward(e) < best_route))) {
+                    best = prev_cost;
+                    best_route = reverse_csr.get_forward(e);
+                }
+            }
+            if (best < cost) {
+                predecessor[i] = best_route;
+            } else {
+                threads[thread].pending.push_back(i);
+            }
+        }
+    });
+
+    vector<int> pending;
+    for (const ThreadBuckets &thread : threads) {
+        pending.insert(pending.end(), thread.pending.begin(), thread.pending.end());
+    }
+    for (bool progress = true; progress; ) {
+        progress = false;
+        for (int id : pending) {
+            if (predecessor[id] != NO_ROUTE) {
+                continue;
+            }
+            double cost = costs[id].load(memory_order_relaxed);
+            for (unsigned e = reverse_csr.get_begin(id); e < reverse_csr.get_end(id); e++) {
+                int prev_id = reverse_csr.get_dest(e);
+                if ((prev_id == src_id || predecessor[prev_id] != NO_ROUTE) && prev_id != id &&
+                        costs[prev_id].load(memory_order_relaxed) + reverse_csr.get_weight(e) == cost) {
+                    predecessor[id] = reverse_csr.get_forward(e);
+                    progress = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void DeltaStepping::clear() {
+    lock_guard<mutex> guard(lock);
+    width = 0;
+}
+
+double DeltaStepping::get_width() const {
+    return width;
+}
+
+double DeltaStepping::tune_width(const CSR &csr) {
+    vector<double> weights;
+    double max_weight = 0;
+    for (unsigned long u = 0; u < csr.num_airports(); u++) {
+        for (unsigned e = csr.get_begin(u); e < csr.get_end(u); e++) {
+            if (csr.get_weight(e) > 0 && csr.get_weight(e) < INF_COST) {
+                weights.push_back(csr.get_weight(e));
+                max_weight = std::max(max_weight, csr.get_weight(e));
+            }
+        }
+    }
+    if (weights.empty()) {
+        return 1;
+    }
+
+    // With d routes per airport, the cheapest 1/d of the routes, as many
+    // as there are airports, give each airport about one route that stays
+    // within its bucket.
+    unsigned long rank = std::min((unsigned long)weights.size(), csr.num_airports()) - 1;
+    std::nth_element(weights.begin(), weights.begin() + rank, weights.end());
+    return std::max(weights[rank], max_weight / MAX_BUCKETS_PER_ROUTE);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file delta_stepping.h
+ * Definition of parallel delta-stepping shortest-path class.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "csr.h"
+#include "search.h"
+#include "path_cache.h"
+#include "threadpool.h"
+
+using namespace std;
+
+/**
+ * Single-source shortest paths searched by every core together with the
+ * delta-stepping algorithm of Meyer and Sanders.
+ *
+ * Airports are kept in buckets of costs width apart instead of one heap.
+ * All airports of the cheapest bucket relax their routes in parallel,
+ * lowering the costs of their destinations with an atomic compare-and-swap
+ * minimum and adding them to the bucket of their new cost, until the
+ * bucket stays empty and the next one is searched. Each thread keeps its
+ * own buckets, gathered into one frontier per step. The width is tuned
+ * from the route costs: the cost below which an airport has one route on
+ * average, so a bucket needs few steps while holding enough airports to
+ * keep every core busy.
+ *
+ * Incoming routes are chosen once costs are final, as the route from the
+ * cheapest airport reaching each airport at exactly its cost, ties going
+ * to the lowest route index, so paths and trees have the same form as
+ * those of a heap-based search. Where airports of equal cost tie, this
+ * may be another route than the one Dijkstra's Algorithm settles first.
+ * Searches are serialized, since every search already runs on every
+ * thread of the pool.
+ * @author Vaibhav Gupta
+ */
+class DeltaStepping {
+    public:
+        /**
+         * Constructor to create a search, whose threads start on first use.
+         * @param num_threads Number of threads including the caller,
+         * 0 for one per core.
+         */
+        DeltaStepping(unsigned num_threads = 0);
+
+        DeltaStepping(const DeltaStepping &other) = delete;
+        DeltaStepping &operator=(const DeltaStepping &other) = delete;
+
+        /**
+         * Finds a shortest path between two airports and appends its route
+         * indices to the path of a search context. The search stops once
+         * no bucket left can lower the cost of the destination.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph of the same graph.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context to append the path to.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        bool find_path(const CSR &csr, const CSR &reverse_csr, int src_id, int dest_id,
+            SearchContext &context);
+
+        /**
+         * Computes the complete shortest-path tree of a source airport.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph of the same graph.
+         * @param src_id ID of source airport.
+         * @param context Reference to search context to count routes in.
+         * @returns Pointer to shortest-path tree.
+         */
+        shared_ptr<ShortestPathTree> build_tree(const CSR &csr, const CSR &reverse_csr,
+            int src_id, SearchContext &context);
+
+        /**
+         * Forgets the tuned bucket width, which must be tuned again after
+         * the costs of routes change.
+         */
+        void clear();
+
+        /**
+         * Returns the bucket width of the last search.
+         * @returns Width of cost of each bucket, 0 before any search.
+         */
+        double get_width() const;
+
+        /**
+         * Computes the bucket width of a graph from the costs of its routes.
+         * @param csr Reference to CSR graph.
+         * @returns Width of cost of each bucket, greater than 0.
+         */
+        static double tune_width(const CSR &csr);
+
+    private:
+        /**
+         * Buckets filled by one thread, padded to a cache line so the
+         * counters of neighbouring threads do not share one.
+         */
+        struct alignas(64) ThreadBuckets {
+            vector<vector<int>> buckets;
+            vector<int> pending;
+            unsigned long num_scanned = 0;
+        };
+
+        /**
+         * Helper function to compute the cost of every airport from a source.
+         * @param csr Reference to CSR graph.
+         * @param src_id ID of source airport.
+         * @param dest_id ID of destination airport to stop at once its cost
+         * is final, -1 to search every airport.
+         * @returns Number of routes scanned.
+         */
+        unsigned long search(const CSR &csr, int src_id, int dest_id);
+
+        /**
+         * Helper function to choose the incoming route of every airport whose
+         * cost is final, once search() has completed.
+         * @param reverse_csr Reference to reverse CSR graph.
+         * @param src_id ID of source airport.
+         * @param limit Largest cost of airports to choose a route for.
+         */
+        void link(const CSR &reverse_csr, int src_id, double limit);
+
+        unsigned num_threads;
+        unique_ptr<ThreadPool> pool;
+        unique_ptr<atomic<double>[]> costs;
+        unsigned long capacity;
+        vector<unsigned> predecessor;
+        vector<ThreadBuckets> threads;
+        vector<int> frontier;
+        double width;
+        mutex lock;
+};
@@ -0,0 +1,244 @@
+/**
+ * @file disk_apsp.cpp
+ * Implementation of out-of-core all-pairs shortest-path class.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <unistd.h>
+
+#include "disk_apsp.h"
+#include "apsp.h"
+#include "heap.h"
+
+static const char MAGIC[8] = {'A', 'I', 'R', 'A', 'P', 'S', 'P', '\0'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * Header at the start of every table file, padded to a page and followed
+ * by the tiles. A file whose header is not valid yet was never created in
+ * full and is started over.
+ */
+struct DiskAPSPHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    DatasetFingerprint dataset;
+    uint64_t num_airports, num_routes, tile, rounds_done;
+};
+
+DiskAPSP::DiskAPSP() {
+    n = 0;
+    tile = 0;
+    num_tiles = 0;
+    tile_bytes = 0;
+    rounds_done = 0;
+}
+
+bool DiskAPSP::map(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset,
+        bool writable) {
+    close();
+    if (!file.open(file_path, writable) || file.size() < HEADER_BYTES) {
+        file.close();
+        return false;
+    }
+
+    DiskAPSPHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+            header.byte_order != BYTE_ORDER_MARK || !dataset.matches(header.dataset) ||
+            header.num_airports != csr.num_airports() || header.num_routes != csr.num_routes() ||
+            header.tile == 0 || header.tile % 16 != 0) {
+        file.close();
+        return false;
+    }
+
+    n = header.num_airports;
+    tile = header.tile;
+    num_tiles = (n + tile - 1) / tile;
+    tile_bytes = tile * tile * (sizeof(double) + sizeof(int));
+    if (header.rounds_done > num_tiles ||
+            file.size() != HEADER_BYTES + num_tiles * num_tiles * tile_bytes) {
+        file.close();
+        return false;
+    }
+    rounds_done = header.rounds_done;
+    return true;
+}
+
+bool DiskAPSP::create(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset,
+        ThreadPool &pool, unsigned tile) {
+    close();
+    n = csr.num_airports();
+    this -> tile = std::max(16u, (tile + 15) / 16 * 16);
+    num_tiles = (n + this -> tile - 1) / this -> tile;
+    tile_bytes = this -> tile * this -> tile * (sizeof(double) + sizeof(int));
+    rounds_done = 0;
+
+    // The file starts with a blank header and grows to its full size
+    // without writing the tiles, which the mapping fills in.
+    vector<char> blank(HEADER_BYTES, 0);
+    ofstream out(file_path, ios::binary | ios::trunc);
+    out.write(blank.data(), blank.size());
+    out.close();
+    unsigned long size = HEADER_BYTES + num_tiles * num_tiles * tile_bytes;
+    if (!out || truncate(file_path.c_str(), size) != 0 || !file.open(file_path, true)) {
+        return false;
+    }
+
+    char *base = file.get_writable();
+    unsigned long strip_bytes = num_tiles * tile_bytes;
+    atomic<bool> stored(true);
+    pool.parallel_for(num_tiles, [&](unsigned long i) {
+        for (unsigned long j = 0; j < num_tiles; j++) {
+            double *costs = reinterpret_cast<double*>(base + tile_offset(i, j));
+            int *next = reinterpret_cast<int*>(costs + this -> tile * this -> tile);
+            std::fill(costs, costs + this -> tile * this -> tile, INF_COST);
+            std::fill(next, next + this -> tile * this -> tile, -1);
+        }
+
+        unsigned long end = std::min(n, (i + 1) * this -> tile);
+        for (unsigned long src_id = i * this -> tile; src_id < end; src_id++) {
+            unsigned long row = src_id % this -> tile * this -> tile;
+            double *costs = reinterpret_cast<double*>(base + tile_offset(i, i));
+            int *next = reinterpret_cast<int*>(costs + this -> tile * this -> tile);
+            costs[row + src_id % this -> tile] = 0;
+            next[row + src_id % this -> tile] = src_id;
+
+            for (unsigned e = csr.get_begin(src_id); e < csr.get_end(src_id); e++) {
+                int dest_id = csr.get_dest(e);
+                costs = reinterpret_cast<double*>(base + tile_offset(i, dest_id / this -> tile));
+                next = reinterpret_cast<int*>(costs + this -> tile * this -> tile);
+                unsigned long cell = row + dest_id % this -> tile;
+                if (csr.get_weight(e) < costs[cell]) {
+                    costs[cell] = csr.get_weight(e);
+                    next[cell] = dest_id;
+                }
+            }
+        }
+
+        if (!file.sync(tile_offset(i, 0), strip_bytes)) {
+            stored = false;
+        }
+        file.release(tile_offset(i, 0), strip_bytes);
+    });
+
+    // The header is only valid once every tile is stored.
+    DiskAPSPHeader header = DiskAPSPHeader();
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.dataset = dataset;
+    header.num_airports = n;
+    header.num_routes = csr.num_routes();
+    header.tile = this -> tile;
+    header.rounds_done = 0;
+    memcpy(base, &header, sizeof(header));
+    if (!stored || !file.sync(0, HEADER_BYTES)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DiskAPSP::compute(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset,
+        ThreadPool &pool, unsigned long max_rounds, unsigned tile) {
+    if (!map(file_path, csr, dataset, true) && !create(file_path, csr, dataset, pool, tile)) {
+        return false;
+    }
+
+    char *base = file.get_writable();
+    unsigned long area = this -> tile * this -> tile;
+    auto relax = [&](unsigned long ci, unsigned long cj, unsigned long ai,
+            unsigned long aj, unsigned long bi, unsigned long bj) {
+        double *c = reinterpret_cast<double*>(base + tile_offset(ci, cj));
+        const double *a = reinterpret_cast<const double*>(base + tile_offset(ai, aj));
+        const double *b = reinterpret_cast<const double*>(base + tile_offset(bi, bj));
+        relax_tile(c, reinterpret_cast<int*>(c + area), a,
+            reinterpret_cast<const int*>(a + area), b, this -> tile, this -> tile);
+    };
+
+    unsigned long strip_bytes = num_tiles * tile_bytes;
+    unsigned long last = num_tiles - rounds_done > max_rounds ?
+        rounds_done + max_rounds : num_tiles;
+    for (unsigned long k = rounds_done; k < last; k++) {
+        // Phase 1: paths within the diagonal tile.
+        relax(k, k, k, k, k, k);
+
+        // Phase 2: tiles in row k and column k depend only on the diagonal tile.
+        pool.parallel_for(2 * num_tiles, [&](unsigned long idx) {
+            unsigned long other = idx / 2;
+            if (other == k) {
+                return;
+            } else if (idx % 2 == 0) {
+                relax(k, other, k, k, k, other);
+            } else {
+                relax(other, k, other, k, k, k);
+            }
+        });
+
+        // Phase 3: every other tile depends only on its row and column
+        // tiles, so each row of tiles is stored and dropped once relaxed.
+        atomic<bool> stored(true);
+        pool.parallel_for(num_tiles, [&](unsigned long i) {
+            if (i == k) {
+                return;
+            }
+            for (unsigned long j = 0; j < num_tiles; j++) {
+                if (j != k) {
+                    relax(i, j, i, k, k, j);
+                }
+            }
+            if (!file.sync(tile_offset(i, 0), strip_bytes)) {
+                stored = false;
+            }
+            file.release(tile_offset(i, 0), strip_bytes);
+        });
+        if (!stored || !file.sync(tile_offset(k, 0), strip_bytes)) {
+            close();
+            return false;
+        }
+        file.release(tile_offset(k, 0), strip_bytes);
+
+        rounds_done = k + 1;
+        reinterpret_cast<DiskAPSPHeader*>(base) -> rounds_done = rounds_done;
+        if (!file.sync(0, HEADER_BYTES)) {
+            close();
+            return false;
+        }
+    }
+
+    if (rounds_done < num_tiles) {
+        close();
+        return false;
+    }
+    return open(file_path, csr, dataset);
+}
+
+bool DiskAPSP::open(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset) {
+    if (!map(file_path, csr, dataset, false) || rounds_done < num_tiles) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void DiskAPSP::close() {
+    file.close();
+}
+
+bool DiskAPSP::empty() const {
+    return file.data() == NULL;
+}
+
+pair<unsigned long, unsigned long> DiskAPSP::get_progress() const {
+    return {rounds_done, num_tiles};
+}
+
+unsigned long DiskAPSP::bytes() const {
+    return file.size();
+}
@@ -0,0 +1,174 @@
+/**
+ * @file disk_apsp.h
+ * Definition of out-of-core all-pairs shortest-path class.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "csr.h"
+#include "mapped_file.h"
+#include "snapshot.h"
+#include "threadpool.h"
+
+using namespace std;
+
+/**
+ * All-pairs shortest paths whose distance and next-airport matrices live
+ * in a memory-mapped file instead of memory, for networks whose matrices
+ * do not fit in RAM.
+ *
+ * The file holds a header followed by the tiles of the matrices in row
+ * order, each the costs of a square of airport pairs followed by their
+ * next airports, so every tile is contiguous on disk. The blocked
+ * Floyd-Warshall algorithm of apsp.h runs on the mapped tiles one round
+ * per diagonal tile, with each thread relaxing a row of tiles against the
+ * row and column of the diagonal tile. Finished rows of tiles are written
+ * back and dropped from memory, so only the row and column of the round
+ * and one row per thread stay mapped in memory at a time.
+ *
+ * The header records the number of completed rounds once the tiles of
+ * each round are stored. A computation that is interrupted resumes from
+ * the first round not recorded, which is safe to run again since rounds
+ * only ever lower costs. Once every round is complete, the file is opened
+ * read-only and the cost between any two airports is read from its tile
+ * directly.
+ * @author Vaibhav Gupta
+ */
+class DiskAPSP {
+    public:
+        // Version of the file layout, increased on every incompatible change.
+        static const uint32_t VERSION = 2;
+
+        // Constructor to create an empty table.
+        DiskAPSP();
+
+        DiskAPSP(const DiskAPSP &other) = delete;
+        DiskAPSP &operator=(const DiskAPSP &other) = delete;
+
+        /**
+         * Computes the shortest paths of a graph into a file, continuing
+         * the rounds of a file left incomplete for the same graph and
+         * dataset, or starting over otherwise. The table is then opened.
+         * @param file_path File path to write.
+         * @param csr Reference to CSR graph.
+         * @param dataset Fingerprint of the dataset the graph was read from.
+         * @param pool Reference to thread pool to relax tiles on.
+         * @param max_rounds Maximum number of rounds to run before returning,
+         * leaving the file to be resumed.
+         * @param tile Side length of a tile, rounded up to a multiple of 16.
+         * @returns Boolean representing if every round is complete or not.
+         */
+        bool compute(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset,
+            ThreadPool &pool, unsigned long max_rounds = -1, unsigned tile = 64);
+
+        /**
+         * Maps a complete file written by compute() read-only, rejecting
+         * files of another graph or dataset.
+         * @param file_path File path to read.
+         * @param csr Reference to CSR graph the table must match.
+         * @param dataset Fingerprint the table must have been written from,
+         * or an empty fingerprint to accept any dataset.
+         * @returns Boolean representing if the file was opened or not.
+         */
+        bool open(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset);
+
+        /**
+         * Unmaps the table, which must be computed again after the graph
+         * changes.
+         */
+        void close();
+
+        /**
+         * Returns if no complete table is open.
+         * @returns Boolean representing if table is empty or not.
+         */
+        bool empty() const;
+
+        /**
+         * Returns the cost of the shortest path between two airports.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @returns Cost of shortest path, INF_COST if unreachable.
+         */
+        double get(int src_id, int dest_id) const;
+
+        /**
+         * Returns the next airport on the shortest path between two airports.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @returns ID of next airport, -1 if unreachable.
+         */
+        int get_next(int src_id, int dest_id) const;
+
+        /**
+         * Returns the number of rounds of the last computation, one per
+         * diagonal tile.
+         * @returns Number of completed and total rounds.
+         */
+        pair<unsigned long, unsigned long> get_progress() const;
+
+        /**
+         * Returns the size of the open file.
+         * @returns Number of bytes.
+         */
+        unsigned long bytes() const;
+
+    private:
+        // Bytes before the first tile, a whole page so tiles are aligned.
+        static const unsigned long HEADER_BYTES = 4096;
+
+        /**
+         * Helper function to map a file and check its header against a graph.
+         * @param file_path File path to map.
+         * @param csr Reference to CSR graph the file must match.
+         * @param dataset Fingerprint the file must have been written from.
+         * @param writable Whether to map the file for writing.
+         * @returns Boolean representing if the file matches or not.
+         */
+        bool map(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset,
+            bool writable);
+
+        /**
+         * Helper function to create a file with the routes of a graph and
+         * no completed rounds.
+         * @param file_path File path to write.
+         * @param csr Reference to CSR graph.
+         * @param dataset Fingerprint of the dataset the graph was read from.
+         * @param pool Reference to thread pool to fill tiles on.
+         * @param tile Side length of a tile.
+         * @returns Boolean representing if the file was created or not.
+         */
+        bool create(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset,
+            ThreadPool &pool, unsigned tile);
+
+        /**
+         * Helper function to return the offset of a tile in the file.
+         * @param row Tile row.
+         * @param col Tile column.
+         * @returns Offset of the first cost of the tile.
+         */
+        unsigned long tile_offset(unsigned long row, unsigned long col) const;
+
+        MappedFile file;
+        unsigned long n, tile, num_tiles, tile_bytes;
+        unsigned long rounds_done;
+};
+
+inline unsigned long DiskAPSP::tile_offset(unsigned long row, unsigned long col) const {
+    return HEADER_BYTES + (row * num_tiles + col) * tile_bytes;
+}
+
+inline double DiskAPSP::get(int src_id, int dest_id) const {
+    const double *costs = reinterpret_cast<const double*>(file.data() +
+        tile_offset(src_id / tile, dest_id / tile));
+    return costs[src_id % tile * tile + dest_id % tile];
+}
+
+inline int DiskAPSP::get_next(int src_id, int dest_id) const {
+    const int *next = reinterpret_cast<const int*>(file.data() +
+        tile_offset(src_id / tile, dest_id / tile) + tile * tile * sizeof(double));
+    return next[src_id % tile * tile + dest_id % tile];
+}
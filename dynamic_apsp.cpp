@@ -0,0 +1,149 @@
+/**
+ * @file dynamic_apsp.cpp
+ * Implementation of dynamic all-pairs shortest-path class.
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include "dynamic_apsp.h"
+
+void DynamicAPSP::build(const CSR &csr, const CSR &reverse_csr) {
+    n = csr.num_airports();
+    num_searches = 0;
+    costs.assign(n * n, INF_COST);
+    dependencies.assign(n * n, 0);
+    if (pool == NULL) {
+        pool.reset(new ThreadPool());
+        scratch.resize(pool -> size());
+    }
+
+    vector<int> sources(n);
+    std::iota(sources.begin(), sources.end(), 0);
+    search_all(csr, reverse_csr, sources);
+}
+
+void DynamicAPSP::clear() {
+    n = 0;
+    costs.clear();
+    dependencies.clear();
+}
+
+bool DynamicAPSP::empty() const {
+    return costs.empty();
+}
+
+unsigned long DynamicAPSP::update(const CSR &csr, const CSR &reverse_csr, int src_id,
+        int dest_id, double old_weight, double new_weight) {
+    vector<int> sources;
+    for (unsigned long s = 0; s < n; s++) {
+        double to_src = get(s, src_id), to_dest = get(s, dest_id);
+        if (to_src == INF_COST) {
+            continue;
+        }
+
+        // Cheaper routes can shorten paths or add equally short ones, while
+        // more expensive routes only matter when they were on a shortest path.
+        if ((new_weight < old_weight && to_src + new_weight <= to_dest) ||
+                (new_weight > old_weight && to_src + old_weight == to_dest)) {
+            sources.push_back(s);
+        }
+    }
+    search_all(csr, reverse_csr, sources);
+    num_searches += sources.size();
+    return sources.size();
+}
+
+vector<double> DynamicAPSP::get_centralities() const {
+    vector<unsigned long> reaching(n, 0), reachable(n, 0);
+    vector<double> paths(n, 0);
+    unsigned long total_unique = 0;
+    for (unsigned long s = 0; s < n; s++) {
+        for (unsigned long t = 0; t < n; t++) {
+            if (t != s && get(s, t) != INF_COST) {
+                reachable[s]++;
+                reaching[t]++;
+                total_unique++;
+            }
+            paths[t] += dependencies[s * n + t];
+        }
+    }
+
+    // Pairs that start or end at the airport itself are excluded.
+    vector<double> centralities(n);
+    for (unsigned long i = 0; i < n; i++) {
+        unsigned long possible_paths = total_unique - reaching[i] - reachable[i];
+        centralities[i] = possible_paths > 0 ? paths[i] / possible_paths : 0;
+    }
+    return centralities;
+}
+
+unsigned long DynamicAPSP::get_num_searches() const {
+    return num_searches;
+}
+
+void DynamicAPSP::search(const CSR &csr, const CSR &reverse_csr, int src_id,
+        Scratch &scratch) {
+    Heap &heap = scratch.heap;
+    vector<double> &num_paths = scratch.num_paths;
+    vector<int> &order = scratch.order;
+    heap.reset(n, src_id);
+    order.clear();
+
+    while (!heap.empty()) {
+        int current = heap.pop();
+        order.push_back(current);
+
+        double cost = heap.get_cost(current);
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int dest_id = csr.get_dest(e);
+            double curr_cost = cost + csr.get_weight(e);
+            if (curr_cost < heap.get_cost(dest_id)) {
+                heap.update(dest_id, curr_cost);
+            }
+        }
+    }
+
+    double *cost_row = &costs[src_id * n];
+    double *dependency = &dependencies[src_id * n];
+    scratch.costs.resize(n);
+    for (unsigned long i = 0; i < n; i++) {
+        cost_row[i] = scratch.costs[i] = heap.get_cost(i);
+        dependency[i] = 0;
+    }
+
+    // Paths are counted as in Graph::brandes_source(), in the order airports
+    // were settled with ties along zero-cost routes broken by PathOrder.
+    scratch.path_order.sort(csr, reverse_csr, scratch.costs, src_id, order);
+    num_paths.assign(n, 0);
+    num_paths[src_id] = 1;
+    for (int current : order) {
+        for (unsigned e = reverse_csr.get_begin(current); e < reverse_csr.get_end(current); e++) {
+            int prev_id = reverse_csr.get_dest(e);
+            if (cost_row[prev_id] + reverse_csr.get_weight(e) == cost_row[current] &&
+                    scratch.path_order.precedes(prev_id, current)) {
+                num_paths[current] += num_paths[prev_id];
+            }
+        }
+    }
+
+    // Same back-propagation as Graph::brandes_source(), farthest first.
+    for (long i = (long)order.size() - 1; i > 0; i--) {
+        int current = order[i];
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int dest_id = csr.get_dest(e);
+            if (cost_row[current] + csr.get_weight(e) == cost_row[dest_id] &&
+                    scratch.path_order.precedes(current, dest_id)) {
+                dependency[current] += num_paths[current] / num_paths[dest_id] *
+                    (1 + dependency[dest_id]);
+            }
+        }
+    }
+}
+
+void DynamicAPSP::search_all(const CSR &csr, const CSR &reverse_csr,
+        const vector<int> &sources) {
+    pool -> parallel_for(sources.size(), [&](unsigned long i, unsigned thread) {
+        search(csr, reverse_csr, sources[i], scratch[thread]);
+    });
+}
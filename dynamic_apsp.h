@@ -0,0 +1,132 @@
+/**
+ * @file dynamic_apsp.h
+ * Definition of dynamic all-pairs shortest-path class.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "heap.h"
+#include "csr.h"
+#include "path_order.h"
+#include "threadpool.h"
+
+using namespace std;
+
+/**
+ * All-pairs shortest-path costs and betweenness centrality kept up to
+ * date while routes are inserted, removed and repriced.
+ *
+ * Every source airport keeps its row of shortest-path costs and its row
+ * of Brandes path dependencies. When a route from u to v changes, the rows
+ * of the current costs decide which sources can be affected: a cheaper
+ * route matters to source s only if d(s, u) + w <= d(s, v), and a more
+ * expensive or removed route only if it was on a shortest path from s,
+ * that is d(s, u) + w = d(s, v). Only those sources are searched again, in
+ * parallel, and all other rows are kept.
+ * @author Vaibhav Gupta
+ */
+class DynamicAPSP {
+    public:
+        /**
+         * Searches from every airport of a graph, replacing any previous
+         * costs and dependencies.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph of the same graph.
+         */
+        void build(const CSR &csr, const CSR &reverse_csr);
+
+        /**
+         * Removes all costs and dependencies, which are no longer maintained.
+         */
+        void clear();
+
+        /**
+         * Returns if nothing has been built.
+         * @returns Boolean representing if the rows are empty or not.
+         */
+        bool empty() const;
+
+        /**
+         * Updates the rows after the cost of one route changed, searching
+         * again from every source that may be affected.
+         * @param csr Reference to CSR graph that already contains the change.
+         * @param reverse_csr Reference to reverse CSR graph of the same graph.
+         * @param src_id ID of source airport of the route.
+         * @param dest_id ID of destination airport of the route.
+         * @param old_weight Cost of the route before the change, INF_COST
+         * if it was inserted.
+         * @param new_weight Cost of the route after the change, INF_COST if
+         * it was removed.
+         * @returns Number of sources searched again.
+         */
+        unsigned long update(const CSR &csr, const CSR &reverse_csr, int src_id, int dest_id,
+            double old_weight, double new_weight);
+
+        /**
+         * Returns cost of the shortest path between two airports.
+         * @param src_id ID of source airport.
+         * @param dest_id ID of destination airport.
+         * @returns Cost of shortest path, INF_COST if unreachable.
+         */
+        double get(int src_id, int dest_id) const;
+
+        /**
+         * Computes the betweenness centrality of every airport from the
+         * current dependencies, as Graph::brandes() would from scratch.
+         * @returns Vector representing the betweenness centrality of each airport.
+         */
+        vector<double> get_centralities() const;
+
+        /**
+         * Returns the number of single-source searches run since the rows
+         * were last built, excluding the build itself.
+         * @returns Number of sources searched again.
+         */
+        unsigned long get_num_searches() const;
+
+    private:
+        /**
+         * Search state reused by one thread.
+         */
+        struct Scratch {
+            Heap heap;
+            vector<double> costs, num_paths;
+            vector<int> order;
+            PathOrder path_order;
+        };
+
+        /**
+         * Helper function to search from one source airport and overwrite
+         * its rows of costs and dependencies.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph.
+         * @param src_id ID of source airport.
+         * @param scratch Reference to search state of the calling thread.
+         */
+        void search(const CSR &csr, const CSR &reverse_csr, int src_id, Scratch &scratch);
+
+        /**
+         * Helper function to search again from a set of sources in parallel.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph.
+         * @param sources Reference to vector of source airport IDs.
+         */
+        void search_all(const CSR &csr, const CSR &reverse_csr, const vector<int> &sources);
+
+        unsigned long n = 0;
+        unsigned long num_searches = 0;
+
+        // Row-major n x n costs and dependencies, one row per source.
+        vector<double> costs;
+        vector<double> dependencies;
+
+        unique_ptr<ThreadPool> pool;
+        vector<Scratch> scratch;
+};
+
+inline double DynamicAPSP::get(int src_id, int dest_id) const {
+    return costs[src_id * n + dest_id];
+}
@@ -0,0 +1,121 @@
+/**
+ * @file forest.cpp
+ * Implementation of minimum spanning forest class.
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include "forest.h"
+
+// Routes scanned by one task, large enough to amortize claiming it.
+static const unsigned long ROUTE_BLOCK = 1024;
+
+void SpanningForest::build(const CSR &csr, ThreadPool &pool) {
+    unsigned long n = csr.num_airports();
+    routes.clear();
+    components.clear();
+    component.resize(n);
+    std::iota(component.begin(), component.end(), 0);
+
+    vector<unsigned> candidates;
+    for (unsigned e = 0; e < csr.num_routes(); e++) {
+        if (csr.get_src(e) != csr.get_dest(e)) {
+            candidates.push_back(e);
+        }
+    }
+
+    // Orders routes by cost, then by index so that no two routes tie.
+    auto cheaper = [&](unsigned a, unsigned b) {
+        return b == NO_ROUTE || csr.get_weight(a) < csr.get_weight(b) ||
+            (csr.get_weight(a) == csr.get_weight(b) && a < b);
+    };
+
+    vector<vector<unsigned>> local(pool.size(), vector<unsigned>(n, NO_ROUTE));
+    vector<unsigned> cheapest(n);
+    vector<unsigned> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](unsigned id) {
+        while (parent[id] != id) {
+            parent[id] = parent[parent[id]];
+            id = parent[id];
+        }
+        return id;
+    };
+
+    while (!candidates.empty()) {
+        unsigned long num_blocks = (candidates.size() + ROUTE_BLOCK - 1) / ROUTE_BLOCK;
+        pool.parallel_for(num_blocks, [&](unsigned long block, unsigned thread) {
+            vector<unsigned> &best = local[thread];
+            unsigned long end = std::min(candidates.size(), (block + 1) * ROUTE_BLOCK);
+            for (unsigned long i = block * ROUTE_BLOCK; i < end; i++) {
+                unsigned e = candidates[i];
+                unsigned a = component[csr.get_src(e)], b = component[csr.get_dest(e)];
+                if (cheaper(e, best[a])) {
+                    best[a] = e;
+                }
+                if (cheaper(e, best[b])) {
+                    best[b] = e;
+                }
+            }
+        });
+
+        pool.parallel_for(n, [&](unsigned long c) {
+            cheapest[c] = NO_ROUTE;
+            for (vector<unsigned> &best : local) {
+                if (best[c] != NO_ROUTE && cheaper(best[c], cheapest[c])) {
+                    cheapest[c] = best[c];
+                }
+                best[c] = NO_ROUTE;
+            }
+        });
+
+        // Two components choosing the same route are only joined once.
+        for (unsigned long c = 0; c < n; c++) {
+            if (cheapest[c] != NO_ROUTE) {
+                unsigned a = find(csr.get_src(cheapest[c])), b = find(csr.get_dest(cheapest[c]));
+                if (a != b) {
+                    parent[std::max(a, b)] = std::min(a, b);
+                    routes.push_back(cheapest[c]);
+                }
+            }
+        }
+
+        for (unsigned long id = 0; id < n; id++) {
+            component[id] = find(id);
+        }
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](unsigned e) {
+            return component[csr.get_src(e)] == component[csr.get_dest(e)];
+        }), candidates.end());
+    }
+
+    // Roots are the smallest airport ID of their component, so components
+    // are numbered in order of their root.
+    vector<unsigned> index(n);
+    for (unsigned long id = 0; id < n; id++) {
+        if (component[id] == id) {
+            index[id] = components.size();
+            components.push_back(ForestComponent());
+            components.back().root_id = id;
+        }
+        component[id] = index[component[id]];
+        components[component[id]].num_airports++;
+    }
+    for (unsigned e : routes) {
+        ForestComponent &tree = components[component[csr.get_src(e)]];
+        tree.num_routes++;
+        tree.cost += csr.get_weight(e);
+    }
+}
+
+const vector<unsigned> &SpanningForest::get_routes() const {
+    return routes;
+}
+
+const vector<ForestComponent> &SpanningForest::get_components() const {
+    return components;
+}
+
+unsigned SpanningForest::get_component(int id) const {
+    return component[id];
+}
@@ -0,0 +1,75 @@
+/**
+ * @file forest.h
+ * Definition of minimum spanning forest class.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "csr.h"
+#include "threadpool.h"
+
+using namespace std;
+
+/**
+ * Summary of one tree of a minimum spanning forest.
+ */
+struct ForestComponent {
+    // Smallest airport ID in the component.
+    int root_id = -1;
+
+    unsigned long num_airports = 0;
+    unsigned long num_routes = 0;
+
+    // Total cost of the routes of the tree.
+    double cost = 0;
+};
+
+/**
+ * Minimum spanning forest of the route network built with Borůvka's
+ * Algorithm, treating every route as connecting its two airports in
+ * either direction so that every component gets its own tree.
+ *
+ * Each round, threads scan their share of the remaining routes for the
+ * cheapest route leaving every component, the per-thread candidates are
+ * merged, and components joined by the chosen routes are contracted. The
+ * number of components at least halves every round, and routes within a
+ * component are dropped as they go. Ties are broken by route index, so
+ * the forest is the same for any number of threads.
+ * @author Vaibhav Gupta
+ */
+class SpanningForest {
+    public:
+        /**
+         * Builds the forest of a graph, replacing any previous forest.
+         * @param csr Reference to CSR graph.
+         * @param pool Reference to thread pool to scan routes on.
+         */
+        void build(const CSR &csr, ThreadPool &pool);
+
+        /**
+         * Returns the routes of the forest in the order they were added.
+         * @returns Reference to vector of route indices.
+         */
+        const vector<unsigned> &get_routes() const;
+
+        /**
+         * Returns the trees of the forest in order of their smallest
+         * airport ID, including airports without routes as single trees.
+         * @returns Reference to vector of components.
+         */
+        const vector<ForestComponent> &get_components() const;
+
+        /**
+         * Returns the component of an airport.
+         * @param id Airport ID.
+         * @returns Index into get_components().
+         */
+        unsigned get_component(int id) const;
+
+    private:
+        vector<unsigned> routes;
+        vector<ForestComponent> components;
+        vector<unsigned> component;
+};
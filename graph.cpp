@@ -11,261 +11,1220 @@
 #include <fstream>
 #include <iostream>
 #include <chrono>
+#include <limits>
+#include <thread>
+#include <atomic>
 
-Graph::~Graph() {
-    for (Airport *airport : airports) {
-        delete airport;
-    }
+Graph::Graph() {
+    heap_type = HeapType::QUATERNARY;
+    search_type = SearchType::DIJKSTRA;
+    csr_stale = true;
+    topology_stale = true;
+    log = &cout;
 }
 
 void Graph::initialize() {
+    const string airports_path = "data/airports.csv";
+    const string routes_path = "data/routes.csv";
+    const string snapshot_path = "data/graph.snapshot";
+    const string landmarks_path = "data/graph.landmarks";
+    const string labels_path = "data/graph.labels";
+    const string apsp_path = "data/graph.apsp";
+
     auto start = chrono::steady_clock::now();
-    int num_airports = read_airports("data/airports.csv");
-    int num_routes = read_routes("data/routes.csv");
+    DatasetFingerprint dataset = DatasetFingerprint::of(airports_path, routes_path);
+    bool from_snapshot = load_snapshot(snapshot_path, dataset);
+    if (!from_snapshot) {
+        read_airports(airports_path);
+        read_routes(routes_path);
+        get_csr();
+    }
     auto end = chrono::steady_clock::now();
 
     auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
-    cout << "Generated graph in " << time << "ms" << endl;
-    cout << "Loaded " << num_airports << " nodes, " << num_routes 
-        << " edges" << endl << flush;
+    get_log() << "Generated graph in " << time << "ms";
+    if (from_snapshot) {
+        get_log() << " from " << snapshot_path;
+    } else if (save_snapshot(snapshot_path, dataset)) {
+        get_log() << ", saved snapshot to " << snapshot_path;
+    }
+    get_log() << endl << "Loaded " << csr.num_airports() << " nodes, " << csr.num_routes() 
+        << " edges" << endl;
+    get_log() << "Found " << reachability.num_components() << " strongly connected components, "
+        << "largest with " << reachability.largest_component() << " nodes" << endl;
+    if (load_landmarks(landmarks_path, dataset)) {
+        get_log() << "Loaded " << landmarks.get_landmarks().size() << " landmarks from " 
+            << landmarks_path << endl;
+    }
+    if (load_hub_labels(labels_path, dataset)) {
+        get_log() << "Loaded " << hub_labels.num_entries() << " hub label entries from " 
+            << labels_path << endl;
+    }
+    if (load_disk_apsp(apsp_path, dataset)) {
+        get_log() << "Loaded " << disk_apsp.bytes() / 1024 << " KB all-pairs table from "
+            << apsp_path << endl;
+    }
+    get_log() << flush;
+}
+
+bool Graph::load_snapshot(const string &file_path, const DatasetFingerprint &dataset) {
+    PhaseTimer timer(metrics, "load_snapshot");
+    unique_ptr<Snapshot> mapped(new Snapshot());
+    if (!airports.empty() || !mapped -> open(file_path) || 
+            !dataset.matches(mapped -> get_dataset())) {
+        return false;
+    }
+
+    // Names and cities are views of the mapped string table, which stays
+    // mapped for the lifetime of the graph. Empty slots of malformed rows
+    // are stored without a name, which every airport read has.
+    for (unsigned long i = 0; i < mapped -> num_airports(); i++) {
+        if (mapped -> get_name(i).empty()) {
+            insert_airport(NULL);
+        } else {
+            insert_airport(airport_arena.create(i, mapped -> get_name(i), mapped -> get_city(i)));
+        }
+    }
+    for (unsigned long i = 0; i < mapped -> num_airlines(); i++) {
+        airlines.intern(mapped -> get_airline_name(i));
+    }
+
+    // Route objects are only created for presenting results, the
+    // algorithms read the mapped arrays directly.
+    const unsigned *offsets = mapped -> get_offsets();
+    const int *srcs = mapped -> get_srcs(), *dests = mapped -> get_dests();
+    const int *airline_ids = mapped -> get_airline_ids();
+    const double *weights = mapped -> get_weights();
+    vector<unsigned> num_incoming(airports.size(), 0);
+    for (unsigned long e = 0; e < mapped -> num_routes(); e++) {
+        num_incoming[dests[e]]++;
+    }
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        if (airports[i] != NULL) {
+            airports[i] -> reserve_routes(offsets[i + 1] - offsets[i], num_incoming[i]);
+        }
+    }
+
+    vector<Route*> routes(mapped -> num_routes());
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        for (unsigned e = offsets[i]; e < offsets[i + 1]; e++) {
+            routes[e] = route_arena.create(airports[i], airports[dests[e]], 
+                airlines.get_name(airline_ids[e]), airline_ids[e], weights[e]);
+            airports[i] -> add_route(routes[e]);
+            airports[dests[e]] -> add_incoming_route(routes[e]);
+        }
+    }
+
+    csr.attach(mapped -> num_airports(), mapped -> num_routes(), offsets, 
+        srcs, dests, weights, airline_ids, airlines.get_names(), routes);
+    reverse_csr.build_reverse(csr);
+    name_index.build(airports);
+    reachability.build(csr);
+    csr_stale = false;
+    topology_stale = false;
+    path_cache.clear();
+    landmarks.clear();
+    hierarchy.clear();
+    hub_labels.clear();
+    disk_apsp.close();
+    delta_stepping.clear();
+    dynamic_apsp.clear();
+    snapshot = std::move(mapped);
+    return true;
+}
+
+bool Graph::save_snapshot(const string &file_path, const DatasetFingerprint &dataset) const {
+    return Snapshot::write(file_path, get_csr(), airports, dataset);
 }
 
 int Graph::read_airports(const string &file_path) {
-    string name, city;
-    ifstream file(file_path);
+    PhaseTimer timer(metrics, "read_airports");
+    ThreadPool pool;
+    CSVReader reader;
+    if (!reader.open(file_path, pool.size())) {
+        cerr << "Could not read " << file_path << endl;
+        return 0;
+    }
+
+    /**
+     * Fields of a valid row, whose name and city are views of the file.
+     */
+    struct AirportRow {
+        unsigned long line;
+        string_view name, city;
+    };
 
-    int airport_id = 0;
-    while (std::getline(file, name, ',')) {
-        name.erase(std::remove(name.begin(), name.end(), '\n'), name.end());
-        std::getline(file, city, ',');
+    // The ID of an airport is the line of its row, which routes refer to,
+    // so IDs are assigned after parsing.
+    vector<vector<AirportRow>> chunks(reader.num_chunks());
+    vector<vector<CSVError>> errors(reader.num_chunks());
+    reader.for_each_row(pool, [&](unsigned long chunk, const CSVRow &row) {
+        // Rows end with a comma, leaving an empty trailing field.
+        if (row.num_fields < 2 || row.fields[0].empty() || 
+                (row.num_fields > 2 && !(row.num_fields == 3 && row.fields[2].empty()))) {
+            errors[chunk].push_back({row.line, "expected airport name and city"});
+        } else {
+            chunks[chunk].push_back({row.line, row.fields[0], row.fields[1]});
+        }
+    });
+
+    // Malformed and blank rows keep their IDs as empty slots, so the
+    // airports after them are not renumbered.
+    vector<char> malformed;
+    for (const vector<CSVError> &chunk : errors) {
+        for (const CSVError &error : chunk) {
+            malformed.resize(std::max(malformed.size(), error.line), false);
+            malformed[error.line - 1] = true;
+        }
+    }
+    unsigned long first_id = airports.size();
+    vector<CSVError> blank;
+    auto skip_to = [&](unsigned long line) {
+        while (airports.size() < first_id + line - 1) {
+            unsigned long empty_line = airports.size() - first_id + 1;
+            if (empty_line > malformed.size() || !malformed[empty_line - 1]) {
+                blank.push_back({empty_line, "expected airport name and city"});
+            }
+            insert_airport(NULL);
+        }
+    };
 
-        insert_airport(new Airport(airport_id, name, city));
-        airport_id++;
+    int num_airports = 0;
+    for (const vector<AirportRow> &chunk : chunks) {
+        for (const AirportRow &row : chunk) {
+            skip_to(row.line);
+            create_airport(row.name, row.city);
+            num_airports++;
+        }
     }
-    file.close();
-    return airport_id;
+    skip_to(malformed.size() + 1);
+    errors.push_back(blank);
+    report_errors(file_path, errors);
+    return num_airports;
 }
 
 int Graph::read_routes(const string &file_path) {
-    string src_id, dest_id, label, weight;
-    ifstream file(file_path);
+    PhaseTimer timer(metrics, "read_routes");
+    ThreadPool pool;
+    CSVReader reader;
+    if (!reader.open(file_path, pool.size())) {
+        cerr << "Could not read " << file_path << endl;
+        return 0;
+    }
 
-    int routes = 0;
-    while (std::getline(file, src_id, ',')) {
-        std::getline(file, dest_id, ',');
-        std::getline(file, label, ',');
-        std::getline(file, weight, ',');
+    /**
+     * Fields of a valid row, whose airline is a view of the file.
+     */
+    struct RouteRow {
+        int src_id, dest_id;
+        string_view airline;
+        double weight;
+    };
+
+    // Rows are parsed in parallel, then routes are created and attached to
+    // airports in file order, interning each airline name.
+    vector<vector<RouteRow>> chunks(reader.num_chunks());
+    vector<vector<CSVError>> errors(reader.num_chunks());
+    reader.for_each_row(pool, [&](unsigned long chunk, const CSVRow &row) {
+        int src_id, dest_id;
+        double weight;
+        if (row.num_fields < 4 || 
+                (row.num_fields > 4 && !(row.num_fields == 5 && row.fields[4].empty()))) {
+            errors[chunk].push_back({row.line, "expected source, destination, airline and cost"});
+        } else if (!CSVReader::parse_int(row.fields[0], src_id) || get_airport(src_id) == NULL) {
+            errors[chunk].push_back({row.line, "invalid source airport ID '" + 
+                string(row.fields[0]) + "'"});
+        } else if (!CSVReader::parse_int(row.fields[1], dest_id) || get_airport(dest_id) == NULL) {
+            errors[chunk].push_back({row.line, "invalid destination airport ID '" + 
+                string(row.fields[1]) + "'"});
+        } else if (!CSVReader::parse_double(row.fields[3], weight) || !(weight >= 0) || 
+                weight == INF_COST) {
+            errors[chunk].push_back({row.line, "invalid cost '" + string(row.fields[3]) + "'"});
+        } else {
+            chunks[chunk].push_back({src_id, dest_id, row.fields[2], weight});
+        }
+    });
 
-        Airport * src = airports[std::stoi(src_id)];
-        Airport * dest = airports[std::stoi(dest_id)];
-        insert_route(new Route(src, dest, label, std::stod(weight)));
-        routes++;
+    vector<unsigned long> num_routes(airports.size(), 0), num_incoming(airports.size(), 0);
+    for (const vector<RouteRow> &chunk : chunks) {
+        for (const RouteRow &row : chunk) {
+            num_routes[row.src_id]++;
+            num_incoming[row.dest_id]++;
+        }
     }
-    file.close();
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        if (airports[i] != NULL) {
+            airports[i] -> reserve_routes(airports[i] -> get_routes().size() + num_routes[i],
+                airports[i] -> get_incoming_routes().size() + num_incoming[i]);
+        }
+    }
+
+    int routes = 0;
+    for (const vector<RouteRow> &chunk : chunks) {
+        for (const RouteRow &row : chunk) {
+            create_route(row.src_id, row.dest_id, row.airline, row.weight);
+            routes++;
+        }
+    }
+    report_errors(file_path, errors);
     return routes;
 }
 
-vector<Route*> Graph::dijkstra(const vector<int> &dest_ids) const {
+void Graph::report_errors(const string &file_path, const vector<vector<CSVError>> &errors) {
+    const unsigned long max_reported = 10;
+
+    unsigned long count = 0;
+    for (const vector<CSVError> &chunk : errors) {
+        for (const CSVError &error : chunk) {
+            if (count < max_reported) {
+                cerr << file_path << ":" << error.line << ": " << error.message << endl;
+            }
+            count++;
+        }
+    }
+    if (count > max_reported) {
+        cerr << file_path << ": " << count - max_reported << " more malformed row(s)" << endl;
+    }
+    if (count > 0) {
+        cerr << "Skipped " << count << " malformed row(s) in " << file_path << endl;
+    }
+}
+
+vector<Route*> Graph::dijkstra(const vector<int> &dest_ids, unsigned long *num_legs) const {
     auto start = chrono::steady_clock::now();
 
+    // Reused by every search on this thread, so repeated queries do not
+    // reallocate the search state.
+    thread_local SearchContext context;
+    shortest_path(dest_ids, context, num_legs);
+
+    const CSR &csr = get_csr();
     vector<Route*> path;
-    for (unsigned long i = 0; i < dest_ids.size() - 1; i++) {
-        int src_id = dest_ids[i], dest_id = dest_ids[i + 1];
+    for (unsigned route : context.get_path()) {
+        path.push_back(csr.get_route(route));
+    }
 
-        Heap heap(airports.size(), src_id);
-        vector<Route*> predecessor(airports.size(), NULL);
+    auto end = chrono::steady_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << endl << "Completed Dijkstra's Algorithm in " << time << "ms" << endl;
+    return path;
+}
 
-        Graph spt;
-        spt.airports.resize(airports.size(), NULL);
-        
-        int current = -1;
-        while (current != dest_id) {
-            current = heap.pop();
-            if (heap.get_cost(current) == INT_MAX) {
-                break;
+bool Graph::shortest_path(const vector<int> &dest_ids, SearchContext &context,
+        unsigned long *num_legs) const {
+    // Rebuilt first if the graph changed, which also empties the path cache.
+    get_csr();
+
+    PhaseTimer timer(metrics, "shortest_path");
+    unsigned long settled = 0, scanned = 0;
+    HeapCounters heap;
+    if (timer.active()) {
+        settled = context.get_num_settled();
+        scanned = context.get_num_scanned();
+        heap = context.get_heap_counters();
+    }
+
+    bool found = true;
+    unsigned long legs = 0;
+    context.clear_path();
+    while (found && legs + 1 < dest_ids.size()) {
+        found = find_leg(dest_ids[legs], dest_ids[legs + 1], context);
+        if (found) {
+            legs++;
+        }
+    }
+    if (num_legs != NULL) {
+        *num_legs = legs;
+    }
+
+    if (timer.active()) {
+        PhaseMetrics &counters = timer.get_counters();
+        counters.airports_settled += context.get_num_settled() - settled;
+        counters.edges_scanned += context.get_num_scanned() - scanned;
+        counters.add_heap(context.get_heap_counters(), heap);
+    }
+    return found;
+}
+
+bool Graph::find_leg(int src_id, int dest_id, SearchContext &context) const {
+    if (!reachability.reaches(src_id, dest_id, context)) {
+        return false;
+    }
+    if (path_cache.enabled()) {
+        shared_ptr<const ShortestPathTree> tree = path_cache.find(src_id);
+        if (tree == NULL) {
+            tree = make_tree(src_id, context);
+            path_cache.insert(tree);
+        }
+
+        if (tree -> costs[dest_id] == INF_COST) {
+            return false;
+        }
+        context.append_path(get_csr(), tree -> predecessor, src_id, dest_id);
+        return true;
+    }
+
+    switch (heap_type) {
+        case HeapType::BINARY:
+            return search_leg<BinaryHeap>(src_id, dest_id, context);
+        case HeapType::QUATERNARY:
+            return search_leg<QuaternaryHeap>(src_id, dest_id, context);
+        case HeapType::PAIRING:
+            return search_leg<PairingHeap>(src_id, dest_id, context);
+        case HeapType::LAZY:
+            return search_leg<LazyHeap>(src_id, dest_id, context);
+    }
+    return false;
+}
+
+template <class Queue>
+bool Graph::search_leg(int src_id, int dest_id, SearchContext &context) const {
+    if (search_type == SearchType::ALT && !landmarks.empty()) {
+        return astar_leg<Queue>(src_id, dest_id, context);
+    }
+    if (search_type == SearchType::BIDIRECTIONAL) {
+        return bidirectional_leg<Queue>(src_id, dest_id, context);
+    }
+    if (search_type == SearchType::CH && !hierarchy.empty()) {
+        return hierarchy.find_path(src_id, dest_id, context);
+    }
+    if (search_type == SearchType::LABELS && !hub_labels.empty()) {
+        return hub_labels.find_path(get_csr(), src_id, dest_id, context);
+    }
+    if (search_type == SearchType::DELTA_STEPPING) {
+        return delta_stepping.find_path(get_csr(), reverse_csr, src_id, dest_id, context);
+    }
+    return dijkstra_leg<Queue>(src_id, dest_id, context);
+}
+
+template <class Queue>
+bool Graph::bidirectional_leg(int src_id, int dest_id, SearchContext &context) const {
+    const CSR &csr = get_csr();
+    SearchContext &reverse = context.get_reverse();
+    Queue &forward_heap = context.start<Queue>(csr.num_airports(), src_id);
+    Queue &backward_heap = reverse.start<Queue>(csr.num_airports(), dest_id);
+
+    // Any path through an airport neither search has settled costs at least
+    // the sum of the last costs popped from each side, so the searches stop
+    // once that sum reaches the cheapest meeting found.
+    double best = src_id == dest_id ? 0 : INF_COST;
+    int meeting = src_id == dest_id ? src_id : -1;
+    double radius[2] = {0, 0};
+    for (bool forward = true; radius[0] + radius[1] < best; forward = !forward) {
+        Queue &heap = forward ? forward_heap : backward_heap;
+        const Queue &other = forward ? backward_heap : forward_heap;
+        SearchContext &side = forward ? context : reverse;
+        const CSR &adjacency = forward ? csr : reverse_csr;
+        if (heap.empty()) {
+            break;
+        }
+
+        int current = heap.pop();
+        double cost = heap.get_cost(current);
+        radius[!forward] = cost;
+        side.settle(current);
+        side.scan(adjacency.get_end(current) - adjacency.get_begin(current));
+
+        for (unsigned e = adjacency.get_begin(current); e < adjacency.get_end(current); e++) {
+            int next_id = adjacency.get_dest(e);
+            if (!side.is_settled(next_id)) {
+                double curr_cost = cost + adjacency.get_weight(e);
+                if (curr_cost < heap.get_cost(next_id)) {
+                    heap.update(next_id, curr_cost);
+                    side.set_predecessor(next_id, e);
+                    if (curr_cost + other.get_cost(next_id) < best) {
+                        best = curr_cost + other.get_cost(next_id);
+                        meeting = next_id;
+                    }
+                }
             }
+        }
+    }
+
+    if (meeting == -1) {
+        return false;
+    }
+    context.append_path(csr, src_id, meeting);
+    for (int id = meeting; id != dest_id; id = reverse_csr.get_src(reverse.get_predecessor(id))) {
+        context.append_route(reverse_csr.get_forward(reverse.get_predecessor(id)));
+    }
+    return true;
+}
+
+template <class Queue>
+bool Graph::dijkstra_leg(int src_id, int dest_id, SearchContext &context) const {
+    const CSR &csr = get_csr();
+    Queue &heap = context.start<Queue>(csr.num_airports(), src_id);
 
-            spt.airports[current] = new Airport(current, airports[current] -> get_name(), 
-                airports[current] -> get_city());
-            
-            Route *pred = predecessor[current];
-            if (pred != NULL) {
-                Route *route_copy = new Route(spt.airports[pred -> get_src() -> get_id()], 
-                    spt.airports[current], pred -> get_label(), pred -> get_weight());
-                spt.insert_route(route_copy);
+    int current = -1;
+    while (current != dest_id && !heap.empty()) {
+        current = heap.pop();
+        context.settle(current);
+        context.scan(csr.get_end(current) - csr.get_begin(current));
+
+        double cost = heap.get_cost(current);
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int dest_id = csr.get_dest(e);
+            if (!context.is_settled(dest_id)) {
+                double curr_cost = cost + csr.get_weight(e);
+                if (curr_cost < heap.get_cost(dest_id)) {
+                    heap.update(dest_id, curr_cost);
+                    context.set_predecessor(dest_id, e);
+                }
             }
+        }
+    }
 
-            for (Route *route : airports[current] -> get_routes()) {
-                int dest_id = route -> get_dest() -> get_id();
-                if (spt.airports[dest_id] == NULL) {
-                    double curr_cost = heap.get_cost(current) + route -> get_weight();
-                    if (curr_cost < heap.get_cost(dest_id)) {
-                        heap.update(dest_id, curr_cost);
-                        predecessor[dest_id] = route;
-                    }
+    if (current != dest_id) {
+        return false;
+    }
+    context.append_path(csr, src_id, dest_id);
+    return true;
+}
+
+template <class Queue>
+bool Graph::astar_leg(int src_id, int dest_id, SearchContext &context) const {
+    const CSR &csr = get_csr();
+    Queue &heap = context.start<Queue>(csr.num_airports(), src_id);
+    context.set_distance(src_id, 0);
+
+    // The heap is keyed by the cost so far plus the lower bound of the
+    // remaining cost, so airports towards the destination are settled first.
+    int current = -1;
+    while (current != dest_id && !heap.empty()) {
+        current = heap.pop();
+        context.settle(current);
+        context.scan(csr.get_end(current) - csr.get_begin(current));
+
+        double cost = context.get_distance(current);
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int next_id = csr.get_dest(e);
+            if (!context.is_settled(next_id)) {
+                double curr_cost = cost + csr.get_weight(e);
+                if (heap.get_cost(next_id) == INF_COST || curr_cost < context.get_distance(next_id)) {
+                    context.set_distance(next_id, curr_cost);
+                    heap.update(next_id, curr_cost + landmarks.lower_bound(next_id, dest_id));
+                    context.set_predecessor(next_id, e);
                 }
             }
         }
+    }
 
-        if (current != dest_id) {
-            break;
+    if (current != dest_id) {
+        return false;
+    }
+    context.append_path(csr, src_id, dest_id);
+    return true;
+}
+
+template <class Queue>
+shared_ptr<const ShortestPathTree> Graph::build_tree(int src_id, SearchContext &context) const {
+    const CSR &csr = get_csr();
+    Queue &heap = context.start<Queue>(csr.num_airports(), src_id);
+
+    shared_ptr<ShortestPathTree> tree(new ShortestPathTree());
+    tree -> src_id = src_id;
+    tree -> costs.resize(csr.num_airports(), INF_COST);
+    tree -> predecessor.resize(csr.num_airports(), NO_ROUTE);
+
+    while (!heap.empty()) {
+        int current = heap.pop();
+        context.settle(current);
+        context.scan(csr.get_end(current) - csr.get_begin(current));
+        tree -> costs[current] = heap.get_cost(current);
+        if (current != src_id) {
+            tree -> predecessor[current] = context.get_predecessor(current);
         }
 
-        vector<Route*> subpath;
-        while (current != src_id) {
-            subpath.push_back(predecessor[current]);
-            current = predecessor[current] -> get_src() -> get_id();
+        double cost = heap.get_cost(current);
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int dest_id = csr.get_dest(e);
+            if (!context.is_settled(dest_id)) {
+                double curr_cost = cost + csr.get_weight(e);
+                if (curr_cost < heap.get_cost(dest_id)) {
+                    heap.update(dest_id, curr_cost);
+                    context.set_predecessor(dest_id, e);
+                }
+            }
+        }
+    }
+    return tree;
+}
+
+shared_ptr<const ShortestPathTree> Graph::make_tree(int src_id, SearchContext &context) const {
+    if (search_type == SearchType::DELTA_STEPPING) {
+        return delta_stepping.build_tree(get_csr(), reverse_csr, src_id, context);
+    }
+    switch (heap_type) {
+        case HeapType::BINARY:
+            return build_tree<BinaryHeap>(src_id, context);
+        case HeapType::QUATERNARY:
+            return build_tree<QuaternaryHeap>(src_id, context);
+        case HeapType::PAIRING:
+            return build_tree<PairingHeap>(src_id, context);
+        case HeapType::LAZY:
+            return build_tree<LazyHeap>(src_id, context);
+    }
+    return NULL;
+}
+
+vector<Route*> Graph::prim_mst(Graph &mst, int src_id) const {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "prim_mst");
+
+    vector<Route*> tree;
+    if (get_airport(src_id) == NULL) {
+        // The empty slot of a malformed row has no airport to grow from.
+        mst.airports.resize(airports.size(), NULL);
+    } else {
+        switch (heap_type) {
+            case HeapType::BINARY:
+                tree = prim_tree<BinaryHeap>(mst, src_id, timer.get_counters());
+                break;
+            case HeapType::QUATERNARY:
+                tree = prim_tree<QuaternaryHeap>(mst, src_id, timer.get_counters());
+                break;
+            case HeapType::PAIRING:
+                tree = prim_tree<PairingHeap>(mst, src_id, timer.get_counters());
+                break;
+            case HeapType::LAZY:
+                tree = prim_tree<LazyHeap>(mst, src_id, timer.get_counters());
+                break;
         }
-        std::reverse(subpath.begin(), subpath.end());
-        path.insert(path.end(), subpath.begin(), subpath.end());
     }
 
     auto end = chrono::steady_clock::now();
     auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
-    cout << endl << "Completed Dijkstra's Algorithm in " << time << "ms" << endl;
-    return path;
+    get_log() << endl << "Completed Prim's Algorithm in " << time << "ms" << endl;
+    return tree;
 }
 
-vector<Route*> Graph::prim_mst(Graph &mst, int src_id) const {
+vector<Route*> Graph::spanning_forest(Graph &mst, vector<ForestComponent> &components) const {
     auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "spanning_forest");
+    const CSR &csr = get_csr();
+    ThreadPool pool;
+    SpanningForest forest;
+    forest.build(csr, pool);
+
+    mst.airports.resize(airports.size(), NULL);
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        if (airports[i] != NULL) {
+            mst.airports[i] = mst.new_airport(i, airports[i] -> get_name(), airports[i] -> get_city());
+        }
+    }
 
-    Heap heap(airports.size(), src_id);
-    vector<Route*> predecessor(airports.size(), NULL);
+    vector<Route*> tree;
+    for (unsigned e : forest.get_routes()) {
+        Route *route = csr.get_route(e);
+        Route *route_copy = mst.new_route(mst.airports[route -> get_src() -> get_id()], 
+            mst.airports[route -> get_dest() -> get_id()], route -> get_label(), 
+            route -> get_weight());
+        mst.insert_route(route_copy);
+        tree.push_back(route_copy);
+    }
+
+    components.clear();
+    for (const ForestComponent &component : forest.get_components()) {
+        if (airports[component.root_id] != NULL) {
+            components.push_back(component);
+        }
+    }
+
+    auto end = chrono::steady_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << endl << "Completed Borůvka's Algorithm in " << time << "ms on " 
+        << pool.size() << " thread(s)" << endl;
+    return tree;
+}
+
+template <class Queue>
+vector<Route*> Graph::prim_tree(Graph &mst, int src_id, PhaseMetrics &counters) const {
+    const CSR &csr = get_csr();
+    Queue heap(airports.size(), src_id);
+    vector<long> predecessor(airports.size(), -1);
     vector<Route*> tree;
 
     mst.airports.resize(airports.size(), NULL);
 
-    for (unsigned long i = 0; i < airports.size(); i++) {
+    while (!heap.empty()) {
         int current = heap.pop();
-        if (heap.get_cost(current) == INT_MAX) {
-            break;
-        }
 
-        mst.airports[current] = new Airport(current, airports[current] -> get_name(), 
+        mst.airports[current] = mst.new_airport(current, airports[current] -> get_name(), 
             airports[current] -> get_city());
+        counters.airports_settled++;
+        counters.edges_scanned += csr.get_end(current) - csr.get_begin(current);
         
-        Route *pred = predecessor[current];
-        if (pred != NULL) {
-            Route *route_copy = new Route(mst.airports[pred -> get_src() -> get_id()], 
+        if (predecessor[current] != -1) {
+            Route *pred = csr.get_route(predecessor[current]);
+            Route *route_copy = mst.new_route(mst.airports[pred -> get_src() -> get_id()], 
                 mst.airports[current], pred -> get_label(), pred -> get_weight());
             mst.insert_route(route_copy);
             tree.push_back(route_copy);
         }
 
-        for (Route *route : airports[current] -> get_routes()) {
-            Airport *dest = route -> get_dest();
-            if (mst.airports[dest -> get_id()] == NULL) {
-                if (route -> get_weight() < heap.get_cost(dest -> get_id())) {
-                    heap.update(dest -> get_id(), route -> get_weight());
-                    predecessor[dest -> get_id()] = route;
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int dest_id = csr.get_dest(e);
+            if (mst.airports[dest_id] == NULL) {
+                if (csr.get_weight(e) < heap.get_cost(dest_id)) {
+                    heap.update(dest_id, csr.get_weight(e));
+                    predecessor[dest_id] = e;
                 }
             }
         }
     }
-
-    auto end = chrono::steady_clock::now();
-    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
-    cout << endl << "Completed Prim's Algorithm in " << time << "ms" << endl;
+    counters.add_heap(heap.get_counters());
     return tree;
 }
 
-vector<double> Graph::floyd_warshall() const {
+vector<double> Graph::floyd_warshall(bool single_precision) const {
     auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "floyd_warshall");
+
+    vector<unsigned long> paths(airports.size(), 0), possible_paths;
+    unsigned long unique_paths = single_precision ? count_paths<float>(paths, possible_paths) :
+        count_paths<double>(paths, possible_paths);
 
-    vector<vector<double>> adj_matrix(airports.size(), 
-        vector<double>(airports.size(), INT_MAX));
-    vector<vector<int>> successor(airports.size(), 
-        vector<int>(airports.size(), -1));
-    
+    unsigned long total_paths = 0;
+    vector<double> centralities(airports.size());
     for (unsigned long i = 0; i < airports.size(); i++) {
-        adj_matrix[i][i] = 0;
-        successor[i][i] = i;
-        for (Route *route : airports[i] -> get_routes()) {
-            int dest_id = route -> get_dest() -> get_id();
-            adj_matrix[i][dest_id] = route -> get_weight();
-            successor[i][dest_id] = dest_id;
-        }
+        total_paths += paths[i];
+        centralities[i] = possible_paths[i] > 0 ? (double)paths[i] / possible_paths[i] : 0;
     }
 
-    for (unsigned long i = 0; i < airports.size(); i++) {
-        for (unsigned long j = 0; j < airports.size(); j++) {
-            if (i != j && adj_matrix[j][i] < INT_MAX) {
-                for (unsigned long k = 0; k < airports.size(); k++) {
-                    if (j != k && k != i && adj_matrix[i][k] < INT_MAX) {
-                        double new_cost = adj_matrix[j][i] + adj_matrix[i][k];
-                        if (new_cost < adj_matrix[j][k]) {
-                            adj_matrix[j][k] = new_cost;
-                            successor[j][k] = i;
-                        }
-                    }
+    auto end = chrono::steady_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << endl << "Completed Floyd-Warshall's Algorithm in " << time << "ms" << endl;
+    get_log() << "Unique Shortest-Paths: " << unique_paths << endl;
+    get_log() << "Average Shortest-Paths Per Airport: " << total_paths / airports.size() << endl;
+    return centralities;
+}
+
+template <typename T>
+unsigned long Graph::count_paths(vector<unsigned long> &paths,
+        vector<unsigned long> &possible_paths) const {
+    DistanceMatrix<T> matrix(airports.size());
+    matrix.load(get_csr());
+
+    ThreadPool pool;
+    blocked_floyd_warshall(matrix, pool);
+    untangle_next(matrix, get_csr(), get_reverse_csr(), pool);
+
+    unsigned long unique_paths = 0;
+    vector<unsigned long> reaching(airports.size(), 0), reachable(airports.size(), 0);
+    for (unsigned long j = 0; j < airports.size(); j++) {
+        for (unsigned long k = 0; k < airports.size(); k++) {
+            if (j != k && matrix.get(j, k) < numeric_limits<T>::infinity()) {
+                unique_paths++;
+                reachable[j]++;
+                reaching[k]++;
+
+                int current = matrix.get_next(j, k);
+                while ((unsigned long)current != k) {
+                    paths[current]++;
+                    current = matrix.get_next(current, k);
                 }
-            } 
+            }
         }
     }
 
-    int unique_paths = 0;
+    // Pairs that start or end at the airport itself are excluded.
+    possible_paths.resize(airports.size());
     for (unsigned long i = 0; i < airports.size(); i++) {
-        for (unsigned long j = 0; j < airports.size(); j++) {
-            if (i != j && adj_matrix[i][j] < INT_MAX) {
-                unique_paths++;
-            }
+        possible_paths[i] = unique_paths - reaching[i] - reachable[i];
+    }
+    return unique_paths;
+}
+
+vector<double> Graph::brandes(unsigned num_threads) const {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "brandes");
+
+    const CSR &csr = get_csr();
+    get_reverse_csr();
+    ThreadPool pool(num_threads);
+    MultiSourceSearch search;
+    search.build(csr);
+
+    // Each thread accumulates into its own vectors, merged once at the end.
+    vector<BrandesScratch> scratch(pool.size());
+    for (BrandesScratch &thread_scratch : scratch) {
+        thread_scratch.dependencies.resize(airports.size(), 0);
+        thread_scratch.reached.resize(airports.size(), 0);
+    }
+    vector<unsigned long> reachable(airports.size(), 0);
+    vector<int> src_ids(airports.size());
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        src_ids[i] = i;
+    }
+
+    search.search_all(src_ids, pool, timer.get_counters(),
+            [&](unsigned long first, const MultiSourceSearch::Batch &batch, unsigned thread) {
+        for (unsigned lane = 0; lane < MultiSourceSearch::LANES && first + lane < src_ids.size(); lane++) {
+            reachable[first + lane] = brandes_source(first + lane, batch, lane, scratch[thread]);
         }
+    });
+    for (const BrandesScratch &thread_scratch : scratch) {
+        timer.get_counters().add(thread_scratch.counters);
+    }
+
+    unsigned long total_unique = 0;
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        total_unique += reachable[i];
     }
 
-    int total_paths = 0;
+    double total_paths = 0;
     vector<double> centralities(airports.size());
     for (unsigned long i = 0; i < airports.size(); i++) {
-        int paths = 0, possible_paths = 0;
-        for (unsigned long j = 0; j < airports.size(); j++) {
-            for (unsigned long k = 0; k < airports.size(); k++) {
-                if (j != i && k != i && j != k && adj_matrix[j][k] < INT_MAX) {
-                    possible_paths++;
-                    unsigned long current = j;
-                    while (current != k) {
-                        current = successor[current][k];
-                        if (current == i) {
-                            paths++;
-                            break;
-                        }
-                    }
-                }
-            }
+        double paths = 0;
+        unsigned long reaching = 0;
+        for (const BrandesScratch &thread_scratch : scratch) {
+            paths += thread_scratch.dependencies[i];
+            reaching += thread_scratch.reached[i];
         }
+
+        // Pairs that start or end at the airport itself are excluded.
+        unsigned long possible_paths = total_unique - reaching - reachable[i];
         total_paths += paths;
-        centralities[i] = (double)paths / possible_paths;
+        centralities[i] = possible_paths > 0 ? paths / possible_paths : 0;
     }
 
     auto end = chrono::steady_clock::now();
     auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
-    cout << endl << "Completed Floyd-Warshall's Algorithm in " << time << "ms" << endl;
-    cout << "Unique Shortest-Paths: " << unique_paths << endl;
-    cout << "Average Shortest-Paths Per Airport: " << total_paths / airports.size() << endl;
+    get_log() << endl << "Completed Brandes' Algorithm in " << time << "ms" << endl;
+    get_log() << "Unique Shortest-Paths: " << total_unique << endl;
+    get_log() << "Average Shortest-Paths Per Airport: " << total_paths / airports.size() << endl;
     return centralities;
 }
 
-vector<int> Graph::get_airports_in_city(string &city) const {
-    vector<int> city_airports;
+vector<double> Graph::approximate_centrality(double epsilon, double delta) const {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "approximate_centrality");
+
+    ThreadPool pool;
+    ApproxBetweenness sampler;
+    sampler.run(get_csr(), get_reverse_csr(), epsilon, delta, pool);
+    timer.get_counters().add(sampler.get_counters());
+
+    auto end = chrono::steady_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << endl << "Completed Approximate Betweenness in " << time << "ms on " 
+        << pool.size() << " thread(s)" << endl;
+    get_log() << "Sampled Shortest-Paths: " << sampler.get_num_samples() << " of at most " 
+        << sampler.get_max_samples() << endl;
+    get_log() << "Error Bound: " << sampler.get_error_bound() << " with probability " 
+        << 1 - delta << endl;
+    return sampler.get_scores();
+}
+
+unsigned long Graph::brandes_source(int src_id, const MultiSourceSearch::Batch &batch,
+        unsigned lane, BrandesScratch &scratch) const {
+    const CSR &csr = get_csr();
+    const CSR &reverse = get_reverse_csr();
+    vector<double> &costs = scratch.costs;
+    vector<int> &order = scratch.order;
+    costs.resize(airports.size());
+    scratch.num_paths.resize(airports.size());
+    scratch.dependency.resize(airports.size());
 
-    transform(city.begin(), city.end(), city.begin(), ::toupper);
+    // Reached airports in order of cost take the place of the order
+    // Dijkstra's Algorithm would settle them in, with ties along zero-cost
+    // routes broken by PathOrder.
+    order.clear();
     for (unsigned long i = 0; i < airports.size(); i++) {
-        string ap_city = airports[i] -> get_city();
-        transform(ap_city.begin(), ap_city.end(), ap_city.begin(), ::toupper);
+        costs[i] = batch.get_cost(lane, i);
+        if (costs[i] != INF_COST) {
+            order.push_back(i);
+            scratch.num_paths[i] = 0;
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return costs[a] < costs[b] || (costs[a] == costs[b] && a < b);
+    });
+    scratch.path_order.sort(csr, reverse, costs, src_id, order);
 
-        if (ap_city == city) {
-            city_airports.push_back(i);
+    // Paths to an airport are counted from its incoming routes on a
+    // shortest path, whose sources come earlier and so are already counted.
+    scratch.num_paths[src_id] = 1;
+    for (int current : order) {
+        for (unsigned e = reverse.get_begin(current); e < reverse.get_end(current); e++) {
+            int prev_id = reverse.get_dest(e);
+            if (costs[prev_id] + reverse.get_weight(e) == costs[current] &&
+                    scratch.path_order.precedes(prev_id, current)) {
+                scratch.num_paths[current] += scratch.num_paths[prev_id];
+            }
         }
+        scratch.counters.edges_scanned += reverse.get_end(current) - reverse.get_begin(current);
     }
-    return city_airports;
+
+    // Airports are revisited in reverse, so every successor on a shortest
+    // path has its final dependency before its predecessors.
+    for (long i = (long)order.size() - 1; i >= 0; i--) {
+        int current = order[i];
+        double &dependency = scratch.dependency[current];
+        dependency = 0;
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int dest_id = csr.get_dest(e);
+            if (costs[current] + csr.get_weight(e) == costs[dest_id] &&
+                    scratch.path_order.precedes(current, dest_id)) {
+                dependency += scratch.num_paths[current] / scratch.num_paths[dest_id] *
+                    (1 + scratch.dependency[dest_id]);
+            }
+        }
+        scratch.counters.edges_scanned += csr.get_end(current) - csr.get_begin(current);
+        if (current != src_id) {
+            scratch.dependencies[current] += dependency;
+            scratch.reached[current]++;
+        }
+    }
+    return order.size() - 1;
+}
+
+const vector<int> &Graph::get_airports_in_city(const string &city) const {
+    get_csr();
+    return name_index.find_city(city);
+}
+
+vector<int> Graph::search_airports(const string &prefix, unsigned long limit) const {
+    get_csr();
+    return name_index.search(prefix, limit);
+}
+
+Airport *Graph::create_airport(string_view name, string_view city) {
+    Airport *airport = new_airport(airports.size(), name, city);
+    insert_airport(airport);
+    return airport;
+}
+
+Route *Graph::create_route(int src_id, int dest_id, string_view airline, double weight) {
+    Route *route = new_route(airports[src_id], airports[dest_id], airline, weight);
+    insert_route(route);
+    return route;
+}
+
+Airport *Graph::new_airport(int id, string_view name, string_view city) {
+    return airport_arena.create(id, strings.store(name), strings.store(city));
+}
+
+Route *Graph::new_route(Airport *src, Airport *dest, string_view airline, double weight) {
+    int airline_id = airlines.intern(airline);
+    return route_arena.create(src, dest, airlines.get_name(airline_id), airline_id, weight);
+}
+
+bool Graph::set_route_weight(Route *route, double weight) {
+    if (!(weight >= 0) || weight == INF_COST) {
+        return false;
+    }
+    double old_weight = route -> get_weight();
+    route -> set_weight(weight);
+    route_changed(route, old_weight, weight);
+    return true;
+}
+
+bool Graph::remove_route(Route *route) {
+    if (!route -> get_src() -> remove_route(route)) {
+        return false;
+    }
+    route -> get_dest() -> remove_incoming_route(route);
+    route_changed(route, route -> get_weight(), INF_COST);
+    return true;
+}
+
+void Graph::enable_dynamic_apsp() {
+    auto start = chrono::steady_clock::now();
+    dynamic_apsp.build(get_csr(), get_reverse_csr());
+    auto end = chrono::steady_clock::now();
+
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << "Computed dynamic all-pairs shortest paths in " << time << "ms" << endl;
+}
+
+const DynamicAPSP &Graph::get_dynamic_apsp() const {
+    return dynamic_apsp;
 }
 
 void Graph::insert_airport(Airport *airport) {
     airports.push_back(airport);
+    csr_stale = true;
+    topology_stale = true;
+    landmarks.clear();
+    hierarchy.clear();
+    hub_labels.clear();
+    disk_apsp.close();
+    delta_stepping.clear();
+    dynamic_apsp.clear();
 }
 
 void Graph::insert_route(Route *route) {
     route -> get_src() -> add_route(route);
+    route -> get_dest() -> add_incoming_route(route);
+    route_changed(route, INF_COST, route -> get_weight());
+}
+
+void Graph::route_changed(Route *route, double old_weight, double new_weight) {
+    csr_stale = true;
+    if (old_weight == INF_COST || new_weight == INF_COST) {
+        topology_stale = true;
+    }
+    landmarks.clear();
+    hierarchy.clear();
+    hub_labels.clear();
+    disk_apsp.close();
+    delta_stepping.clear();
+    if (!dynamic_apsp.empty()) {
+        dynamic_apsp.update(get_csr(), get_reverse_csr(), route -> get_src() -> get_id(),
+            route -> get_dest() -> get_id(), old_weight, new_weight);
+    }
 }
 
 vector<Airport*> Graph::get_airports() const {
     return airports;
+}
+
+Airport *Graph::get_airport(int id) const {
+    return id >= 0 && (unsigned long)id < airports.size() ? airports[id] : NULL;
+}
+
+void Graph::set_log(ostream *log) {
+    this -> log = log;
+}
+
+ostream &Graph::get_log() const {
+    thread_local ostream discard(NULL);
+    return log != NULL ? *log : discard;
+}
+
+void Graph::set_heap_type(HeapType type) {
+    heap_type = type;
+}
+
+void Graph::set_search_type(SearchType type) {
+    search_type = type;
+}
+
+void Graph::build_landmarks(unsigned num_landmarks, LandmarkSelection selection) {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "build_landmarks");
+    ThreadPool pool;
+    landmarks.build(get_csr(), num_landmarks, selection, pool);
+    auto end = chrono::steady_clock::now();
+
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << "Built " << landmarks.get_landmarks().size() << " landmarks in " 
+        << time << "ms" << endl;
+}
+
+bool Graph::load_landmarks(const string &file_path, const DatasetFingerprint &dataset) {
+    return landmarks.load(file_path, get_csr(), dataset);
+}
+
+bool Graph::save_landmarks(const string &file_path, const DatasetFingerprint &dataset) const {
+    return !landmarks.empty() && landmarks.save(file_path, get_csr(), dataset);
+}
+
+const Landmarks &Graph::get_landmarks() const {
+    return landmarks;
+}
+
+void Graph::build_hierarchy() {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "build_hierarchy");
+    hierarchy.build(get_csr());
+    auto end = chrono::steady_clock::now();
+
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << "Built contraction hierarchy in " << time << "ms with " 
+        << hierarchy.num_shortcuts() << " shortcuts (" << hierarchy.bytes() / 1024 
+        << " KB)" << endl;
+}
+
+const ContractionHierarchy &Graph::get_hierarchy() const {
+    return hierarchy;
+}
+
+void Graph::build_hub_labels() {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "build_hub_labels");
+    hub_labels.build(get_csr(), get_reverse_csr());
+    auto end = chrono::steady_clock::now();
+
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    unsigned long num_labels = 2 * get_csr().num_airports();
+    get_log() << "Built hub labels in " << time << "ms with " << hub_labels.num_entries() 
+        << " entries (" << (num_labels > 0 ? (double)hub_labels.num_entries() / num_labels : 0) 
+        << " average, " << hub_labels.max_label_size() << " largest, " 
+        << hub_labels.bytes() / 1024 << " KB)" << endl;
+}
+
+bool Graph::load_hub_labels(const string &file_path, const DatasetFingerprint &dataset) {
+    return hub_labels.load(file_path, get_csr(), dataset);
+}
+
+bool Graph::save_hub_labels(const string &file_path, const DatasetFingerprint &dataset) const {
+    return !hub_labels.empty() && hub_labels.save(file_path, get_csr(), dataset);
+}
+
+const HubLabels &Graph::get_hub_labels() const {
+    return hub_labels;
+}
+
+bool Graph::compute_disk_apsp(const string &file_path, const DatasetFingerprint &dataset,
+        unsigned long max_rounds) {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "compute_disk_apsp");
+    ThreadPool pool;
+    bool complete = disk_apsp.compute(file_path, get_csr(), dataset, pool, max_rounds);
+    auto end = chrono::steady_clock::now();
+
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    pair<unsigned long, unsigned long> progress = disk_apsp.get_progress();
+    get_log() << "Completed " << progress.first << " of " << progress.second 
+        << " all-pairs rounds in " << time << "ms";
+    if (complete) {
+        get_log() << " (" << disk_apsp.bytes() / 1024 << " KB)";
+    }
+    get_log() << endl;
+    return complete;
+}
+
+bool Graph::load_disk_apsp(const string &file_path, const DatasetFingerprint &dataset) {
+    return disk_apsp.open(file_path, get_csr(), dataset);
+}
+
+const DiskAPSP &Graph::get_disk_apsp() const {
+    return disk_apsp;
+}
+
+bool Graph::is_reachable(int src_id, int dest_id) const {
+    SearchContext context;
+    return is_reachable(src_id, dest_id, context);
+}
+
+bool Graph::is_reachable(int src_id, int dest_id, SearchContext &context) const {
+    get_csr();
+    return reachability.reaches(src_id, dest_id, context);
+}
+
+vector<int> Graph::find_unreachable(int src_id) const {
+    get_csr();
+    return reachability.find_unreachable(src_id);
+}
+
+const ReachabilityIndex &Graph::get_reachability() const {
+    get_csr();
+    return reachability;
+}
+
+double Graph::shortest_cost(int src_id, int dest_id) const {
+    if (!disk_apsp.empty()) {
+        return disk_apsp.get(src_id, dest_id);
+    }
+    if (!hub_labels.empty()) {
+        return hub_labels.cost(src_id, dest_id);
+    }
+
+    SearchContext context;
+    if (!shortest_path({src_id, dest_id}, context)) {
+        return INF_COST;
+    }
+    const CSR &csr = get_csr();
+    double cost = 0;
+    for (unsigned route : context.get_path()) {
+        cost += csr.get_weight(route);
+    }
+    return cost;
+}
+
+shared_ptr<const ShortestPathTree> Graph::shortest_path_tree(int src_id) const {
+    thread_local SearchContext context;
+    return shortest_path_tree(src_id, context);
+}
+
+shared_ptr<const ShortestPathTree> Graph::shortest_path_tree(int src_id,
+        SearchContext &context) const {
+    get_csr();
+    PhaseTimer timer(metrics, "shortest_path_tree");
+    shared_ptr<const ShortestPathTree> tree = path_cache.enabled() ? path_cache.find(src_id) : NULL;
+    if (tree != NULL) {
+        return tree;
+    }
+
+    unsigned long settled = context.get_num_settled(), scanned = context.get_num_scanned();
+    tree = make_tree(src_id, context);
+    if (path_cache.enabled()) {
+        path_cache.insert(tree);
+    }
+
+    PhaseMetrics &counters = timer.get_counters();
+    counters.airports_settled += context.get_num_settled() - settled;
+    counters.edges_scanned += context.get_num_scanned() - scanned;
+    return tree;
+}
+
+vector<double> Graph::distance_matrix(const vector<int> &src_ids) const {
+    auto start = chrono::steady_clock::now();
+    PhaseTimer timer(metrics, "distance_matrix");
+
+    ThreadPool pool;
+    MultiSourceSearch search;
+    search.build(get_csr());
+
+    unsigned long n = airports.size();
+    vector<double> costs(src_ids.size() * n);
+    search.search_all(src_ids, pool, timer.get_counters(),
+            [&](unsigned long first, const MultiSourceSearch::Batch &batch, unsigned) {
+        for (unsigned lane = 0; lane < MultiSourceSearch::LANES && first + lane < src_ids.size(); lane++) {
+            double *row = &costs[(first + lane) * n];
+            for (unsigned long i = 0; i < n; i++) {
+                row[i] = batch.get_cost(lane, i);
+            }
+        }
+    });
+
+    auto end = chrono::steady_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    get_log() << endl << "Computed " << src_ids.size() << " Rows of Shortest-Path Costs in "
+        << time << "ms on " << pool.size() << " thread(s)" << endl;
+    return costs;
+}
+
+void Graph::set_path_cache(unsigned long max_bytes) {
+    path_cache.set_budget(max_bytes);
+}
+
+PathCacheStats Graph::get_path_cache_stats() const {
+    return path_cache.get_stats();
+}
+
+void Graph::set_metrics(bool enabled) {
+    metrics.set_enabled(enabled);
+}
+
+const Metrics &Graph::get_metrics() const {
+    return metrics;
+}
+
+void Graph::clear_metrics() {
+    metrics.clear();
+}
+
+const CSR &Graph::get_csr() const {
+    if (csr_stale) {
+        PhaseTimer timer(metrics, "build_csr");
+        csr.build(airports, airlines);
+        reverse_csr.build_reverse(csr);
+        if (topology_stale) {
+            name_index.build(airports);
+            reachability.build(csr);
+            topology_stale = false;
+        }
+        csr_stale = false;
+        path_cache.clear();
+    }
+    return csr;
+}
+
+const CSR &Graph::get_reverse_csr() const {
+    get_csr();
+    return reverse_csr;
 }
\ No newline at end of file
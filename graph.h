@@ -6,10 +6,34 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
+#include <ostream>
 
 #include "heap.h"
 #include "airport.h"
 #include "route.h"
+#include "arena.h"
+#include "airlines.h"
+#include "csr.h"
+#include "apsp.h"
+#include "snapshot.h"
+#include "csv.h"
+#include "search.h"
+#include "path_cache.h"
+#include "landmarks.h"
+#include "contraction.h"
+#include "hub_labels.h"
+#include "forest.h"
+#include "name_index.h"
+#include "reachability.h"
+#include "dynamic_apsp.h"
+#include "metrics.h"
+#include "approx_betweenness.h"
+#include "multi_source.h"
+#include "path_order.h"
+#include "delta_stepping.h"
+#include "disk_apsp.h"
 
 using namespace std;
 
@@ -20,16 +44,43 @@ using namespace std;
  */
 class Graph {
     public:
+        // Constructor to create an empty graph.
+        Graph();
 
-        // Destructor to delete graph.
-        ~Graph();
-
-        // Initializes graph by reading airports and routes.
+        /**
+         * Initializes graph by reading airports and routes. A binary
+         * snapshot is used instead when one matches the current datasets,
+         * and is written after reading the datasets otherwise.
+         */
         void initialize();
 
+        /**
+         * Loads airports and routes from a binary snapshot into an empty
+         * graph. The routes are traversed directly from the mapped file.
+         * @param file_path File path of snapshot.
+         * @param dataset Fingerprint the snapshot must have been written
+         * from, or an empty fingerprint to accept any snapshot.
+         * @returns Boolean representing if the snapshot was loaded or not.
+         */
+        bool load_snapshot(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint());
+
+        /**
+         * Saves airports and routes to a binary snapshot.
+         * @param file_path File path of snapshot.
+         * @param dataset Fingerprint of the datasets the graph was read from.
+         * @returns Boolean representing if the snapshot was saved or not.
+         */
+        bool save_snapshot(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint()) const;
+
         /**
          * Helper function to read CSV of airport data and 
-         * add airports to graph.
+         * add airports to graph. The ID of each airport is the
+         * line of its row, counted from the first ID available.
+         * Malformed and blank rows are reported with their line
+         * numbers and leave an empty slot, so later airports
+         * keep the IDs routes refer to.
          * @param file_path File path to read.
          * @returns Number of airports added.
          */
@@ -37,8 +88,10 @@ class Graph {
 
          /**
          * Helper function to read CSV of route data and 
-         * add routes to graph.
-         * @param filename File name to read.
+         * add routes to graph. The file is parsed in parallel
+         * chunks, and malformed rows are reported with their
+         * line numbers and skipped.
+         * @param file_path File path to read.
          * @returns Number of routes added.
          */
         int read_routes(const string &file_path);
@@ -51,10 +104,27 @@ class Graph {
          * Shortest path is defined as the path with the lowest cost,
          * which is not guaranteed to exist.
          * @param dest_ids Reference to vector of airport IDs to visit.
+         * @param num_legs Pointer to set to the number of consecutive legs
+         * reached from the first airport, or NULL.
          * @returns Vector of routes creating shortest-path to most
          * reachable destination.
          */ 
-        vector<Route*> dijkstra(const vector<int> &dest_ids) const;
+        vector<Route*> dijkstra(const vector<int> &dest_ids, unsigned long *num_legs = NULL) const;
+
+        /**
+         * Finds the same shortest-path as dijkstra() using a caller-owned
+         * search context, without printing or allocating once the context
+         * has been used on the graph before.
+         * @param dest_ids Reference to vector of airport IDs to visit.
+         * @param context Reference to search context, whose path is set to
+         * the route indices of the shortest-path to the most reachable
+         * destination.
+         * @param num_legs Pointer to set to the number of consecutive legs
+         * reached from the first airport, or NULL.
+         * @returns Boolean representing if every destination was reached or not.
+         */
+        bool shortest_path(const vector<int> &dest_ids, SearchContext &context,
+            unsigned long *num_legs = NULL) const;
 
         /**
          * Performs Prim's Algorithm on graph to generate the largest
@@ -68,6 +138,18 @@ class Graph {
          */ 
         vector<Route*> prim_mst(Graph &mst, int src_id) const;
 
+        /**
+         * Performs Borůvka's Algorithm on graph in parallel to generate the
+         * minimum spanning forest, which contains a minimum spanning tree
+         * of every connected component when routes are followed in either
+         * direction. Unlike prim_mst(), every airport is covered.
+         * @param mst Minimum spanning forest to populate.
+         * @param components Reference to vector to set to the trees of
+         * the forest in order of their smallest airport ID.
+         * @returns Routes of the forest in the order they were added.
+         */
+        vector<Route*> spanning_forest(Graph &mst, vector<ForestComponent> &components) const;
+
         /**
          * Performs Floyd-Warshall's algorithm to calculate the betweenness
          * centrality of every airport by finding the shortest path between
@@ -76,16 +158,578 @@ class Graph {
          * Betweenness centrality is defined as the number of shortest paths
          * through a given airport divided by the total number of shortest paths
          * that do not include the airport as a source or destination.
+         *
+         * Distances are computed with a tiled, multithreaded kernel over a
+         * flat matrix, and one shortest path is followed per pair.
+         * @param single_precision Whether to store costs as float instead of
+         * double, halving memory traffic at the expense of precision.
          * @returns Vector representing the betweenness centrality of each airport.
          */
-        vector<double> floyd_warshall() const;
+        vector<double> floyd_warshall(bool single_precision = false) const;
 
         /**
-         * Returns all airports located in a given city.
+         * Performs Brandes' algorithm to calculate the betweenness centrality
+         * of every airport with one shortest-path search per source airport
+         * followed by back-propagation of path dependencies.
+         *
+         * Unlike floyd_warshall(), all shortest paths between a pair are
+         * counted, each contributing an equal fraction of one path. Costs
+         * come from batched searches of MultiSourceSearch, and batches are
+         * divided between threads with separate accumulators that are
+         * merged at the end.
+         * @param num_threads Number of threads to use, 0 for one per core.
+         * @returns Vector representing the betweenness centrality of each airport.
+         */
+        vector<double> brandes(unsigned num_threads = 0) const;
+
+        /**
+         * Estimates the betweenness centrality computed by brandes() from
+         * randomly sampled shortest paths, on every core. Far fewer
+         * searches than one per airport are needed on large networks, and
+         * each grows from both airports of a pair until the two sides meet.
+         * @param epsilon Maximum absolute error of each score, in (0, 1).
+         * @param delta Maximum probability of any score exceeding the error,
+         * in (0, 1).
+         * @returns Vector representing the estimated betweenness centrality
+         * of each airport.
+         */
+        vector<double> approximate_centrality(double epsilon, double delta) const;
+
+        /**
+         * Returns all airports located in a given city, ignoring case.
          * @param city Name of city to get all airports in.
-         * @returns Vector of pointers to all airports in given city.
+         * @returns Reference to vector of IDs of all airports in given city.
+         */
+        const vector<int> &get_airports_in_city(const string &city) const;
+
+        /**
+         * Finds airports whose city or name has a word starting with the
+         * given text, ignoring case, for autocomplete and partial names.
+         * @param prefix Start of a word of a city or airport name.
+         * @param limit Maximum number of airports to return.
+         * @returns IDs of matching airports.
+         */
+        vector<int> search_airports(const string &prefix, unsigned long limit = 10) const;
+
+        /**
+         * Creates an airport with the next airport ID and inserts it in
+         * the graph, which owns it.
+         * @param name Name of airport, which is copied.
+         * @param city City in which airport is located in, which is copied.
+         * @returns Pointer to airport, valid for the lifetime of the graph.
+         */
+        Airport *create_airport(string_view name, string_view city);
+
+        /**
+         * Creates a route between two airports of the graph and inserts it
+         * in the graph, which owns it.
+         * @param src_id ID of source airport.
+         * @param dest_id ID of destination airport.
+         * @param airline Name of airline, which is interned.
+         * @param weight Cost of route.
+         * @returns Pointer to route, valid for the lifetime of the graph.
+         */
+        Route *create_route(int src_id, int dest_id, string_view airline, double weight);
+
+        /**
+         * Changes the cost of a route of the graph. The CSR is rebuilt on its
+         * next use, keeping the name index and reachability index since a
+         * new cost changes neither. Landmarks, the contraction hierarchy,
+         * hub labels, delta-stepping state and the on-disk all-pairs table
+         * are dropped and must be built or opened again after an update,
+         * while the dynamic all-pairs shortest paths are updated for the
+         * affected sources only.
+         * @param route Pointer to route of the graph.
+         * @param weight New cost of route.
+         * @returns Boolean representing if the cost was valid and set or not.
+         */
+        bool set_route_weight(Route *route, double weight);
+
+        /**
+         * Removes a route from the graph, updating indexes as
+         * set_route_weight() does. Its memory stays owned by the graph,
+         * so previously returned paths remain valid.
+         * @param route Pointer to route of the graph.
+         * @returns Boolean representing if the route was found and removed or not.
+         */
+        bool remove_route(Route *route);
+
+        /**
+         * Computes the shortest-path costs between every pair of airports
+         * and the betweenness centrality of every airport, which are then
+         * kept up to date as routes are created, repriced and removed
+         * instead of being recomputed from scratch. Inserting an airport
+         * or loading a snapshot stops maintaining them.
+         */
+        void enable_dynamic_apsp();
+
+        /**
+         * Returns the costs and centralities maintained since
+         * enable_dynamic_apsp().
+         * @returns Reference to dynamic all-pairs shortest paths, empty if
+         * they are not maintained.
+         */
+        const DynamicAPSP &get_dynamic_apsp() const;
+
+        /**
+         * Returns all airports in the graph, used for testing.
+         * @returns Vector of pointers to all airports, indexed by ID, with
+         * NULL for the empty slots of malformed rows.
+         */
+        vector<Airport*> get_airports() const;
+
+        /**
+         * Returns an airport of the graph.
+         * @param id Airport ID.
+         * @returns Pointer to airport, NULL if the ID is out of range or
+         * the empty slot of a malformed row.
+         */
+        Airport *get_airport(int id) const;
+
+        /**
+         * Selects the priority queue used by Dijkstra's and Prim's algorithms.
+         * @param type Heap implementation to use.
+         */
+        void set_heap_type(HeapType type);
+
+        /**
+         * Selects the algorithm used by dijkstra() and shortest_path() for
+         * each leg when the path cache is disabled. ALT runs A* guided by the
+         * landmark lower bounds, settling fewer airports than Dijkstra's
+         * Algorithm, and falls back to it when no landmarks are loaded.
+         * BIDIRECTIONAL alternates Dijkstra's Algorithm forwards from the
+         * source and backwards from the destination over the incoming
+         * routes until the two frontiers meet. CH
+         * searches upwards from both ends of the contraction hierarchy, and
+         * falls back to Dijkstra's Algorithm when no hierarchy is built.
+         * LABELS follows the routes whose costs the hub labels show to be
+         * on a shortest path, without a priority queue, and likewise falls
+         * back when no labels are built. DELTA_STEPPING searches with every
+         * core at once, for single queries on large networks, and also
+         * generates the trees of the path cache. Every index is removed
+         * when airports or routes are inserted.
+         * @param type Search algorithm to use.
+         */
+        void set_search_type(SearchType type);
+
+        /**
+         * Chooses landmark airports and computes the costs from and to each
+         * of them, used as the A* heuristic of SearchType::ALT.
+         * @param num_landmarks Number of landmarks.
+         * @param selection Strategy used to choose landmarks.
+         */
+        void build_landmarks(unsigned num_landmarks = 16,
+            LandmarkSelection selection = LandmarkSelection::FARTHEST);
+
+        /**
+         * Loads landmark tables saved for the current graph.
+         * @param file_path File path of landmark tables.
+         * @param dataset Fingerprint the tables must have been written
+         * from, or an empty fingerprint to accept any tables.
+         * @returns Boolean representing if the tables were loaded or not.
+         */
+        bool load_landmarks(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint());
+
+        /**
+         * Saves the landmark tables of the graph.
+         * @param file_path File path of landmark tables.
+         * @param dataset Fingerprint of the datasets the graph was read from.
+         * @returns Boolean representing if the tables were saved or not.
+         */
+        bool save_landmarks(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint()) const;
+
+        /**
+         * Returns the landmarks used by SearchType::ALT.
+         * @returns Reference to landmark tables, empty if none are loaded.
+         */
+        const Landmarks &get_landmarks() const;
+
+        /**
+         * Contracts every airport of the graph into the contraction
+         * hierarchy used by SearchType::CH.
+         */
+        void build_hierarchy();
+
+        /**
+         * Returns the contraction hierarchy used by SearchType::CH.
+         * @returns Reference to hierarchy, empty if none is built.
+         */
+        const ContractionHierarchy &get_hierarchy() const;
+
+        /**
+         * Computes the hub labels used by shortest_cost() and
+         * SearchType::LABELS.
+         */
+        void build_hub_labels();
+
+        /**
+         * Loads hub labels saved for the current graph.
+         * @param file_path File path of hub labels.
+         * @param dataset Fingerprint the labels must have been written
+         * from, or an empty fingerprint to accept any labels.
+         * @returns Boolean representing if the labels were loaded or not.
+         */
+        bool load_hub_labels(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint());
+
+        /**
+         * Saves the hub labels of the graph.
+         * @param file_path File path of hub labels.
+         * @param dataset Fingerprint of the datasets the graph was read from.
+         * @returns Boolean representing if the labels were saved or not.
+         */
+        bool save_hub_labels(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint()) const;
+
+        /**
+         * Returns the hub labels used by shortest_cost() and SearchType::LABELS.
+         * @returns Reference to hub labels, empty if none are built.
+         */
+        const HubLabels &get_hub_labels() const;
+
+        /**
+         * Computes the shortest-path costs between every pair of airports
+         * into a memory-mapped file used by shortest_cost(), for networks
+         * whose matrices do not fit in memory. A file left incomplete for
+         * the current graph is resumed from its last completed round.
+         * @param file_path File path of all-pairs table.
+         * @param dataset Fingerprint of the datasets the graph was read from.
+         * @param max_rounds Maximum number of rounds to run before returning,
+         * leaving the file to be resumed.
+         * @returns Boolean representing if the table is complete or not.
+         */
+        bool compute_disk_apsp(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint(),
+            unsigned long max_rounds = -1);
+
+        /**
+         * Maps a complete all-pairs table computed for the current graph.
+         * @param file_path File path of all-pairs table.
+         * @param dataset Fingerprint the table must have been written
+         * from, or an empty fingerprint to accept any table.
+         * @returns Boolean representing if the table was mapped or not.
+         */
+        bool load_disk_apsp(const string &file_path,
+            const DatasetFingerprint &dataset = DatasetFingerprint());
+
+        /**
+         * Returns the all-pairs table used by shortest_cost().
+         * @returns Reference to table, empty if none is mapped.
+         */
+        const DiskAPSP &get_disk_apsp() const;
+
+        /**
+         * Returns the cost of the shortest path between two airports, read
+         * from the all-pairs table when mapped, merging their hub labels
+         * when built and searching otherwise.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @returns Cost of shortest path, INF_COST if unreachable.
+         */
+        double shortest_cost(int src_id, int dest_id) const;
+
+        /**
+         * Computes the complete shortest-path tree of a source airport, with
+         * every core when the search type is DELTA_STEPPING and with
+         * Dijkstra's Algorithm otherwise. Trees are taken from and added to
+         * the path cache when it is enabled.
+         * @param src_id ID of source airport.
+         * @returns Pointer to shortest-path tree reaching every airport
+         * reachable from the source.
          */
-        vector<int> get_airports_in_city(string &city) const;
+        shared_ptr<const ShortestPathTree> shortest_path_tree(int src_id) const;
+
+        /**
+         * Computes the same tree as shortest_path_tree() using a
+         * caller-owned search context, so several threads can compute
+         * trees at once once the graph is built.
+         * @param src_id ID of source airport.
+         * @param context Reference to search context of the calling thread.
+         * @returns Pointer to shortest-path tree reaching every airport
+         * reachable from the source.
+         */
+        shared_ptr<const ShortestPathTree> shortest_path_tree(int src_id,
+            SearchContext &context) const;
+
+        /**
+         * Returns if any path leads from one airport to another, answered
+         * from the strongly connected components of the graph without
+         * searching. Legs between airports without a path are rejected
+         * this way before any search.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @returns Boolean representing if the destination is reachable.
+         */
+        bool is_reachable(int src_id, int dest_id) const;
+
+        /**
+         * Answers the same question as is_reachable() with a caller-owned
+         * search context, which networks with too many components for the
+         * stored closure need to search the condensation DAG without
+         * allocating.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context of the calling thread.
+         * @returns Boolean representing if the destination is reachable.
+         */
+        bool is_reachable(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Finds every airport that no path from an airport leads to, which
+         * are the airports missing from the tree of prim_mst().
+         * @param src_id ID of starting airport.
+         * @returns IDs of unreachable airports in increasing order.
+         */
+        vector<int> find_unreachable(int src_id) const;
+
+        /**
+         * Returns the strongly connected components of the graph.
+         * @returns Reference to reachability index.
+         */
+        const ReachabilityIndex &get_reachability() const;
+
+        /**
+         * Computes the costs of the shortest paths from several airports to
+         * every airport on every core, searching batches of sources together.
+         * @param src_ids Reference to IDs of source airports.
+         * @returns Vector of costs with one row of every airport per source,
+         * in the order of the sources, INF_COST where unreachable.
+         */
+        vector<double> distance_matrix(const vector<int> &src_ids) const;
+
+        /**
+         * Sets the memory budget of the cache of complete shortest-path
+         * trees used by dijkstra() and shortest_path(). Legs starting at a
+         * cached airport are answered from its stored tree, while other
+         * legs generate and cache a complete tree instead of stopping at
+         * their destination. The cache is emptied once airports or routes
+         * are inserted, when the graph is next searched.
+         * @param max_bytes Maximum number of bytes of cached trees, 0 to
+         * disable the cache.
+         */
+        void set_path_cache(unsigned long max_bytes);
+
+        /**
+         * Returns the hit, miss and memory counters of the path cache.
+         * @returns Copy of path cache counters.
+         */
+        PathCacheStats get_path_cache_stats() const;
+
+        /**
+         * Enables or disables recording the work and time of loading,
+         * searches, spanning trees, centrality and index builds. Heap and
+         * search counters are always kept unless built with -DNO_METRICS,
+         * while timing and recording only happen when enabled.
+         * @param enabled Whether to record algorithm phases.
+         */
+        void set_metrics(bool enabled);
+
+        /**
+         * Returns the counters recorded for each algorithm phase, which can
+         * be written as JSON.
+         * @returns Reference to metrics of the graph.
+         */
+        const Metrics &get_metrics() const;
+
+        /**
+         * Forgets every recorded algorithm phase.
+         */
+        void clear_metrics();
+
+        /**
+         * Sets the stream that loading times and algorithm summaries are
+         * printed to, which is standard output by default.
+         * @param log Pointer to output stream, NULL to print nothing.
+         */
+        void set_log(ostream *log);
+
+        /**
+         * Returns the compressed sparse row snapshot used by the graph
+         * algorithms, rebuilding it and the name index first if airports
+         * or routes were inserted since it was last built.
+         * @returns Reference to CSR snapshot of the graph.
+         */
+        const CSR &get_csr() const;
+
+        /**
+         * Returns the reverse snapshot of the graph, storing the incoming
+         * routes of each airport, rebuilt together with get_csr().
+         * @returns Reference to reverse CSR snapshot of the graph.
+         */
+        const CSR &get_reverse_csr() const;
+
+        /**
+         * Helper function to print the malformed rows found while
+         * reading a data file.
+         * @param file_path File path that was read.
+         * @param errors Errors found in each chunk of the file.
+         */
+        static void report_errors(const string &file_path, 
+            const vector<vector<CSVError>> &errors);
+
+    private:
+        /**
+         * Helper function to find the shortest path for a single leg,
+         * using the path cache when it is enabled.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context to search with and
+         * append the route indices of the shortest path to.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        bool find_leg(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Helper function to find the shortest path for a single leg with
+         * the selected search algorithm.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context to search with and
+         * append the route indices of the shortest path to.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        template <class Queue>
+        bool search_leg(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Helper function to find the shortest path for a single leg with A*
+         * search, using the landmark lower bounds as the heuristic.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context to search with and
+         * append the route indices of the shortest path to.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        template <class Queue>
+        bool astar_leg(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Helper function to find the shortest path for a single leg with
+         * bidirectional Dijkstra, searching backwards from the destination
+         * with the reverse context of the search context.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context to search with and
+         * append the route indices of the shortest path to.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        template <class Queue>
+        bool bidirectional_leg(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Helper function to find the shortest path for a single leg using
+         * a given priority queue implementation.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context to search with and
+         * append the route indices of the shortest path to.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        template <class Queue>
+        bool dijkstra_leg(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Helper function to generate the complete shortest-path tree of a
+         * source airport using a given priority queue implementation.
+         * @param src_id ID of source airport.
+         * @param context Reference to search context to search with.
+         * @returns Pointer to shortest-path tree reaching every airport
+         * reachable from the source.
+         */
+        template <class Queue>
+        shared_ptr<const ShortestPathTree> build_tree(int src_id, SearchContext &context) const;
+
+        /**
+         * Helper function to generate the complete shortest-path tree of a
+         * source airport with the selected search type and heap.
+         * @param src_id ID of source airport.
+         * @param context Reference to search context to search with.
+         * @returns Pointer to shortest-path tree reaching every airport
+         * reachable from the source.
+         */
+        shared_ptr<const ShortestPathTree> make_tree(int src_id, SearchContext &context) const;
+
+        /**
+         * Helper function to perform Prim's Algorithm using a given
+         * priority queue implementation.
+         * @param mst Minimum spanning tree to populate.
+         * @param src_id ID of starting airport.
+         * @param counters Reference to metrics to add the work done to.
+         * @returns Vector of routes in the minimum spanning tree.
+         */
+        template <class Queue>
+        vector<Route*> prim_tree(Graph &mst, int src_id, PhaseMetrics &counters) const;
+
+        /**
+         * Accumulators and buffers of one thread of brandes(), reused for
+         * every source the thread handles.
+         */
+        struct BrandesScratch {
+            vector<double> dependencies;
+            vector<unsigned long> reached;
+            vector<double> costs;
+            vector<int> order;
+            vector<double> num_paths;
+            vector<double> dependency;
+            PathOrder path_order;
+            PhaseMetrics counters;
+        };
+
+        /**
+         * Helper function to accumulate the path dependencies of every
+         * airport for the shortest paths starting at one source airport,
+         * given its costs from a batched search.
+         * @param src_id ID of source airport.
+         * @param batch Reference to batch searched from the source.
+         * @param lane Index of the source within the batch.
+         * @param scratch Reference to accumulators and buffers of the thread.
+         * @returns Number of airports reached from the source, excluding itself.
+         */
+        unsigned long brandes_source(int src_id, const MultiSourceSearch::Batch &batch,
+            unsigned lane, BrandesScratch &scratch) const;
+
+        /**
+         * Helper function to compute all-pairs shortest paths and count the
+         * airports on the shortest path between every pair.
+         * @param paths Vector to add the number of paths through each airport to.
+         * @param possible_paths Vector to set the number of paths that do not
+         * start or end at each airport to.
+         * @returns Number of pairs of airports with a path between them.
+         */
+        template <typename T>
+        unsigned long count_paths(vector<unsigned long> &paths,
+            vector<unsigned long> &possible_paths) const;
+
+        vector<Airport*> airports;
+        HeapType heap_type;
+        SearchType search_type;
+        Landmarks landmarks;
+        ContractionHierarchy hierarchy;
+        HubLabels hub_labels;
+        DiskAPSP disk_apsp;
+        DynamicAPSP dynamic_apsp;
+        mutable DeltaStepping delta_stepping;
+
+        /**
+         * Helper function to allocate an airport without inserting it.
+         * @param id Airport ID.
+         * @param name Name of airport, which is copied.
+         * @param city City in which airport is located in, which is copied.
+         * @returns Pointer to airport owned by the graph.
+         */
+        Airport *new_airport(int id, string_view name, string_view city);
+
+        /**
+         * Helper function to allocate a route without inserting it.
+         * @param src Pointer to source airport of the graph.
+         * @param dest Pointer to destination airport of the graph.
+         * @param airline Name of airline, which is interned.
+         * @param weight Cost of route.
+         * @returns Pointer to route owned by the graph.
+         */
+        Route *new_route(Airport *src, Airport *dest, string_view airline, double weight);
 
         /**
          * Helper function to insert airport in graph.
@@ -100,11 +744,40 @@ class Graph {
         void insert_route(Route *route);
 
         /**
-         * Returns all airports in the graph, used for testing.
-         * @returns Vector of pointers to all airports.
+         * Helper function to invalidate indexes after the cost of a route
+         * changed, and to update the dynamic all-pairs shortest paths.
+         * Indexes of which airports are connected are only invalidated when
+         * the route was inserted or removed.
+         * @param route Pointer to changed route.
+         * @param old_weight Cost before the change, INF_COST if inserted.
+         * @param new_weight Cost after the change, INF_COST if removed.
          */
-        vector<Airport*> get_airports() const;
+        void route_changed(Route *route, double old_weight, double new_weight);
 
-    private:
-        vector<Airport*> airports;
+        // Storage of every airport, route and string of the graph, which
+        // are freed together with the graph instead of one at a time.
+        Arena<Airport> airport_arena;
+        Arena<Route> route_arena;
+        StringArena strings;
+        AirlineDictionary airlines;
+
+        /**
+         * Helper function to return the stream to print progress to.
+         * @returns Reference to log stream.
+         */
+        ostream &get_log() const;
+
+        mutable CSR csr;
+        mutable CSR reverse_csr;
+        mutable NameIndex name_index;
+        mutable ReachabilityIndex reachability;
+        mutable bool csr_stale;
+
+        // Set when airports or routes were added or removed, which the name
+        // and reachability indexes depend on, rather than only repriced.
+        mutable bool topology_stale;
+        mutable PathCache path_cache;
+        mutable Metrics metrics;
+        unique_ptr<Snapshot> snapshot;
+        ostream *log;
 };
\ No newline at end of file
@@ -1,91 +1,190 @@
 /**
  * @file heap.cpp
- * Implementation of heap class.
+ * Implementation of non-template heap classes.
  */
 
+#include <functional>
+
 #include "heap.h"
-#include "route.h"
 
-Heap::Heap(int num_airports, int start_id) {
-    for (int i = 0; i < num_airports; i++) {
-        ids.push_back(i);
-    }
-    std::swap(ids[0], ids[start_id]);
+PairingHeap::PairingHeap() {
+    root = -1;
+    epoch = 0;
+}
 
-    costs.resize(num_airports, INT_MAX);
-    costs[start_id] = 0;
+PairingHeap::PairingHeap(int num_airports, int start_id) : PairingHeap() {
+    reset(num_airports, start_id);
 }
 
-int Heap::pop() {
-    int id = ids[0];
-    ids[0] = ids.back();
-    ids.pop_back();
+void PairingHeap::reset(int num_airports, int start_id) {
+    advance_epoch(stamps, epoch, num_airports);
+    child.resize(num_airports);
+    sibling.resize(num_airports);
+    prev.resize(num_airports);
+    in_heap.resize(num_airports);
+    costs.resize(num_airports);
+    root = -1;
+    update(start_id, 0);
+}
 
-    heapify_down(0);
+int PairingHeap::pop() {
+    int id = root;
+    in_heap[id] = false;
+    if (METRICS_COMPILED) {
+        counters.pops++;
+    }
+    root = merge_pairs(child[id]);
+    if (root != -1) {
+        prev[root] = -1;
+    }
+    child[id] = -1;
     return id;
 }
 
-void Heap::update(int id, float cost) {
+void PairingHeap::update(int id, double cost) {
+    if (stamps[id] != epoch) {
+        stamps[id] = epoch;
+        in_heap[id] = false;
+    }
     costs[id] = cost;
-    for (unsigned long i = 0; i < ids.size(); i++) {
-        if (ids[i] == id) {
-            heapify_up(i);
+    if (!in_heap[id]) {
+        in_heap[id] = true;
+        child[id] = sibling[id] = prev[id] = -1;
+        root = (root == -1) ? id : meld(root, id);
+        if (METRICS_COMPILED) {
+            counters.pushes++;
         }
+        return;
+    }
+
+    if (METRICS_COMPILED) {
+        counters.decrease_keys++;
+    }
+    if (id != root) {
+        cut(id);
+        root = meld(root, id);
     }
 }
 
-void Heap::heapify_up(int idx) {
-    if (idx > 0) {
-        int parent_idx = get_parent(idx);
-        if (costs[ids[idx]] < costs[ids[parent_idx]]) {
-            std::swap(ids[idx], ids[parent_idx]);
-            heapify_up(parent_idx);
-        }
+bool PairingHeap::empty() const {
+    return root == -1;
+}
+
+double PairingHeap::get_cost(int id) const {
+    return stamps[id] == epoch ? costs[id] : INF_COST;
+}
+
+const HeapCounters &PairingHeap::get_counters() const {
+    return counters;
+}
+
+int PairingHeap::meld(int a, int b) {
+    if (costs[b] < costs[a]) {
+        std::swap(a, b);
     }
+    sibling[b] = child[a];
+    if (child[a] != -1) {
+        prev[child[a]] = b;
+    }
+    prev[b] = a;
+    child[a] = b;
+    sibling[a] = -1;
+    return a;
+}
+
+void PairingHeap::cut(int id) {
+    int p = prev[id];
+    if (child[p] == id) {
+        child[p] = sibling[id];
+    } else {
+        sibling[p] = sibling[id];
+    }
+    if (sibling[id] != -1) {
+        prev[sibling[id]] = p;
+    }
+    sibling[id] = prev[id] = -1;
 }
 
-void Heap::heapify_down(int idx) {
-    if (has_child(idx)) {
-        int child_idx = get_min_child(idx);
-        if (costs[ids[idx]] > costs[ids[child_idx]]) {
-            std::swap(ids[idx], ids[child_idx]);
-            heapify_down(child_idx);
+int PairingHeap::merge_pairs(int first) {
+    if (first == -1) {
+        return -1;
+    }
+
+    // First pass melds siblings left to right in pairs.
+    pairs.clear();
+    while (first != -1) {
+        int a = first, b = sibling[a];
+        if (b == -1) {
+            sibling[a] = prev[a] = -1;
+            pairs.push_back(a);
+            break;
         }
+        first = sibling[b];
+        sibling[a] = prev[a] = sibling[b] = prev[b] = -1;
+        pairs.push_back(meld(a, b));
+    }
+
+    // Second pass melds the pairs right to left into one root.
+    int merged = pairs.back();
+    for (long i = (long)pairs.size() - 2; i >= 0; i--) {
+        merged = meld(pairs[i], merged);
     }
+    return merged;
 }
 
-double Heap::get_cost(int id) const {
-    return costs[id];
+LazyHeap::LazyHeap() {
+    epoch = 0;
 }
 
-int Heap::get_min_child(int idx) const {
-    unsigned long lc_idx = get_lchild(idx);
-    unsigned long rc_idx = get_rchild(idx);
+LazyHeap::LazyHeap(int num_airports, int start_id) : LazyHeap() {
+    reset(num_airports, start_id);
+}
+
+void LazyHeap::reset(int num_airports, int start_id) {
+    advance_epoch(stamps, epoch, num_airports);
+    costs.resize(num_airports);
+    entries.clear();
+    update(start_id, 0);
+}
 
-    if (lc_idx >= ids.size()) {
-        return rc_idx;
-    } else if (rc_idx >= ids.size()) {
-        return lc_idx;
+int LazyHeap::pop() {
+    std::pop_heap(entries.begin(), entries.end(), std::greater<pair<double, int>>());
+    int id = entries.back().second;
+    entries.pop_back();
+    if (METRICS_COMPILED) {
+        counters.pops++;
     }
 
-    if (costs[ids[lc_idx]] < costs[ids[rc_idx]]) {
-        return lc_idx;
+    discard_stale();
+    return id;
+}
+
+void LazyHeap::update(int id, double cost) {
+    // Entries pushed for airports already in the heap stand in for decrease-key.
+    if (METRICS_COMPILED) {
+        (stamps[id] == epoch ? counters.decrease_keys : counters.pushes)++;
     }
-    return rc_idx;
+    stamps[id] = epoch;
+    costs[id] = cost;
+    entries.push_back(make_pair(cost, id));
+    std::push_heap(entries.begin(), entries.end(), std::greater<pair<double, int>>());
 }
 
-bool Heap::has_child(int idx) const {
-    return get_lchild(idx) < ids.size();
+bool LazyHeap::empty() const {
+    return entries.empty();
 }
 
-unsigned long Heap::get_lchild(int idx) const {
-    return 2 * idx + 1;
+double LazyHeap::get_cost(int id) const {
+    return stamps[id] == epoch ? costs[id] : INF_COST;
 }
 
-unsigned long Heap::get_rchild(int idx) const {
-    return 2 * idx + 2;
+const HeapCounters &LazyHeap::get_counters() const {
+    return counters;
 }
 
-unsigned long Heap::get_parent(int idx) const {
-    return (idx - 1) / 2;
+void LazyHeap::discard_stale() {
+    while (!entries.empty() && entries.front().first != costs[entries.front().second]) {
+        std::pop_heap(entries.begin(), entries.end(), std::greater<pair<double, int>>());
+        entries.pop_back();
+    }
 }
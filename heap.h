@@ -1,29 +1,72 @@
 /**
  * @file heap.h
- * Definition of heap class.
- */ 
+ * Definition of heap classes.
+ */
 
 #pragma once
 
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
 
 #include "airport.h"
+#include "metrics.h"
 
 using namespace std;
 
+// Cost of an airport that has not been reached yet.
+const double INF_COST = numeric_limits<double>::infinity();
+
+// Priority queue implementations selectable by the graph algorithms.
+enum class HeapType { BINARY, QUATERNARY, PAIRING, LAZY };
+
 /**
- * Minimum priority queue to select the airport ID with the 
+ * Starts a new epoch of arrays whose entries are only valid when stamped
+ * with the current epoch, invalidating every entry in O(1). The stamps are
+ * only cleared when the size changes or the epoch wraps around.
+ * @param stamps Reference to vector of epoch stamps, one per airport.
+ * @param epoch Reference to current epoch, which is never 0.
+ * @param size Number of airports the stamps must cover.
+ */
+inline void advance_epoch(vector<unsigned> &stamps, unsigned &epoch, unsigned long size) {
+    if (stamps.size() != size || ++epoch == 0) {
+        stamps.assign(size, 0);
+        epoch = 1;
+    }
+}
+
+/**
+ * Minimum priority queue to select the airport ID with the
  * lowest cost that has not been visited yet.
+ *
+ * Every heap shares the same interface: airports are only inserted
+ * once they are first reached by update(), and the position of each
+ * airport in the heap is indexed so that decrease-key is O(log V).
+ * Costs and positions are stamped with the epoch of the search that
+ * set them, so reset() can start a new search without clearing them.
  * @author Vaibhav Gupta
- */ 
-class Heap {
+ */
+template <unsigned D>
+class DaryHeap {
     public:
+        // Constructor to create an empty heap, which must be reset before use.
+        DaryHeap();
+
         /**
          * Constructor to create a heap of airport IDs.
          * @param num_airports Number of airports/IDs.
          * @param start_id Starting airport ID, initialized to 0 cost.
-         */ 
-        Heap(int num_airports, int start_id);
+         */
+        DaryHeap(int num_airports, int start_id);
+
+        /**
+         * Empties the heap and forgets every cost for a new search,
+         * reusing its memory when the number of airports is unchanged.
+         * @param num_airports Number of airports/IDs.
+         * @param start_id Starting airport ID, initialized to 0 cost.
+         */
+        void reset(int num_airports, int start_id);
 
         /**
          * Removes and returns airport ID with the lowest cost.
@@ -32,40 +75,53 @@ class Heap {
         int pop();
 
         /**
-         * Updates cost of airport and corrects heap.
+         * Updates cost of airport and corrects heap, inserting the
+         * airport if it is not in the heap yet.
          * @param id Airport ID to be updated.
          * @param cost New cost of airport.
          */
-        void update(int id, float cost);
+        void update(int id, double cost);
+
+        /**
+         * Returns if the heap has no airports left to pop.
+         * @returns Boolean representing if heap is empty or not.
+         */
+        bool empty() const;
+
+        /**
+         * Returns the cost of a given airport.
+         * @param id Airport ID to return cost of.
+         * @returns Cost of airport, INF_COST if never reached.
+         */
+        double get_cost(int id) const;
+
+        /**
+         * Returns the operations performed by the heap since it was created.
+         * @returns Reference to heap counters.
+         */
+        const HeapCounters &get_counters() const;
 
         /**
          * Helper function to correct heap by moving a
          * low cost node up the tree.
          * @param idx Node index in airport IDs.
-         */ 
-        void heapify_up(int idx);
+         */
+        void heapify_up(unsigned long idx);
 
-         /**
+        /**
          * Helper function to correct heap by moving a
          * high cost node down the tree.
          * @param idx Node index in airport IDs.
-         */ 
-        void heapify_down(int idx);
-
-        /**
-         * Returns the cost of a given airport.
-         * @param id Airport ID to return cost of.
-         * @returns Cost of airport.
          */
-        double get_cost(int id) const;
+        void heapify_down(unsigned long idx);
 
         /**
-         * Helper function to return the index of the child 
+         * Helper function to return the index of the child
          * with the lowest cost of a given node.
          * @param idx Node index in airport IDs.
          * @returns Child index with the lowest cost.
          */
-        int get_min_child(int idx) const;
+        unsigned long get_min_child(unsigned long idx) const;
 
         /**
          * Helper function to determine if a given node has a
@@ -73,32 +129,329 @@ class Heap {
          * @param idx Node index in airport IDs.
          * @returns Boolean representing if node has a child or not.
          */
-        bool has_child(int idx) const;
+        bool has_child(unsigned long idx) const;
 
         /**
-         * Helper function to return the index of the left 
-         * child of a given node.
+         * Helper function to return the parent of a given node.
          * @param idx Node index in airport IDs.
-         * @returns Node index of left child in airport IDs.
+         * @returns Node index of parent in airport IDs.
          */
-        unsigned long get_lchild(int idx) const;
+        unsigned long get_parent(unsigned long idx) const;
 
+    private:
         /**
-         * Helper function to return the index of the right 
-         * child of a given node.
+         * Helper function to place an airport at a heap index and
+         * record its new position.
          * @param idx Node index in airport IDs.
-         * @returns Node index of right child in airport IDs.
+         * @param id Airport ID to place.
+         */
+        void place(unsigned long idx, int id);
+
+        vector<int> ids;
+        vector<int> slots;
+        vector<double> costs;
+        vector<unsigned> stamps;
+        unsigned epoch;
+        HeapCounters counters;
+};
+
+// Heap arities, with the 4-ary heap used by default.
+using BinaryHeap = DaryHeap<2>;
+using QuaternaryHeap = DaryHeap<4>;
+using Heap = QuaternaryHeap;
+
+/**
+ * Pairing heap with the same interface as DaryHeap, trading
+ * worse constants for O(1) amortized decrease-key.
+ * @author Vaibhav Gupta
+ */
+class PairingHeap {
+    public:
+        // Constructor to create an empty heap, which must be reset before use.
+        PairingHeap();
+
+        /**
+         * Constructor to create a heap of airport IDs.
+         * @param num_airports Number of airports/IDs.
+         * @param start_id Starting airport ID, initialized to 0 cost.
          */
-        unsigned long get_rchild(int idx) const;
+        PairingHeap(int num_airports, int start_id);
 
         /**
-         * Helper function to return the parent of a given node.
-         * @param idx Node index in airport IDs.
-         * @returns Node index of parent in airport IDs.
+         * Empties the heap and forgets every cost for a new search,
+         * reusing its memory when the number of airports is unchanged.
+         * @param num_airports Number of airports/IDs.
+         * @param start_id Starting airport ID, initialized to 0 cost.
+         */
+        void reset(int num_airports, int start_id);
+
+        /**
+         * Removes and returns airport ID with the lowest cost.
+         * @returns Airport ID with the lowest cost.
+         */
+        int pop();
+
+        /**
+         * Updates cost of airport and corrects heap, inserting the
+         * airport if it is not in the heap yet.
+         * @param id Airport ID to be updated.
+         * @param cost New cost of airport.
+         */
+        void update(int id, double cost);
+
+        /**
+         * Returns if the heap has no airports left to pop.
+         * @returns Boolean representing if heap is empty or not.
          */
-        unsigned long get_parent(int idx) const;
+        bool empty() const;
+
+        /**
+         * Returns the cost of a given airport.
+         * @param id Airport ID to return cost of.
+         * @returns Cost of airport, INF_COST if never reached.
+         */
+        double get_cost(int id) const;
+
+        /**
+         * Returns the operations performed by the heap since it was created.
+         * @returns Reference to heap counters.
+         */
+        const HeapCounters &get_counters() const;
 
     private:
-        vector<int> ids;
-        vector<double> costs; 
-};
\ No newline at end of file
+        /**
+         * Helper function to link two heap roots, making the root
+         * with the higher cost the first child of the other.
+         * @param a Airport ID of first root.
+         * @param b Airport ID of second root.
+         * @returns Airport ID of the resulting root.
+         */
+        int meld(int a, int b);
+
+        /**
+         * Helper function to detach a node and its subtree from
+         * its parent and siblings.
+         * @param id Airport ID of node to detach.
+         */
+        void cut(int id);
+
+        /**
+         * Helper function to merge the children of a removed root
+         * in two passes.
+         * @param first Airport ID of the first child.
+         * @returns Airport ID of the new root.
+         */
+        int merge_pairs(int first);
+
+        int root;
+        vector<int> child, sibling, prev;
+        vector<char> in_heap;
+        vector<double> costs;
+        vector<unsigned> stamps;
+        unsigned epoch;
+        HeapCounters counters;
+
+        // Roots melded by the first pass of merge_pairs(), kept to reuse memory.
+        vector<int> pairs;
+};
+
+/**
+ * Binary heap with lazy deletion: update() pushes a new entry instead
+ * of moving the existing one, and outdated entries are skipped when
+ * they reach the top. Needs no position index at all.
+ * @author Vaibhav Gupta
+ */
+class LazyHeap {
+    public:
+        // Constructor to create an empty heap, which must be reset before use.
+        LazyHeap();
+
+        /**
+         * Constructor to create a heap of airport IDs.
+         * @param num_airports Number of airports/IDs.
+         * @param start_id Starting airport ID, initialized to 0 cost.
+         */
+        LazyHeap(int num_airports, int start_id);
+
+        /**
+         * Empties the heap and forgets every cost for a new search,
+         * reusing its memory when the number of airports is unchanged.
+         * @param num_airports Number of airports/IDs.
+         * @param start_id Starting airport ID, initialized to 0 cost.
+         */
+        void reset(int num_airports, int start_id);
+
+        /**
+         * Removes and returns airport ID with the lowest cost.
+         * @returns Airport ID with the lowest cost.
+         */
+        int pop();
+
+        /**
+         * Updates cost of airport by pushing a new entry.
+         * @param id Airport ID to be updated.
+         * @param cost New cost of airport.
+         */
+        void update(int id, double cost);
+
+        /**
+         * Returns if the heap has no airports left to pop.
+         * @returns Boolean representing if heap is empty or not.
+         */
+        bool empty() const;
+
+        /**
+         * Returns the cost of a given airport.
+         * @param id Airport ID to return cost of.
+         * @returns Cost of airport, INF_COST if never reached.
+         */
+        double get_cost(int id) const;
+
+        /**
+         * Returns the operations performed by the heap since it was created.
+         * @returns Reference to heap counters.
+         */
+        const HeapCounters &get_counters() const;
+
+    private:
+        // Helper function to drop outdated entries from the top of the heap.
+        void discard_stale();
+
+        vector<pair<double, int>> entries;
+        vector<double> costs;
+        vector<unsigned> stamps;
+        unsigned epoch;
+        HeapCounters counters;
+};
+
+template <unsigned D>
+DaryHeap<D>::DaryHeap() {
+    static_assert(D >= 2, "heap arity must be at least 2");
+    epoch = 0;
+}
+
+template <unsigned D>
+DaryHeap<D>::DaryHeap(int num_airports, int start_id) : DaryHeap() {
+    reset(num_airports, start_id);
+}
+
+template <unsigned D>
+void DaryHeap<D>::reset(int num_airports, int start_id) {
+    advance_epoch(stamps, epoch, num_airports);
+    slots.resize(num_airports);
+    costs.resize(num_airports);
+    ids.clear();
+    update(start_id, 0);
+}
+
+template <unsigned D>
+int DaryHeap<D>::pop() {
+    int id = ids[0];
+    slots[id] = -1;
+    if (METRICS_COMPILED) {
+        counters.pops++;
+    }
+    if (ids.size() > 1) {
+        place(0, ids.back());
+    }
+    ids.pop_back();
+
+    heapify_down(0);
+    return id;
+}
+
+template <unsigned D>
+void DaryHeap<D>::update(int id, double cost) {
+    if (stamps[id] != epoch) {
+        stamps[id] = epoch;
+        slots[id] = -1;
+    }
+    costs[id] = cost;
+    if (slots[id] == -1) {
+        ids.push_back(id);
+        slots[id] = ids.size() - 1;
+        if (METRICS_COMPILED) {
+            counters.pushes++;
+        }
+    } else if (METRICS_COMPILED) {
+        counters.decrease_keys++;
+    }
+    heapify_up(slots[id]);
+}
+
+template <unsigned D>
+bool DaryHeap<D>::empty() const {
+    return ids.empty();
+}
+
+template <unsigned D>
+double DaryHeap<D>::get_cost(int id) const {
+    return stamps[id] == epoch ? costs[id] : INF_COST;
+}
+
+template <unsigned D>
+const HeapCounters &DaryHeap<D>::get_counters() const {
+    return counters;
+}
+
+template <unsigned D>
+void DaryHeap<D>::heapify_up(unsigned long idx) {
+    int id = ids[idx];
+    while (idx > 0) {
+        unsigned long parent_idx = get_parent(idx);
+        if (!(costs[id] < costs[ids[parent_idx]])) {
+            break;
+        }
+        place(idx, ids[parent_idx]);
+        idx = parent_idx;
+    }
+    place(idx, id);
+}
+
+template <unsigned D>
+void DaryHeap<D>::heapify_down(unsigned long idx) {
+    if (idx >= ids.size()) {
+        return;
+    }
+
+    int id = ids[idx];
+    while (has_child(idx)) {
+        unsigned long child_idx = get_min_child(idx);
+        if (!(costs[ids[child_idx]] < costs[id])) {
+            break;
+        }
+        place(idx, ids[child_idx]);
+        idx = child_idx;
+    }
+    place(idx, id);
+}
+
+template <unsigned D>
+unsigned long DaryHeap<D>::get_min_child(unsigned long idx) const {
+    unsigned long first = D * idx + 1;
+    unsigned long last = std::min(first + D, (unsigned long)ids.size());
+
+    unsigned long min_idx = first;
+    for (unsigned long i = first + 1; i < last; i++) {
+        if (costs[ids[i]] < costs[ids[min_idx]]) {
+            min_idx = i;
+        }
+    }
+    return min_idx;
+}
+
+template <unsigned D>
+bool DaryHeap<D>::has_child(unsigned long idx) const {
+    return D * idx + 1 < ids.size();
+}
+
+template <unsigned D>
+unsigned long DaryHeap<D>::get_parent(unsigned long idx) const {
+    return (idx - 1) / D;
+}
+
+template <unsigned D>
+void DaryHeap<D>::place(unsigned long idx, int id) {
+    ids[idx] = id;
+    slots[id] = idx;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file hub_labels.cpp
+ * Implementation of hub labeling distance oracle class.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#include "hub_labels.h"
+
+static const char MAGIC[8] = {'A', 'I', 'R', 'L', 'A', 'B', 'E', 'L'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * Fixed-size header at the start of every label file, followed by the
+ * offsets, hubs and costs of the outgoing and then the incoming labels.
+ */
+struct HubLabelsHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    DatasetFingerprint dataset;
+    uint64_t num_airports, num_routes, num_out_entries, num_in_entries;
+};
+
+void HubLabels::build(const CSR &csr, const CSR &reverse_csr) {
+    unsigned long n = csr.num_airports();
+
+    // Airports with the most routes in either direction lie on the most
+    // shortest paths, so making them hubs first prunes the most.
+    vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    auto degree = [&](int id) {
+        return csr.get_end(id) - csr.get_begin(id) +
+            reverse_csr.get_end(id) - reverse_csr.get_begin(id);
+    };
+    std::stable_sort(order.begin(), order.end(),
+        [&](int a, int b) { return degree(a) > degree(b); });
+
+    // Hubs are added in increasing rank, which keeps every label sorted.
+    vector<vector<pair<int, double>>> out(n), in(n);
+    vector<double> hub_costs(n, INF_COST);
+    Heap heap;
+    for (unsigned long rank = 0; rank < n; rank++) {
+        int hub_id = order[rank];
+        prune_search(csr, hub_id, rank, out[hub_id], in, hub_costs, heap);
+        prune_search(reverse_csr, hub_id, rank, in[hub_id], out, hub_costs, heap);
+    }
+
+    auto flatten = [n](vector<vector<pair<int, double>>> &labels, LabelSet &set) {
+        set.offsets.assign(1, 0);
+        set.hubs.clear();
+        set.costs.clear();
+        for (unsigned long v = 0; v < n; v++) {
+            for (const pair<int, double> &entry : labels[v]) {
+                set.hubs.push_back(entry.first);
+                set.costs.push_back(entry.second);
+            }
+            set.offsets.push_back(set.hubs.size());
+            vector<pair<int, double>>().swap(labels[v]);
+        }
+    };
+    flatten(out, out_labels);
+    flatten(in, in_labels);
+}
+
+void HubLabels::prune_search(const CSR &adjacency, int hub_id, int rank,
+        const vector<pair<int, double>> &hub_label, vector<vector<pair<int, double>>> &labels,
+        vector<double> &hub_costs, Heap &heap) {
+    for (const pair<int, double> &entry : hub_label) {
+        hub_costs[entry.first] = entry.second;
+    }
+
+    heap.reset(adjacency.num_airports(), hub_id);
+    while (!heap.empty()) {
+        int current = heap.pop();
+        double cost = heap.get_cost(current);
+
+        // Airports whose cost earlier hubs already give need no label
+        // entry, and neither do the airports beyond them.
+        bool covered = false;
+        for (const pair<int, double> &entry : labels[current]) {
+            if (hub_costs[entry.first] + entry.second <= cost) {
+                covered = true;
+                break;
+            }
+        }
+        if (covered) {
+            continue;
+        }
+        labels[current].emplace_back(rank, cost);
+
+        for (unsigned e = adjacency.get_begin(current); e < adjacency.get_end(current); e++) {
+            int next_id = adjacency.get_dest(e);
+            if (cost + adjacency.get_weight(e) < heap.get_cost(next_id)) {
+                heap.update(next_id, cost + adjacency.get_weight(e));
+            }
+        }
+    }
+
+    for (const pair<int, double> &entry : hub_label) {
+        hub_costs[entry.first] = INF_COST;
+    }
+}
+
+bool HubLabels::save(const string &file_path, const CSR &csr,
+        const DatasetFingerprint &dataset) const {
+    HubLabelsHeader header = HubLabelsHeader();
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.dataset = dataset;
+    header.num_airports = csr.num_airports();
+    header.num_routes = csr.num_routes();
+    header.num_out_entries = out_labels.hubs.size();
+    header.num_in_entries = in_labels.hubs.size();
+
+    const string temp_path = file_path + ".tmp";
+    ofstream file(temp_path, ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const LabelSet *set : {&out_labels, &in_labels}) {
+        file.write(reinterpret_cast<const char*>(set -> offsets.data()),
+            set -> offsets.size() * sizeof(unsigned));
+        file.write(reinterpret_cast<const char*>(set -> hubs.data()),
+            set -> hubs.size() * sizeof(int));
+        file.write(reinterpret_cast<const char*>(set -> costs.data()),
+            set -> costs.size() * sizeof(double));
+    }
+    file.close();
+    if (!file) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return std::rename(temp_path.c_str(), file_path.c_str()) == 0;
+}
+
+bool HubLabels::load(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset) {
+    ifstream file(file_path, ios::binary);
+    HubLabelsHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+            header.byte_order != BYTE_ORDER_MARK || !dataset.matches(header.dataset) ||
+            header.num_airports != csr.num_airports() || header.num_routes != csr.num_routes() ||
+            header.num_out_entries > header.num_airports * header.num_airports ||
+            header.num_in_entries > header.num_airports * header.num_airports) {
+        return false;
+    }
+
+    unsigned long n = header.num_airports;
+    LabelSet sets[2];
+    unsigned long num_entries[2] = {header.num_out_entries, header.num_in_entries};
+    for (int i = 0; i < 2; i++) {
+        LabelSet &set = sets[i];
+        set.offsets.resize(n + 1);
+        set.hubs.resize(num_entries[i]);
+        set.costs.resize(num_entries[i]);
+        file.read(reinterpret_cast<char*>(set.offsets.data()), (n + 1) * sizeof(unsigned));
+        file.read(reinterpret_cast<char*>(set.hubs.data()), num_entries[i] * sizeof(int));
+        file.read(reinterpret_cast<char*>(set.costs.data()), num_entries[i] * sizeof(double));
+        if (!file || set.offsets[0] != 0 || set.offsets[n] != num_entries[i]) {
+            return false;
+        }
+
+        // Queries merge labels by hub rank, so every label must be sorted.
+        for (unsigned long v = 0; v < n; v++) {
+            if (set.offsets[v] > set.offsets[v + 1]) {
+                return false;
+            }
+            for (unsigned e = set.offsets[v]; e < set.offsets[v + 1]; e++) {
+                if (set.hubs[e] < 0 || (unsigned long)set.hubs[e] >= n ||
+                        (e > set.offsets[v] && set.hubs[e] <= set.hubs[e - 1])) {
+                    return false;
+                }
+            }
+        }
+    }
+    if (file.peek() != EOF) {
+        return false;
+    }
+
+    out_labels = std::move(sets[0]);
+    in_labels = std::move(sets[1]);
+    return true;
+}
+
+bool HubLabels::find_path(const CSR &csr, int src_id, int dest_id, SearchContext &context) const {
+    double remaining = cost(src_id, dest_id);
+    if (remaining == INF_COST) {
+        return false;
+    }
+
+    // A shortest path has fewer routes than airports, which also stops
+    // cycles of routes that cost nothing from being followed forever.
+    unsigned long num_routes = 0;
+    for (int current = src_id; current != dest_id; num_routes++) {
+        if (num_routes == csr.num_airports()) {
+            return false;
+        }
+        context.scan(csr.get_end(current) - csr.get_begin(current));
+
+        // Routes costing more than the best found so far cannot improve
+        // it, and any route reaching the remaining cost is on a shortest path.
+        double best = INF_COST;
+        unsigned best_route = 0;
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current) && best > remaining; e++) {
+            int next_id = csr.get_dest(e);
+            if (next_id == current || csr.get_weight(e) >= best) {
+                continue;
+            }
+            double curr_cost = csr.get_weight(e) + cost(next_id, dest_id);
+            if (curr_cost < best) {
+                best = curr_cost;
+                best_route = e;
+            }
+        }
+        if (best == INF_COST) {
+            return false;
+        }
+        context.append_route(best_route);
+        current = csr.get_dest(best_route);
+        remaining = cost(current, dest_id);
+    }
+    return true;
+}
+
+void HubLabels::clear() {
+    out_labels = LabelSet();
+    in_labels = LabelSet();
+}
+
+bool HubLabels::empty() const {
+    return out_labels.offsets.empty();
+}
+
+unsigned long HubLabels::num_entries() const {
+    return out_labels.hubs.size() + in_labels.hubs.size();
+}
+
+unsigned long HubLabels::max_label_size() const {
+    unsigned long largest = 0;
+    for (const LabelSet *set : {&out_labels, &in_labels}) {
+        for (unsigned long v = 0; v + 1 < set -> offsets.size(); v++) {
+            largest = std::max(largest, (unsigned long)(set -> offsets[v + 1] - set -> offsets[v]));
+        }
+    }
+    return largest;
+}
+
+unsigned long HubLabels::bytes() const {
+    unsigned long total = 0;
+    for (const LabelSet *set : {&out_labels, &in_labels}) {
+        total += set -> offsets.size() * sizeof(unsigned) + set -> hubs.size() * sizeof(int) +
+            set -> costs.size() * sizeof(double);
+    }
+    return total;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file hub_labels.h
+ * Definition of hub labeling distance oracle class.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "heap.h"
+#include "csr.h"
+#include "search.h"
+#include "snapshot.h"
+
+using namespace std;
+
+/**
+ * Exact shortest-path costs between any two airports from a 2-hop labeling
+ * built by pruned landmark labeling (PLL).
+ *
+ * Every airport keeps an outgoing label of hubs it can reach and an
+ * incoming label of hubs that reach it, each with the cost of the shortest
+ * path. Labels are chosen so that every shortest path passes through a hub
+ * common to both labels, so the cost between two airports is the smallest
+ * sum over the hubs they share. Airports become hubs in order of their
+ * number of routes, and the Dijkstra search of each hub stops at airports
+ * whose cost the labels of earlier hubs already give, keeping labels small
+ * on hub-and-spoke networks. Labels are stored sorted by hub rank, so a
+ * query is a single merge of two short arrays without any graph traversal.
+ * @author Vaibhav Gupta
+ */
+class HubLabels {
+    public:
+        // Version of the file layout, increased on every incompatible change.
+        static const uint32_t VERSION = 2;
+
+        /**
+         * Computes the labels of every airport, replacing any previous index.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph of the same graph.
+         */
+        void build(const CSR &csr, const CSR &reverse_csr);
+
+        /**
+         * Writes the labels to a binary file. The file is written under a
+         * temporary name and renamed.
+         * @param file_path File path to write.
+         * @param csr Reference to CSR graph the labels were built from.
+         * @param dataset Fingerprint of the dataset the graph was read from.
+         * @returns Boolean representing if the file was written or not.
+         */
+        bool save(const string &file_path, const CSR &csr,
+            const DatasetFingerprint &dataset) const;
+
+        /**
+         * Reads labels written by save(), rejecting files built from another
+         * graph or dataset.
+         * @param file_path File path to read.
+         * @param csr Reference to CSR graph the labels must match.
+         * @param dataset Fingerprint the labels must have been written from,
+         * or an empty fingerprint to accept any dataset.
+         * @returns Boolean representing if the file was loaded or not.
+         */
+        bool load(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset);
+
+        /**
+         * Returns the cost of the shortest path between two airports.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @returns Cost of shortest path, INF_COST if unreachable.
+         */
+        double cost(int src_id, int dest_id) const;
+
+        /**
+         * Finds a shortest path between two airports and appends its route
+         * indices to the path of a search context. Each step follows the
+         * route whose cost plus the remaining cost from its destination is
+         * lowest, so no priority queue is needed.
+         * @param csr Reference to CSR graph the labels were built from.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context to append the path to.
+         * @returns Boolean representing if the destination was reached or not.
+         */
+        bool find_path(const CSR &csr, int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Removes the labels, which must be rebuilt after the graph changes.
+         */
+        void clear();
+
+        /**
+         * Returns if no labels have been built or loaded.
+         * @returns Boolean representing if index is empty or not.
+         */
+        bool empty() const;
+
+        /**
+         * Returns the number of hubs in every label combined.
+         * @returns Number of label entries.
+         */
+        unsigned long num_entries() const;
+
+        /**
+         * Returns the number of hubs in the largest label.
+         * @returns Number of entries of the largest label.
+         */
+        unsigned long max_label_size() const;
+
+        /**
+         * Returns the memory used by the index.
+         * @returns Number of bytes.
+         */
+        unsigned long bytes() const;
+
+    private:
+        /**
+         * Labels of one direction for every airport, stored consecutively
+         * with the hubs of each airport in increasing rank.
+         */
+        struct LabelSet {
+            vector<unsigned> offsets;
+            vector<int> hubs;
+            vector<double> costs;
+        };
+
+        /**
+         * Helper function to run the pruned Dijkstra search of one hub and
+         * add it to the labels of every airport it is not pruned at.
+         * @param adjacency Reference to CSR graph, or its reverse to find
+         * the airports reaching the hub.
+         * @param hub_id ID of hub airport.
+         * @param rank Rank of hub airport.
+         * @param hub_label Reference to label of the hub in the direction
+         * opposite to the search, whose costs are known to the search.
+         * @param labels Reference to labels of each airport to add the hub to.
+         * @param hub_costs Reference to cost of each earlier hub from or to
+         * the hub, INF_COST when unknown, reset before returning.
+         * @param heap Reference to heap to search with.
+         */
+        static void prune_search(const CSR &adjacency, int hub_id, int rank,
+            const vector<pair<int, double>> &hub_label, vector<vector<pair<int, double>>> &labels,
+            vector<double> &hub_costs, Heap &heap);
+
+        LabelSet out_labels;
+        LabelSet in_labels;
+};
+
+inline double HubLabels::cost(int src_id, int dest_id) const {
+    unsigned i = out_labels.offsets[src_id], i_end = out_labels.offsets[src_id + 1];
+    unsigned j = in_labels.offsets[dest_id], j_end = in_labels.offsets[dest_id + 1];
+    const int *out_hubs = out_labels.hubs.data(), *in_hubs = in_labels.hubs.data();
+
+    double best = INF_COST;
+    while (i < i_end && j < j_end) {
+        if (out_hubs[i] < in_hubs[j]) {
+            i++;
+        } else if (out_hubs[i] > in_hubs[j]) {
+            j++;
+        } else {
+            double curr_cost = out_labels.costs[i++] + in_labels.costs[j++];
+            if (curr_cost < best) {
+                best = curr_cost;
+            }
+        }
+    }
+    return best;
+}
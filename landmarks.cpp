@@ -0,0 +1,190 @@
+/**
+ * @file landmarks.cpp
+ * Implementation of landmark distance table class.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#include "landmarks.h"
+
+static const char MAGIC[8] = {'A', 'I', 'R', 'L', 'M', 'A', 'R', 'K'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * Fixed-size header at the start of every landmark file, followed by the
+ * landmark IDs and the tables of costs from and to the landmarks.
+ */
+struct LandmarksHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    DatasetFingerprint dataset;
+    uint64_t num_airports, num_routes, num_landmarks;
+};
+
+void Landmarks::build(const CSR &csr, unsigned num_landmarks, LandmarkSelection selection,
+        ThreadPool &pool) {
+    unsigned long n = csr.num_airports();
+    unsigned long k = std::min((unsigned long)num_landmarks, n);
+    CSR reverse;
+    reverse.build_reverse(csr);
+
+    // Airports with the most routes in either direction come first.
+    vector<int> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    auto degree = [&](int id) {
+        return csr.get_end(id) - csr.get_begin(id) + reverse.get_end(id) - reverse.get_begin(id);
+    };
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+        [&](int a, int b) { return degree(a) > degree(b); });
+
+    landmarks.clear();
+    if (selection == LandmarkSelection::DEGREE) {
+        landmarks.assign(by_degree.begin(), by_degree.begin() + k);
+    } else if (k > 0) {
+        // Starting at the busiest hub, each landmark is the airport farthest
+        // from every landmark chosen so far among those they can reach.
+        vector<double> nearest(n, INF_COST);
+        vector<char> chosen(n, false);
+        int next = by_degree[0];
+        while (true) {
+            landmarks.push_back(next);
+            chosen[next] = true;
+            if (landmarks.size() == k) {
+                break;
+            }
+
+            vector<double> costs = search(csr, next);
+            next = -1;
+            for (unsigned long v = 0; v < n; v++) {
+                nearest[v] = std::min(nearest[v], costs[v]);
+                if (!chosen[v] && nearest[v] < INF_COST && 
+                        (next == -1 || nearest[v] > nearest[next])) {
+                    next = v;
+                }
+            }
+
+            // Airports unreachable from every landmark fall back to degree order.
+            for (unsigned long i = 0; next == -1 || nearest[next] == 0; i++) {
+                if (!chosen[by_degree[i]]) {
+                    next = by_degree[i];
+                    break;
+                }
+            }
+        }
+    }
+
+    from_landmark.assign(n * k, INF_COST);
+    to_landmark.assign(n * k, INF_COST);
+    pool.parallel_for(2 * k, [&](unsigned long idx) {
+        unsigned long landmark = idx % k;
+        bool forward = idx < k;
+        vector<double> costs = search(forward ? csr : reverse, landmarks[landmark]);
+
+        vector<double> &table = forward ? from_landmark : to_landmark;
+        for (unsigned long v = 0; v < n; v++) {
+            table[v * k + landmark] = costs[v];
+        }
+    });
+}
+
+bool Landmarks::save(const string &file_path, const CSR &csr,
+        const DatasetFingerprint &dataset) const {
+    LandmarksHeader header = LandmarksHeader();
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.dataset = dataset;
+    header.num_airports = csr.num_airports();
+    header.num_routes = csr.num_routes();
+    header.num_landmarks = landmarks.size();
+
+    const string temp_path = file_path + ".tmp";
+    ofstream file(temp_path, ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(landmarks.data()), landmarks.size() * sizeof(int));
+    file.write(reinterpret_cast<const char*>(from_landmark.data()),
+        from_landmark.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(to_landmark.data()),
+        to_landmark.size() * sizeof(double));
+    file.close();
+    if (!file) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return std::rename(temp_path.c_str(), file_path.c_str()) == 0;
+}
+
+bool Landmarks::load(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset) {
+    ifstream file(file_path, ios::binary);
+    LandmarksHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+            header.byte_order != BYTE_ORDER_MARK || !dataset.matches(header.dataset) ||
+            header.num_airports != csr.num_airports() || header.num_routes != csr.num_routes() ||
+            header.num_landmarks > header.num_airports) {
+        return false;
+    }
+
+    unsigned long n = header.num_airports, k = header.num_landmarks;
+    vector<int> ids(k);
+    vector<double> from(n * k), to(n * k);
+    file.read(reinterpret_cast<char*>(ids.data()), k * sizeof(int));
+    file.read(reinterpret_cast<char*>(from.data()), n * k * sizeof(double));
+    file.read(reinterpret_cast<char*>(to.data()), n * k * sizeof(double));
+    if (!file || file.peek() != EOF) {
+        return false;
+    }
+    for (int id : ids) {
+        if (id < 0 || (unsigned long)id >= n) {
+            return false;
+        }
+    }
+
+    landmarks = std::move(ids);
+    from_landmark = std::move(from);
+    to_landmark = std::move(to);
+    return true;
+}
+
+const vector<int> &Landmarks::get_landmarks() const {
+    return landmarks;
+}
+
+void Landmarks::clear() {
+    landmarks.clear();
+    from_landmark.clear();
+    to_landmark.clear();
+}
+
+bool Landmarks::empty() const {
+    return landmarks.empty();
+}
+
+vector<double> Landmarks::search(const CSR &csr, int src_id) {
+    Heap heap(csr.num_airports(), src_id);
+    while (!heap.empty()) {
+        int current = heap.pop();
+        double cost = heap.get_cost(current);
+        for (unsigned e = csr.get_begin(current); e < csr.get_end(current); e++) {
+            int dest_id = csr.get_dest(e);
+            if (cost + csr.get_weight(e) < heap.get_cost(dest_id)) {
+                heap.update(dest_id, cost + csr.get_weight(e));
+            }
+        }
+    }
+
+    vector<double> costs(csr.num_airports());
+    for (unsigned long v = 0; v < costs.size(); v++) {
+        costs[v] = heap.get_cost(v);
+    }
+    return costs;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file landmarks.h
+ * Definition of landmark distance table class.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "heap.h"
+#include "csr.h"
+#include "snapshot.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// Strategies for choosing landmark airports.
+enum class LandmarkSelection { DEGREE, FARTHEST };
+
+/**
+ * Shortest-path costs from and to a small set of landmark airports, used as
+ * an A* heuristic by the triangle inequality (ALT).
+ *
+ * For any landmark L, the cost of the shortest path from airport v to t is
+ * at least d(L, t) - d(L, v) and d(v, L) - d(t, L), so the largest of these
+ * bounds over all landmarks is a lower bound that never overestimates.
+ * Tables are stored airport-major, keeping the costs of one airport to every
+ * landmark together.
+ * @author Vaibhav Gupta
+ */
+class Landmarks {
+    public:
+        // Version of the file layout, increased on every incompatible change.
+        static const uint32_t VERSION = 2;
+
+        /**
+         * Chooses landmarks and computes their cost tables with one forward
+         * and one reverse Dijkstra search per landmark.
+         * @param csr Reference to CSR graph.
+         * @param num_landmarks Number of landmarks, capped at the number
+         * of airports.
+         * @param selection Strategy used to choose landmarks.
+         * @param pool Reference to thread pool to search landmarks on.
+         */
+        void build(const CSR &csr, unsigned num_landmarks, LandmarkSelection selection,
+            ThreadPool &pool);
+
+        /**
+         * Writes the landmarks and cost tables to a binary file. The file is
+         * written under a temporary name and renamed.
+         * @param file_path File path to write.
+         * @param csr Reference to CSR graph the tables were built from.
+         * @param dataset Fingerprint of the dataset the graph was read from.
+         * @returns Boolean representing if the file was written or not.
+         */
+        bool save(const string &file_path, const CSR &csr,
+            const DatasetFingerprint &dataset) const;
+
+        /**
+         * Reads landmarks and cost tables written by save(), rejecting files
+         * built from another graph or dataset.
+         * @param file_path File path to read.
+         * @param csr Reference to CSR graph the tables must match.
+         * @param dataset Fingerprint the tables must have been written from,
+         * or an empty fingerprint to accept any dataset.
+         * @returns Boolean representing if the file was loaded or not.
+         */
+        bool load(const string &file_path, const CSR &csr, const DatasetFingerprint &dataset);
+
+        /**
+         * Returns a lower bound on the cost of the shortest path between
+         * two airports.
+         * @param id Airport ID the path starts at.
+         * @param dest_id Airport ID the path ends at.
+         * @returns Lower bound on the cost, 0 if nothing is known.
+         */
+        double lower_bound(int id, int dest_id) const;
+
+        /**
+         * Returns the IDs of the landmark airports.
+         * @returns Reference to vector of landmark IDs.
+         */
+        const vector<int> &get_landmarks() const;
+
+        /**
+         * Removes the landmarks, which must be rebuilt after the graph changes.
+         */
+        void clear();
+
+        /**
+         * Returns if no landmarks have been built or loaded.
+         * @returns Boolean representing if there are no landmarks or not.
+         */
+        bool empty() const;
+
+    private:
+        /**
+         * Helper function to compute the cost of the shortest path from an
+         * airport to every other airport.
+         * @param csr Reference to CSR graph, or its reverse for the costs
+         * of the shortest paths to the airport.
+         * @param src_id ID of airport to search from.
+         * @returns Cost of each airport, INF_COST if unreachable.
+         */
+        static vector<double> search(const CSR &csr, int src_id);
+
+        vector<int> landmarks;
+        vector<double> from_landmark;
+        vector<double> to_landmark;
+};
+
+inline double Landmarks::lower_bound(int id, int dest_id) const {
+    unsigned long k = landmarks.size();
+    const double *from_v = from_landmark.data() + id * k;
+    const double *from_t = from_landmark.data() + dest_id * k;
+    const double *to_v = to_landmark.data() + id * k;
+    const double *to_t = to_landmark.data() + dest_id * k;
+
+    // Infinite costs give infinite or undefined differences and are skipped.
+    double bound = 0;
+    for (unsigned long l = 0; l < k; l++) {
+        double forward = from_t[l] - from_v[l], backward = to_v[l] - to_t[l];
+        if (forward > bound && forward < INF_COST) {
+            bound = forward;
+        }
+        if (backward > bound && backward < INF_COST) {
+            bound = backward;
+        }
+    }
+    return bound;
+}
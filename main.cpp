@@ -1,11 +1,25 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <chrono>
+#include <cstdlib>
 
 #include "graph.h"
+#include "queries.h"
+#include "server.h"
+#include "batch.h"
 
 using namespace std;
 
+// Memory budget of the shortest-path trees cached by the query server.
+const unsigned long SERVER_PATH_CACHE_BYTES = 64ul << 20;
+
+// Default error and failure probability of approximate centrality. An
+// error of 0.01 needs tens of thousands of samples, slower than Brandes'
+// Algorithm below many thousands of airports.
+const double DEFAULT_EPSILON = 0.05;
+const double DEFAULT_DELTA = 0.1;
+
 string get_input(const string &prompt) {
     string input;
     cout << prompt << ": ";
@@ -14,16 +28,23 @@ string get_input(const string &prompt) {
 }
 
 int get_airport(const Graph &graph, const string &prompt) {
+    vector<Airport*> airports = graph.get_airports();
     string city = get_input(prompt);
     vector<int> city_airports = graph.get_airports_in_city(city);
 
     while (city_airports.empty()) {
         cout << "No Airports Found" << endl;
+        vector<int> suggestions = graph.search_airports(city, 5);
+        if (!suggestions.empty()) {
+            cout << "Did You Mean:" << endl;
+            for (int id : suggestions) {
+                cout << "    " << airports[id] << " in " << airports[id] -> get_city() << endl;
+            }
+        }
         city = get_input(prompt);
         city_airports = graph.get_airports_in_city(city);
     }
 
-    vector<Airport*> airports = graph.get_airports();
     for (unsigned int i = 0; i < city_airports.size(); i++) {
         cout << "[" << i + 1 << "] " << airports[city_airports[i]] << endl;
     }
@@ -44,25 +65,39 @@ int get_airport(const Graph &graph, const string &prompt) {
     return city_airports[airport - 1];
 }
 
+bool parse_probability(const string &input, double &value) {
+    char *end = NULL;
+    value = std::strtod(input.c_str(), &end);
+    return !input.empty() && *end == '\0' && value > 0 && value < 1;
+}
+
+double get_probability(const string &prompt, double default_value) {
+    stringstream full_prompt;
+    full_prompt << prompt << " [" << default_value << "]";
+    string input = get_input(full_prompt.str());
+    double value = default_value;
+    while (!input.empty() && !parse_probability(input, value)) {
+        cout << "Must Be Between 0 and 1" << endl;
+        input = get_input(full_prompt.str());
+    }
+    return input.empty() ? default_value : value;
+}
+
 void run_dijkstra(const Graph &graph, const vector<int> &dest_ids) {
     const string file_path = "data/path-routes.txt";
 
-    vector<Route*> path = graph.dijkstra(dest_ids);
-    if (path.empty()) {
+    PathResult path = find_path(graph, dest_ids);
+    if (path.routes.empty()) {
         cout << "No Path Found" << endl;
-    } else if (path.back() -> get_dest() -> get_id() != dest_ids.back()) {
+    } else if (!path.complete) {
         cout << "Partially Complete Path Found:" << endl;
     } else {
-        double cost = 0;
-        for (Route *route : path) {
-            cost += route -> get_weight();
-        }
-        cout << "Complete Path Found in " << path.size() 
-            << " Route(s) at " << cost << " Cost:" << endl;
+        cout << "Complete Path Found in " << path.routes.size() 
+            << " Route(s) at " << path.cost << " Cost:" << endl;
     }
 
     ofstream file(file_path);
-    for (Route *route : path) {
+    for (Route *route : path.routes) {
         cout << route << endl;
         file << route << endl;
     }
@@ -73,44 +108,117 @@ void run_dijkstra(const Graph &graph, const vector<int> &dest_ids) {
 void run_prim_mst(const Graph &graph, int start_id) {
     const string file_path = "data/mst-routes.txt";
 
-    Graph mst;
-    vector<Route*> tree = graph.prim_mst(mst, start_id);
+    TreeResult tree = find_tree(graph, start_id);
 
-    double cost = 0;
     stringstream missing;
-    vector<Airport*> airports = mst.get_airports();
-    for (unsigned int i = 0; i < airports.size(); i++) {
-        if (airports[i] != NULL) {
-            for (Route *route : airports[i] -> get_routes()) {
-                cost += route -> get_weight();
-            }
-        } else {
-            missing << i << " ";
-        }
+    for (int id : tree.missing) {
+        missing << id << " ";
     }
 
-    float coverage = 100.0 * (tree.size() + 1) / airports.size();
-    cout << "Contains " << tree.size() + 1 << " Airports (" << coverage 
-            << "% Coverage)" << " at " << cost << " Cost" << endl;
+    cout << "Contains " << tree.routes.size() + 1 << " Airports (" << tree.coverage 
+            << "% Coverage)" << " at " << tree.cost << " Cost" << endl;
     cout << "Missing Airports: " << missing.str() << endl;
 
     ofstream file(file_path);
-    for (Route *route : tree) {
+    for (Route *route : tree.routes) {
         file << route << endl;
     }
     file.close();
     cout << endl << "Saved MST routes to " << file_path << endl;
 }
 
-void run_floyd_warshall(const Graph &graph) {
+void run_coverage(const Graph &graph, int start_id) {
+    CoverageResult coverage = find_coverage(graph, start_id);
+
+    stringstream missing;
+    for (int id : coverage.missing) {
+        missing << id << " ";
+    }
+
+    cout << "Reaches " << coverage.num_reachable << " Airports (" << coverage.coverage
+        << "% Coverage)" << endl;
+    cout << "Missing Airports: " << missing.str() << endl;
+}
+
+void run_spanning_forest(const Graph &graph) {
+    const string file_path = "data/msf-routes.txt";
+
+    ForestResult forest = find_forest(graph);
+
+    unsigned long single = 0;
+    for (const ForestComponent &component : forest.components) {
+        if (component.num_airports > 1) {
+            cout << "Component of Airport " << component.root_id << ": " 
+                << component.num_airports << " Airports at " << component.cost << " Cost" << endl;
+        } else {
+            single++;
+        }
+    }
+    cout << "Contains " << forest.components.size() << " Component(s) (" << single 
+        << " Single Airport(s)) at " << forest.cost << " Cost" << endl;
+
+    ofstream file(file_path);
+    for (Route *route : forest.routes) {
+        file << route << endl;
+    }
+    file.close();
+    cout << endl << "Saved MSF routes to " << file_path << endl;
+}
+
+int run_batch(const Graph &graph, const string &query_path, const string &file_path) {
+    BatchRouter router(graph);
+    vector<vector<int>> queries;
+    if (!router.read_queries(query_path, queries)) {
+        cerr << "Could not open " << query_path << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<PathResult> paths = router.route(queries);
+    auto end = chrono::steady_clock::now();
+    double time = chrono::duration<double, milli>(end - start).count();
+
+    unsigned long complete = 0;
+    ofstream file(file_path);
+    for (unsigned long i = 0; i < queries.size(); i++) {
+        for (unsigned long j = 0; j < queries[i].size(); j++) {
+            file << (j > 0 ? " " : "") << queries[i][j];
+        }
+
+        const PathResult &path = paths[i];
+        if (path.routes.empty() && !path.complete) {
+            file << ": No Path Found" << endl;
+        } else {
+            file << ": " << (path.complete ? "Complete" : "Partially Complete") << " Path in "
+                << path.routes.size() << " Route(s) at " << path.cost << " Cost" << endl;
+        }
+        for (Route *route : path.routes) {
+            file << route << endl;
+        }
+        complete += path.complete;
+    }
+    file.close();
+
+    cout << "Routed " << queries.size() << " queries (" << router.num_legs() << " legs from "
+        << router.num_sources() << " origins) in " << time << "ms on " << router.num_threads()
+        << " thread(s), " << (time > 0 ? 1000 * queries.size() / time : 0) << " queries/s" << endl;
+    cout << "Complete Paths Found for " << complete << " of " << queries.size() << " queries" << endl;
+    cout << endl << "Saved batch routes to " << file_path << endl;
+    return 0;
+}
+
+void save_centralities(const Graph &graph, const vector<double> &scores) {
     const string file_path = "data/airport-centralities.txt";
-    vector<double> scores = graph.floyd_warshall();
     vector<Airport*> airports = graph.get_airports();
 
     int min = -1, max = -1;
-    int zero_centrality = 0;
+    int zero_centrality = 0, num_airports = 0;
     double total_centrality = 0;
     for (unsigned long i = 0; i < airports.size(); i++) {
+        if (airports[i] == NULL) {
+            continue;
+        }
+        num_airports++;
         total_centrality += scores[i];
         if (scores[i] == 0) {
             zero_centrality++;
@@ -120,7 +228,7 @@ void run_floyd_warshall(const Graph &graph) {
             max = i;
         }
     }
-    double avg_centrality = total_centrality / airports.size();
+    double avg_centrality = total_centrality / num_airports;
 
     cout << endl;
     cout << "Minimum Centrality: " << airports[min] << " = " << scores[min] << endl;
@@ -130,14 +238,166 @@ void run_floyd_warshall(const Graph &graph) {
 
     ofstream file(file_path);
     for (unsigned long i = 0; i < airports.size(); i++) {
-        file << airports[i] << " = " << scores[i] << endl;
+        if (airports[i] != NULL) {
+            file << airports[i] << " = " << scores[i] << endl;
+        }
     }
     file.close();
     cout << endl << "Saved airport centralities to " << file_path << endl;
 }
 
+void run_floyd_warshall(const Graph &graph) {
+    save_centralities(graph, graph.floyd_warshall());
+}
+
+void run_brandes(const Graph &graph) {
+    save_centralities(graph, graph.brandes());
+}
+
+void run_approximate_centrality(const Graph &graph, double epsilon, double delta) {
+    save_centralities(graph, graph.approximate_centrality(epsilon, delta));
+}
+
+int run_disk_apsp(Graph &graph, unsigned long max_rounds) {
+    const string file_path = "data/graph.apsp";
+    DatasetFingerprint dataset = DatasetFingerprint::of("data/airports.csv", "data/routes.csv");
+
+    if (graph.compute_disk_apsp(file_path, dataset, max_rounds)) {
+        cout << endl << "Saved all-pairs table to " << file_path << endl;
+        return 0;
+    }
+
+    // Without a round limit, an incomplete table means the file failed.
+    pair<unsigned long, unsigned long> progress = graph.get_disk_apsp().get_progress();
+    if (max_rounds == (unsigned long)-1) {
+        cerr << "Could not write " << file_path << endl;
+        return 1;
+    }
+    cout << endl << "Stopped after round " << progress.first << " of " << progress.second
+        << ", run again to resume " << file_path << endl;
+    return 0;
+}
+
+void save_metrics(const Graph &graph, const string &file_path) {
+    if (file_path.empty()) {
+        return;
+    }
+
+    ofstream metrics_file(file_path);
+    graph.get_metrics().write_json(metrics_file);
+    metrics_file << endl;
+    cout << endl << "Saved metrics to " << file_path << endl;
+}
+
 int main(int argc, char** argv) {
     Graph graph;
+
+    // Any mode but the servers, which report metrics through the stats
+    // query, can write the metrics of its algorithms as JSON when done.
+    string metrics_path;
+    if (argc > 2 && string(argv[1]) == "--metrics") {
+        metrics_path = argv[2];
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+        graph.set_metrics(true);
+    }
+
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--serve" || mode == "--socket") {
+        if (mode == "--socket" && argc != 3) {
+            cerr << "Usage: " << argv[0] << " --socket <path>" << endl;
+            return 1;
+        }
+
+        // Standard output carries responses, so progress goes to standard error.
+        graph.set_log(&cerr);
+        graph.initialize();
+        graph.set_log(NULL);
+        graph.set_path_cache(SERVER_PATH_CACHE_BYTES);
+        graph.set_metrics(true);
+
+        QueryServer server(graph);
+        if (mode == "--serve") {
+            server.serve(cin, cout);
+        } else if (!server.serve_socket(argv[2])) {
+            return 1;
+        }
+        return 0;
+    }
+
+    if (mode == "--batch") {
+        if (argc != 3 && argc != 4) {
+            cerr << "Usage: " << argv[0] << " --batch <query file> [output file]" << endl;
+            return 1;
+        }
+
+        graph.initialize();
+        int status = run_batch(graph, argv[2], argc == 4 ? argv[3] : "data/batch-routes.txt");
+        save_metrics(graph, metrics_path);
+        return status;
+    }
+
+    if (mode == "--centrality") {
+        string method = argc > 2 ? argv[2] : "";
+        double epsilon = DEFAULT_EPSILON, delta = DEFAULT_DELTA;
+        if ((method != "floyd" && method != "brandes" && method != "approx") || argc > 5 ||
+                (method != "approx" && argc > 3) ||
+                (argc > 3 && !parse_probability(argv[3], epsilon)) ||
+                (argc > 4 && !parse_probability(argv[4], delta))) {
+            cerr << "Usage: " << argv[0] << " --centrality <floyd|brandes|approx> [epsilon] [delta]"
+                << endl << "The approximate method only saves time over brandes on networks of "
+                << "thousands of airports, and epsilon and delta must be between 0 and 1" << endl;
+            return 1;
+        }
+
+        graph.initialize();
+        if (method == "floyd") {
+            run_floyd_warshall(graph);
+        } else if (method == "brandes") {
+            run_brandes(graph);
+        } else {
+            run_approximate_centrality(graph, epsilon, delta);
+        }
+        save_metrics(graph, metrics_path);
+        return 0;
+    }
+
+    if (mode == "--coverage") {
+        if (argc != 3) {
+            cerr << "Usage: " << argv[0] << " --coverage <airport>" << endl;
+            return 1;
+        }
+
+        graph.initialize();
+        if (!is_airport(graph, std::stoi(argv[2]))) {
+            cerr << "Unknown airport " << argv[2] << endl;
+            return 1;
+        }
+        run_coverage(graph, std::stoi(argv[2]));
+        save_metrics(graph, metrics_path);
+        return 0;
+    }
+
+    if (mode == "--apsp") {
+        if (argc > 3) {
+            cerr << "Usage: " << argv[0] << " --apsp [max rounds]" << endl;
+            return 1;
+        }
+
+        graph.initialize();
+        int status = run_disk_apsp(graph, argc == 3 ? std::stoul(argv[2]) : -1);
+        save_metrics(graph, metrics_path);
+        return status;
+    }
+
+    if (mode == "--forest") {
+        graph.initialize();
+        run_spanning_forest(graph);
+        save_metrics(graph, metrics_path);
+        return 0;
+    }
+
     graph.initialize();
 
     if (argc == 1) {
@@ -145,9 +405,12 @@ int main(int argc, char** argv) {
         while (query) {
             cout << endl << "[1] Dijkstra's Algorithm (Shortest-Path)" << endl 
                 << "[2] Prim's Algorithm (Largest MST)" << endl 
-                << "[3] Floyd-Warshall Algorithm (Betweenness Centrality)" << endl;
+                << "[3] Floyd-Warshall Algorithm (Betweenness Centrality)" << endl
+                << "[4] Brandes' Algorithm (Betweenness Centrality)" << endl
+                << "[5] Borůvka's Algorithm (Minimum Spanning Forest)" << endl
+                << "[6] Sampled Brandes' Algorithm (Approximate Betweenness Centrality)" << endl;
             int algorithm = std::stoi(get_input("Select Algorithm"));
-            while (algorithm < 1 || algorithm > 3) {
+            while (algorithm < 1 || algorithm > 6) {
                 cout << "Invalid Algorithm" << endl;
                 algorithm = std::stoi(get_input("Select Algorithm"));
             }
@@ -166,20 +429,35 @@ int main(int argc, char** argv) {
             } else if (algorithm == 2) {
                 int start_id = get_airport(graph, "Enter Starting City");
                 run_prim_mst(graph, start_id);
-            } else {
+            } else if (algorithm == 3) {
                 run_floyd_warshall(graph);
+            } else if (algorithm == 4) {
+                run_brandes(graph);
+            } else if (algorithm == 6) {
+                double epsilon = get_probability("Enter Maximum Error", DEFAULT_EPSILON);
+                double delta = get_probability("Enter Failure Probability", DEFAULT_DELTA);
+                run_approximate_centrality(graph, epsilon, delta);
+            } else {
+                run_spanning_forest(graph);
             }
 
             cout << endl;
             query = (get_input("Requery? [Y/N]") == "y");
         }
-    } else if (argc == 2) {
-        run_prim_mst(graph, std::stoi(argv[1]));
     } else {
         vector<int> airports;
         for (int i = 1; i < argc; i++) {
             airports.push_back(std::stoi(argv[i]));
+            if (!is_airport(graph, airports.back())) {
+                cerr << "Unknown airport " << argv[i] << endl;
+                return 1;
+            }
+        }
+        if (argc == 2) {
+            run_prim_mst(graph, airports[0]);
+        } else {
+            run_dijkstra(graph, airports);
         }
-        run_dijkstra(graph, airports);
     }
+    save_metrics(graph, metrics_path);
 }
\ No newline at end of file
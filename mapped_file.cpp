@@ -0,0 +1,94 @@
+/**
+ * @file mapped_file.cpp
+ * Implementation of memory-mapped file class.
+ */
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+
+MappedFile::MappedFile() {
+    contents = NULL;
+    length = 0;
+    writable = false;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const string &file_path, bool writable) {
+    close();
+
+    int fd = ::open(file_path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void *mapping = writable ?
+        mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) :
+        mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    contents = static_cast<const char*>(mapping);
+    length = info.st_size;
+    this -> writable = writable;
+    return true;
+}
+
+void MappedFile::close() {
+    if (contents != NULL) {
+        munmap(const_cast<char*>(contents), length);
+        contents = NULL;
+        length = 0;
+        writable = false;
+    }
+}
+
+const char *MappedFile::data() const {
+    return contents;
+}
+
+unsigned long MappedFile::size() const {
+    return length;
+}
+
+char *MappedFile::get_writable() const {
+    return writable ? const_cast<char*>(contents) : NULL;
+}
+
+bool MappedFile::sync(unsigned long offset, unsigned long length) const {
+    if (contents == NULL) {
+        return false;
+    }
+    align_pages(offset, length);
+    return msync(const_cast<char*>(contents) + offset, length, MS_SYNC) == 0;
+}
+
+void MappedFile::release(unsigned long offset, unsigned long length) const {
+    if (contents != NULL) {
+        align_pages(offset, length);
+        madvise(const_cast<char*>(contents) + offset, length, MADV_DONTNEED);
+    }
+}
+
+void MappedFile::align_pages(unsigned long &offset, unsigned long &length) const {
+    static const unsigned long page = sysconf(_SC_PAGESIZE);
+    unsigned long end = std::min(offset + length, this -> length);
+    offset = offset / page * page;
+    length = end > offset ? end - offset : 0;
+}
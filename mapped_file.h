@@ -0,0 +1,88 @@
+/**
+ * @file mapped_file.h
+ * Definition of memory-mapped file class.
+ */
+
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+/**
+ * Memory mapping of a whole file, unmapped on destruction. Mappings are
+ * read-only unless opened as writable, in which case changes are written
+ * back to the file.
+ * @author Vaibhav Gupta
+ */
+class MappedFile {
+    public:
+        // Constructor to create an empty mapping.
+        MappedFile();
+
+        // Destructor to unmap the file.
+        ~MappedFile();
+
+        MappedFile(const MappedFile &other) = delete;
+        MappedFile &operator=(const MappedFile &other) = delete;
+
+        /**
+         * Maps a file into memory, replacing any previous mapping.
+         * @param file_path File path to map.
+         * @param writable Whether the mapping can be changed through
+         * get_writable(), shared with the file.
+         * @returns Boolean representing if the file was mapped or not.
+         */
+        bool open(const string &file_path, bool writable = false);
+
+        // Unmaps the file if one is mapped.
+        void close();
+
+        /**
+         * Returns pointer to the first byte of the file.
+         * @returns Pointer to file contents, NULL if nothing is mapped.
+         */
+        const char *data() const;
+
+        /**
+         * Returns size of the mapped file.
+         * @returns Size of the file in bytes.
+         */
+        unsigned long size() const;
+
+        /**
+         * Returns pointer to the first byte of a writable mapping.
+         * @returns Pointer to file contents, NULL unless opened as writable.
+         */
+        char *get_writable() const;
+
+        /**
+         * Writes the changed pages of a range of the mapping to the file and
+         * waits for them to be stored.
+         * @param offset Offset of first byte of range.
+         * @param length Number of bytes of range.
+         * @returns Boolean representing if the range was stored or not.
+         */
+        bool sync(unsigned long offset, unsigned long length) const;
+
+        /**
+         * Drops the pages of a range of the mapping from memory, which are
+         * read from the file again on next use. Changes of a writable
+         * mapping are kept in the file.
+         * @param offset Offset of first byte of range.
+         * @param length Number of bytes of range.
+         */
+        void release(unsigned long offset, unsigned long length) const;
+
+    private:
+        /**
+         * Helper function to widen a range to whole pages of the mapping.
+         * @param offset Reference to offset of range to round down.
+         * @param length Reference to length of range to round up.
+         */
+        void align_pages(unsigned long &offset, unsigned long &length) const;
+
+        const char *contents;
+        unsigned long length;
+        bool writable;
+};
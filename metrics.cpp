@@ -0,0 +1,184 @@
+/**
+ * @file metrics.cpp
+ * Implementation of performance counter classes.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "metrics.h"
+
+// Bytes requested from the global allocator by every thread.
+static atomic<unsigned long> allocated_bytes(0);
+
+#ifndef NO_METRICS
+/**
+ * Counts and allocates memory of at least the given alignment, calling the
+ * new-handler until it succeeds as operator new must.
+ */
+static void *allocate(size_t size, size_t alignment) {
+    allocated_bytes.fetch_add(size, memory_order_relaxed);
+    size = size > 0 ? size : 1;
+    alignment = std::max(alignment, sizeof(void*));
+    while (true) {
+        void *memory = NULL;
+        if (alignment <= alignof(max_align_t)) {
+            memory = malloc(size);
+        } else if (posix_memalign(&memory, alignment, size) != 0) {
+            memory = NULL;
+        }
+        if (memory != NULL) {
+            return memory;
+        }
+
+        new_handler handler = get_new_handler();
+        if (handler == NULL) {
+            throw bad_alloc();
+        }
+        handler();
+    }
+}
+
+// Replaces the global allocator, including the overloads for over-aligned
+// types, to count bytes allocated, which only adds one relaxed atomic
+// increment to every allocation.
+void *operator new(size_t size) {
+    return allocate(size, alignof(max_align_t));
+}
+
+void *operator new[](size_t size) {
+    return allocate(size, alignof(max_align_t));
+}
+
+void *operator new(size_t size, align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void *memory, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t, align_val_t) noexcept {
+    free(memory);
+}
+#endif
+
+void PhaseMetrics::add(const PhaseMetrics &other) {
+    calls += other.calls;
+    heap_pushes += other.heap_pushes;
+    heap_pops += other.heap_pops;
+    decrease_keys += other.decrease_keys;
+    edges_scanned += other.edges_scanned;
+    airports_settled += other.airports_settled;
+    bytes_allocated += other.bytes_allocated;
+    wall_ms += other.wall_ms;
+    cpu_ms += other.cpu_ms;
+}
+
+void PhaseMetrics::add_heap(const HeapCounters &after, const HeapCounters &before) {
+    heap_pushes += after.pushes - before.pushes;
+    heap_pops += after.pops - before.pops;
+    decrease_keys += after.decrease_keys - before.decrease_keys;
+}
+
+Metrics::Metrics() : is_enabled(false) {}
+
+void Metrics::set_enabled(bool enabled) {
+    is_enabled = enabled;
+}
+
+bool Metrics::enabled() const {
+    return is_enabled;
+}
+
+void Metrics::record(const char *phase, const PhaseMetrics &metrics) {
+    lock_guard<mutex> guard(lock);
+    auto it = phases.find(phase);
+    if (it == phases.end()) {
+        it = phases.emplace(phase, PhaseMetrics()).first;
+    }
+    it -> second.add(metrics);
+}
+
+map<string, PhaseMetrics> Metrics::get_phases() const {
+    lock_guard<mutex> guard(lock);
+    return map<string, PhaseMetrics>(phases.begin(), phases.end());
+}
+
+void Metrics::clear() {
+    lock_guard<mutex> guard(lock);
+    phases.clear();
+}
+
+void Metrics::write_json(ostream &out) const {
+    map<string, PhaseMetrics> totals = get_phases();
+    out << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"compiled\":"
+        << (METRICS_COMPILED ? "true" : "false") << ",\"phases\":{";
+
+    // Phase names are fixed identifiers, so they need no escaping.
+    bool first = true;
+    for (const auto &phase : totals) {
+        const PhaseMetrics &m = phase.second;
+        out << (first ? "" : ",") << "\"" << phase.first << "\":{\"calls\":" << m.calls
+            << ",\"heap_pushes\":" << m.heap_pushes << ",\"heap_pops\":" << m.heap_pops
+            << ",\"decrease_keys\":" << m.decrease_keys << ",\"edges_scanned\":" << m.edges_scanned
+            << ",\"airports_settled\":" << m.airports_settled << ",\"bytes_allocated\":"
+            << m.bytes_allocated << ",\"wall_ms\":" << m.wall_ms << ",\"cpu_ms\":" << m.cpu_ms << "}";
+        first = false;
+    }
+    out << "}}";
+}
+
+unsigned long Metrics::get_bytes_allocated() {
+    return allocated_bytes.load(memory_order_relaxed);
+}
+
+PhaseTimer::PhaseTimer(Metrics &metrics, const char *phase) : metrics(metrics), phase(phase) {
+    is_active = metrics.enabled();
+    if (is_active) {
+        start = chrono::steady_clock::now();
+        cpu_start = std::clock();
+        bytes_start = Metrics::get_bytes_allocated();
+    }
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (!is_active) {
+        return;
+    }
+    counters.calls++;
+    counters.bytes_allocated += Metrics::get_bytes_allocated() - bytes_start;
+    counters.wall_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    counters.cpu_ms += 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    metrics.record(phase, counters);
+}
@@ -0,0 +1,179 @@
+/**
+ * @file metrics.h
+ * Definition of performance counter classes.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// Counters are compiled in unless built with -DNO_METRICS, in which case
+// heaps and searches count nothing and allocations are not tracked.
+#ifdef NO_METRICS
+const bool METRICS_COMPILED = false;
+#else
+const bool METRICS_COMPILED = true;
+#endif
+
+/**
+ * Operations performed by a priority queue over its lifetime.
+ */
+struct HeapCounters {
+    unsigned long pushes = 0;
+    unsigned long pops = 0;
+    unsigned long decrease_keys = 0;
+};
+
+/**
+ * Work and time spent by one or more runs of an algorithm phase.
+ */
+struct PhaseMetrics {
+    unsigned long calls = 0;
+    unsigned long heap_pushes = 0;
+    unsigned long heap_pops = 0;
+    unsigned long decrease_keys = 0;
+    unsigned long edges_scanned = 0;
+    unsigned long airports_settled = 0;
+
+    // Bytes allocated through operator new by the whole process while the
+    // phase ran, excluding aligned and memory-mapped buffers.
+    unsigned long bytes_allocated = 0;
+
+    // Wall-clock time, and CPU time of every thread of the process.
+    double wall_ms = 0;
+    double cpu_ms = 0;
+
+    /**
+     * Adds the counters and times of other runs.
+     * @param other Reference to metrics to add.
+     */
+    void add(const PhaseMetrics &other);
+
+    /**
+     * Adds the operations a heap performed between two readings of its
+     * counters.
+     * @param after Reference to counters read after the phase.
+     * @param before Reference to counters read before the phase.
+     */
+    void add_heap(const HeapCounters &after, const HeapCounters &before = HeapCounters());
+};
+
+/**
+ * Performance counters of every algorithm phase run by a graph, such as
+ * loading, searches, spanning trees and centrality.
+ *
+ * Phases are only recorded while enabled at run time, so a disabled
+ * registry costs one flag check per phase. Recording and reading may
+ * happen from multiple threads.
+ * @author Vaibhav Gupta
+ */
+class Metrics {
+    public:
+        // Constructor to create a disabled registry with no phases.
+        Metrics();
+
+        /**
+         * Enables or disables recording, keeping the phases recorded so far.
+         * @param enabled Whether to record phases.
+         */
+        void set_enabled(bool enabled);
+
+        /**
+         * Returns if phases are recorded.
+         * @returns Boolean representing if recording is enabled or not.
+         */
+        bool enabled() const;
+
+        /**
+         * Adds one run of a phase to its totals.
+         * @param phase Name of phase.
+         * @param metrics Reference to metrics of the run.
+         */
+        void record(const char *phase, const PhaseMetrics &metrics);
+
+        /**
+         * Returns the totals of every phase recorded so far.
+         * @returns Copy of metrics of each phase by name.
+         */
+        map<string, PhaseMetrics> get_phases() const;
+
+        /**
+         * Forgets every recorded phase.
+         */
+        void clear();
+
+        /**
+         * Writes the totals of every phase as a JSON object.
+         * @param out Reference to stream to write to.
+         */
+        void write_json(ostream &out) const;
+
+        /**
+         * Returns the number of bytes allocated by the process so far, 0 if
+         * metrics are not compiled in.
+         * @returns Number of bytes.
+         */
+        static unsigned long get_bytes_allocated();
+
+    private:
+        atomic<bool> is_enabled;
+        mutable mutex lock;
+        map<string, PhaseMetrics, less<>> phases;
+};
+
+/**
+ * Measures one run of a phase from construction to destruction and records
+ * it, together with the counters added by the phase, if the registry is
+ * enabled.
+ * @author Vaibhav Gupta
+ */
+class PhaseTimer {
+    public:
+        /**
+         * Constructor to start measuring a phase.
+         * @param metrics Reference to registry to record the phase in.
+         * @param phase Name of phase, which must outlive the timer.
+         */
+        PhaseTimer(Metrics &metrics, const char *phase);
+
+        // Destructor to record the phase.
+        ~PhaseTimer();
+
+        /**
+         * Returns if the phase will be recorded, so callers can skip
+         * gathering counters otherwise.
+         * @returns Boolean representing if the registry was enabled or not.
+         */
+        bool active() const;
+
+        /**
+         * Returns the counters of the phase, which callers add their work to.
+         * @returns Reference to metrics of the phase.
+         */
+        PhaseMetrics &get_counters();
+
+    private:
+        Metrics &metrics;
+        const char *phase;
+        bool is_active;
+        PhaseMetrics counters;
+        chrono::steady_clock::time_point start;
+        clock_t cpu_start;
+        unsigned long bytes_start;
+};
+
+inline bool PhaseTimer::active() const {
+    return is_active;
+}
+
+inline PhaseMetrics &PhaseTimer::get_counters() {
+    return counters;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file multi_source.cpp
+ * Implementation of batched multi-source shortest-path class.
+ */
+
+#include <algorithm>
+
+#include "multi_source.h"
+#include "heap.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MULTI_SOURCE_X86
+#include <immintrin.h>
+#endif
+
+static const unsigned LANES = MultiSourceSearch::LANES;
+
+/**
+ * Relaxes the routes of one airport for every source of a batch, adding
+ * each destination whose cost improved to the next round.
+ */
+static void relax_scalar(const double *from, const int *dests, const double *weights,
+        unsigned count, double *costs, char *is_next, vector<int> &next_active) {
+    for (unsigned k = 0; k < count; k++) {
+        double *to = costs + (unsigned long)dests[k] * LANES;
+        bool improved = false;
+        for (unsigned lane = 0; lane < LANES; lane++) {
+            double cost = from[lane] + weights[k];
+            if (cost < to[lane]) {
+                to[lane] = cost;
+                improved = true;
+            }
+        }
+        if (improved && !is_next[dests[k]]) {
+            is_next[dests[k]] = true;
+            next_active.push_back(dests[k]);
+        }
+    }
+}
+
+#ifdef MULTI_SOURCE_X86
+__attribute__((target("avx2")))
+static void relax_avx2(const double *from, const int *dests, const double *weights,
+        unsigned count, double *costs, char *is_next, vector<int> &next_active) {
+    __m256d from_low = _mm256_loadu_pd(from), from_high = _mm256_loadu_pd(from + 4);
+    for (unsigned k = 0; k < count; k++) {
+        double *to = costs + (unsigned long)dests[k] * LANES;
+        __m256d weight = _mm256_set1_pd(weights[k]);
+        __m256d cost_low = _mm256_add_pd(from_low, weight);
+        __m256d cost_high = _mm256_add_pd(from_high, weight);
+        __m256d curr_low = _mm256_loadu_pd(to), curr_high = _mm256_loadu_pd(to + 4);
+        __m256d mask_low = _mm256_cmp_pd(cost_low, curr_low, _CMP_LT_OQ);
+        __m256d mask_high = _mm256_cmp_pd(cost_high, curr_high, _CMP_LT_OQ);
+        if (_mm256_movemask_pd(_mm256_or_pd(mask_low, mask_high)) == 0) {
+            continue;
+        }
+
+        _mm256_storeu_pd(to, _mm256_blendv_pd(curr_low, cost_low, mask_low));
+        _mm256_storeu_pd(to + 4, _mm256_blendv_pd(curr_high, cost_high, mask_high));
+        if (!is_next[dests[k]]) {
+            is_next[dests[k]] = true;
+            next_active.push_back(dests[k]);
+        }
+    }
+}
+
+static bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+void MultiSourceSearch::build(const CSR &csr) {
+    unsigned long n = csr.num_airports();
+    offsets.assign(1, 0);
+    dests.clear();
+    weights.clear();
+
+    // Only the cheapest of the routes between two airports can be on a
+    // shortest path, and the dataset often has one per airline.
+    vector<long> slot(n, -1);
+    for (unsigned long u = 0; u < n; u++) {
+        unsigned first = dests.size();
+        for (unsigned e = csr.get_begin(u); e < csr.get_end(u); e++) {
+            int dest_id = csr.get_dest(e);
+            if (dest_id == (int)u) {
+                continue;
+            }
+            if (slot[dest_id] < (long)first) {
+                slot[dest_id] = dests.size();
+                dests.push_back(dest_id);
+                weights.push_back(csr.get_weight(e));
+            } else {
+                weights[slot[dest_id]] = std::min(weights[slot[dest_id]], csr.get_weight(e));
+            }
+        }
+        offsets.push_back(dests.size());
+    }
+}
+
+void MultiSourceSearch::search(const int *src_ids, unsigned num_sources, Batch &batch) const {
+    unsigned long n = num_airports();
+    batch.costs.assign(n * LANES, INF_COST);
+    if (batch.is_next.size() != n) {
+        batch.is_next.assign(n, false);
+    }
+    batch.num_rounds = 0;
+    batch.next_active.clear();
+    for (unsigned lane = 0; lane < num_sources && lane < LANES; lane++) {
+        batch.costs[(unsigned long)src_ids[lane] * LANES + lane] = 0;
+        if (!batch.is_next[src_ids[lane]]) {
+            batch.is_next[src_ids[lane]] = true;
+            batch.next_active.push_back(src_ids[lane]);
+        }
+    }
+
+#ifdef MULTI_SOURCE_X86
+    auto relax = has_avx2() ? relax_avx2 : relax_scalar;
+#else
+    auto relax = relax_scalar;
+#endif
+    while (!batch.next_active.empty()) {
+        batch.active.swap(batch.next_active);
+        batch.next_active.clear();
+        for (int id : batch.active) {
+            batch.is_next[id] = false;
+        }
+
+        // Airports relax in ID order, so costs are read roughly in sequence.
+        std::sort(batch.active.begin(), batch.active.end());
+        for (int id : batch.active) {
+            unsigned begin = offsets[id], count = offsets[id + 1] - begin;
+            relax(batch.costs.data() + (unsigned long)id * LANES, dests.data() + begin,
+                weights.data() + begin, count, batch.costs.data(), batch.is_next.data(),
+                batch.next_active);
+            batch.counters.edges_scanned += count;
+        }
+        batch.counters.airports_settled += batch.active.size();
+        batch.num_rounds++;
+    }
+}
+
+unsigned long MultiSourceSearch::num_airports() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+unsigned long MultiSourceSearch::num_routes() const {
+    return dests.size();
+}
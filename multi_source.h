@@ -0,0 +1,124 @@
+/**
+ * @file multi_source.h
+ * Definition of batched multi-source shortest-path class.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "csr.h"
+#include "metrics.h"
+#include "threadpool.h"
+
+using namespace std;
+
+/**
+ * Shortest-path costs from many source airports, searched in batches of
+ * LANES sources that share one pass over the routes per round instead of
+ * running one Dijkstra search per source.
+ *
+ * Costs of a batch are stored source-interleaved, so the costs of one
+ * airport from every source of the batch fill one 64-byte cache line.
+ * Rounds follow the Bellman-Ford algorithm: every airport whose cost from
+ * any source improved in the previous round relaxes its routes for all
+ * sources together with min-plus vector operations, using AVX2 when the
+ * processor supports it. Routes are read from a compact copy of the graph
+ * keeping only the cheapest route between each pair of airports. Hub-and-
+ * spoke networks need few rounds, since shortest paths have few routes.
+ * @author Vaibhav Gupta
+ */
+class MultiSourceSearch {
+    public:
+        // Number of sources searched together, one per vector lane.
+        static constexpr unsigned LANES = 8;
+
+        /**
+         * Costs and search state of one batch of sources.
+         */
+        struct Batch {
+            // Cost of each airport from each source, indexed by airport ID
+            // times LANES plus the index of the source in the batch.
+            vector<double> costs;
+            vector<int> active;
+            vector<int> next_active;
+            vector<char> is_next;
+            unsigned long num_rounds = 0;
+            PhaseMetrics counters;
+
+            /**
+             * Returns the cost of the shortest path from a source of the batch.
+             * @param lane Index of source within the batch.
+             * @param id Airport ID.
+             * @returns Cost of shortest path, INF_COST if unreachable.
+             */
+            double get_cost(unsigned lane, int id) const;
+        };
+
+        /**
+         * Builds the compact routes of a graph, replacing any previous ones.
+         * @param csr Reference to CSR graph.
+         */
+        void build(const CSR &csr);
+
+        /**
+         * Computes the costs from one batch of sources to every airport.
+         * @param src_ids Pointer to IDs of source airports.
+         * @param num_sources Number of sources, at most LANES. Unused lanes
+         * reach no airport.
+         * @param batch Reference to batch to store the costs in, replacing
+         * those of its previous sources.
+         */
+        void search(const int *src_ids, unsigned num_sources, Batch &batch) const;
+
+        /**
+         * Computes the costs from every source in parallel, one batch of
+         * consecutive sources at a time per thread.
+         * @param src_ids Reference to IDs of source airports.
+         * @param pool Reference to thread pool to search on.
+         * @param counters Reference to metrics to add the work done to.
+         * @param visit Function called with the index of the first source
+         * of each batch, the batch, and the index of the calling thread.
+         */
+        template <typename Visit>
+        void search_all(const vector<int> &src_ids, ThreadPool &pool, PhaseMetrics &counters,
+            Visit visit) const;
+
+        /**
+         * Returns the number of airports of the compact routes.
+         * @returns Number of airports.
+         */
+        unsigned long num_airports() const;
+
+        /**
+         * Returns the number of compact routes, at most one per pair of
+         * airports.
+         * @returns Number of routes.
+         */
+        unsigned long num_routes() const;
+
+    private:
+        vector<unsigned> offsets;
+        vector<int> dests;
+        vector<double> weights;
+};
+
+inline double MultiSourceSearch::Batch::get_cost(unsigned lane, int id) const {
+    return costs[(unsigned long)id * LANES + lane];
+}
+
+template <typename Visit>
+void MultiSourceSearch::search_all(const vector<int> &src_ids, ThreadPool &pool,
+        PhaseMetrics &counters, Visit visit) const {
+    vector<Batch> batches(pool.size());
+    unsigned long num_batches = (src_ids.size() + LANES - 1) / LANES;
+    pool.parallel_for(num_batches, [&](unsigned long i, unsigned thread) {
+        unsigned long first = i * LANES;
+        unsigned num_sources = src_ids.size() - first < LANES ? src_ids.size() - first : LANES;
+        search(src_ids.data() + first, num_sources, batches[thread]);
+        visit(first, (const Batch&)batches[thread], thread);
+    });
+    for (const Batch &batch : batches) {
+        counters.add(batch.counters);
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file name_index.cpp
+ * Implementation of airport name index class.
+ */
+
+#include <algorithm>
+#include <cctype>
+
+#include "name_index.h"
+
+void NameIndex::build(const vector<Airport*> &airports) {
+    cities.clear();
+    entries.clear();
+    keys.clear();
+
+    for (unsigned long i = 0; i < airports.size(); i++) {
+        if (airports[i] != NULL) {
+            string city = fold(airports[i] -> get_city());
+            cities[city].push_back(i);
+            add_words(keys.store(city), i);
+            add_words(keys.store(fold(airports[i] -> get_name())), i);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.key < b.key || (a.key == b.key && a.id < b.id);
+    });
+}
+
+const vector<int> &NameIndex::find_city(string_view city) const {
+    static const vector<int> none;
+    auto it = cities.find(fold(city));
+    return it != cities.end() ? it -> second : none;
+}
+
+vector<int> NameIndex::search(string_view prefix, unsigned long limit) const {
+    vector<int> ids;
+    string key = fold(prefix);
+    if (key.empty()) {
+        return ids;
+    }
+
+    auto it = std::lower_bound(entries.begin(), entries.end(), key,
+        [](const Entry &entry, const string &key) { return entry.key < key; });
+    for (; it != entries.end() && ids.size() < limit && 
+            it -> key.compare(0, key.size(), key) == 0; it++) {
+        // An airport can match several words, but is only listed once.
+        if (std::find(ids.begin(), ids.end(), it -> id) == ids.end()) {
+            ids.push_back(it -> id);
+        }
+    }
+    return ids;
+}
+
+string NameIndex::fold(string_view text) {
+    string folded(text);
+    for (char &c : folded) {
+        c = std::tolower((unsigned char)c);
+    }
+    return folded;
+}
+
+void NameIndex::add_words(string_view text, int id) {
+    for (unsigned long i = 0; i < text.size(); i++) {
+        if (std::isalnum((unsigned char)text[i]) && 
+                (i == 0 || !std::isalnum((unsigned char)text[i - 1]))) {
+            entries.push_back({text.substr(i), id});
+        }
+    }
+}
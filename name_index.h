@@ -0,0 +1,82 @@
+/**
+ * @file name_index.h
+ * Definition of airport name index class.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "airport.h"
+#include "arena.h"
+
+using namespace std;
+
+/**
+ * Case-insensitive index of the cities and names of airports.
+ *
+ * Cities are hashed to the IDs of their airports, so exact lookups take
+ * time proportional to the length of the city. Every word of every city
+ * and airport name also starts an entry of a sorted index, so airports
+ * whose city or name has a word starting with a given prefix are found
+ * by binary search, such as "hare" and "chic" for Chicago O'Hare.
+ * @author Vaibhav Gupta
+ */
+class NameIndex {
+    public:
+        /**
+         * Builds the index from the airports of a graph, replacing any
+         * previous contents.
+         * @param airports Reference to vector of pointers to airports,
+         * indexed by airport ID.
+         */
+        void build(const vector<Airport*> &airports);
+
+        /**
+         * Returns the airports located in a city, ignoring case.
+         * @param city Name of city.
+         * @returns Reference to vector of airport IDs in increasing order,
+         * empty if no airport is located in the city.
+         */
+        const vector<int> &find_city(string_view city) const;
+
+        /**
+         * Finds airports whose city or name has a word starting with a
+         * prefix, ignoring case.
+         * @param prefix Start of a word, possibly followed by more words.
+         * @param limit Maximum number of airports to return.
+         * @returns IDs of matching airports in alphabetical order of the
+         * matched text.
+         */
+        vector<int> search(string_view prefix, unsigned long limit) const;
+
+    private:
+        /**
+         * Word of a city or airport name and the rest of the text after it.
+         */
+        struct Entry {
+            string_view key;
+            int id;
+        };
+
+        /**
+         * Helper function to convert text to lowercase.
+         * @param text Text to convert.
+         * @returns Lowercase copy of text.
+         */
+        static string fold(string_view text);
+
+        /**
+         * Helper function to add an entry for every word of a text.
+         * @param text Lowercase text stored in the index.
+         * @param id Airport ID the text belongs to.
+         */
+        void add_words(string_view text, int id);
+
+        unordered_map<string, vector<int>> cities;
+        vector<Entry> entries;
+        StringArena keys;
+};
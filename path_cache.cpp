@@ -0,0 +1,74 @@
+/**
+ * @file path_cache.cpp
+ * Implementation of shortest-path tree cache class.
+ */
+
+#include "path_cache.h"
+
+unsigned long ShortestPathTree::bytes() const {
+    return sizeof(ShortestPathTree) + costs.size() * sizeof(double) +
+        predecessor.size() * sizeof(unsigned);
+}
+
+PathCache::PathCache() {}
+
+void PathCache::set_budget(unsigned long max_bytes) {
+    unique_lock<mutex> guard(lock);
+    stats.budget = max_bytes;
+    evict();
+}
+
+bool PathCache::enabled() const {
+    unique_lock<mutex> guard(lock);
+    return stats.budget > 0;
+}
+
+shared_ptr<const ShortestPathTree> PathCache::find(int src_id) {
+    unique_lock<mutex> guard(lock);
+    auto entry = trees.find(src_id);
+    if (entry == trees.end()) {
+        stats.misses++;
+        return NULL;
+    }
+
+    stats.hits++;
+    recency.splice(recency.begin(), recency, entry -> second);
+    return *entry -> second;
+}
+
+void PathCache::insert(const shared_ptr<const ShortestPathTree> &tree) {
+    unique_lock<mutex> guard(lock);
+    if (tree -> bytes() > stats.budget || trees.count(tree -> src_id) > 0) {
+        return;
+    }
+
+    recency.push_front(tree);
+    trees[tree -> src_id] = recency.begin();
+    stats.entries++;
+    stats.bytes += tree -> bytes();
+    evict();
+}
+
+void PathCache::clear() {
+    unique_lock<mutex> guard(lock);
+    recency.clear();
+    trees.clear();
+    stats.entries = 0;
+    stats.bytes = 0;
+}
+
+PathCacheStats PathCache::get_stats() const {
+    unique_lock<mutex> guard(lock);
+    return stats;
+}
+
+void PathCache::evict() {
+    while (stats.bytes > stats.budget) {
+        const shared_ptr<const ShortestPathTree> &oldest = recency.back();
+        stats.bytes -= oldest -> bytes();
+        stats.entries--;
+        stats.evictions++;
+        trees.erase(oldest -> src_id);
+        recency.pop_back();
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file path_cache.h
+ * Definition of shortest-path tree cache class.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "csr.h"
+
+using namespace std;
+
+/**
+ * Complete shortest-path tree generated from one source airport.
+ */
+struct ShortestPathTree {
+    int src_id;
+
+    // Cost of the shortest path to each airport, INF_COST if unreachable.
+    vector<double> costs;
+
+    // Route index of the last route on the shortest path to each airport,
+    // NO_ROUTE for the source and unreachable airports.
+    vector<unsigned> predecessor;
+
+    /**
+     * Returns the memory used by the tree.
+     * @returns Number of bytes.
+     */
+    unsigned long bytes() const;
+};
+
+/**
+ * Counters describing the use of a path cache.
+ */
+struct PathCacheStats {
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+    unsigned long evictions = 0;
+    unsigned long entries = 0;
+    unsigned long bytes = 0;
+    unsigned long budget = 0;
+};
+
+/**
+ * Bounded cache of complete shortest-path trees keyed by source airport,
+ * evicting the least recently used tree once the memory budget is
+ * exceeded. All functions may be called from multiple threads, and trees
+ * are shared so that they remain valid after being evicted.
+ * @author Vaibhav Gupta
+ */
+class PathCache {
+    public:
+        // Constructor to create a disabled cache with no budget.
+        PathCache();
+
+        /**
+         * Sets the memory budget of the cache, evicting trees that no
+         * longer fit. A budget of 0 disables the cache.
+         * @param max_bytes Maximum number of bytes of cached trees.
+         */
+        void set_budget(unsigned long max_bytes);
+
+        /**
+         * Returns if the cache has a budget and should be used.
+         * @returns Boolean representing if cache is enabled or not.
+         */
+        bool enabled() const;
+
+        /**
+         * Returns the tree of a source airport, marking it as the most
+         * recently used, and counts the lookup as a hit or miss.
+         * @param src_id ID of source airport.
+         * @returns Pointer to cached tree, NULL if not cached.
+         */
+        shared_ptr<const ShortestPathTree> find(int src_id);
+
+        /**
+         * Adds a tree as the most recently used, unless it is larger than
+         * the whole budget or its source is already cached.
+         * @param tree Pointer to complete tree.
+         */
+        void insert(const shared_ptr<const ShortestPathTree> &tree);
+
+        /**
+         * Removes every tree, called when the graph changes. Counters
+         * other than entries and bytes are kept.
+         */
+        void clear();
+
+        /**
+         * Returns the counters of the cache.
+         * @returns Copy of current counters.
+         */
+        PathCacheStats get_stats() const;
+
+    private:
+        // Helper function to evict least recently used trees until within budget.
+        void evict();
+
+        typedef list<shared_ptr<const ShortestPathTree>> Recency;
+
+        mutable mutex lock;
+        Recency recency;
+        unordered_map<int, Recency::iterator> trees;
+        PathCacheStats stats;
+};
@@ -0,0 +1,163 @@
+/**
+ * @file path_order.cpp
+ * Implementation of shortest-path counting order class.
+ */
+
+#include <algorithm>
+
+#include "path_order.h"
+
+// Index of an airport Tarjan's Algorithm has not visited yet.
+static const unsigned UNVISITED = -1;
+
+void PathOrder::sort(const CSR &csr, const CSR &reverse_csr, const vector<double> &costs,
+        int src_id, vector<int> &order) {
+    unsigned long n = csr.num_airports();
+    ranks.resize(n);
+    local.resize(n);
+    if (stamps.size() != n || ++epoch == 0) {
+        stamps.assign(n, 0);
+        epoch = 1;
+    }
+    for (unsigned long i = 0; i < order.size(); i++) {
+        stamps[order[i]] = epoch;
+    }
+
+    for (unsigned long first = 0, last = 0; first < order.size(); first = last) {
+        while (last < order.size() && costs[order[last]] == costs[order[first]]) {
+            last++;
+        }
+        if (last - first > 1) {
+            sort_group(csr, reverse_csr, costs, src_id, order, first, last);
+        }
+    }
+    for (unsigned long i = 0; i < order.size(); i++) {
+        ranks[order[i]] = i;
+    }
+}
+
+void PathOrder::sort_group(const CSR &csr, const CSR &reverse_csr, const vector<double> &costs,
+        int src_id, vector<int> &order, unsigned long first, unsigned long last) {
+    double cost = costs[order[first]];
+    unsigned size = last - first;
+    members.assign(order.begin() + first, order.begin() + last);
+    for (unsigned k = 0; k < size; k++) {
+        local[members[k]] = k;
+    }
+    auto in_group = [&](int id) {
+        return stamps[id] == epoch && local[id] < size && members[local[id]] == id;
+    };
+
+    // Zero-cost routes between different airports of the group, except
+    // into the source, which every shortest path starts from.
+    begins.assign(size + 1, 0);
+    neighbours.clear();
+    for (unsigned k = 0; k < size; k++) {
+        int id = members[k];
+        for (unsigned e = csr.get_begin(id); e < csr.get_end(id); e++) {
+            int dest_id = csr.get_dest(e);
+            if (dest_id != id && dest_id != src_id && in_group(dest_id) &&
+                    cost + csr.get_weight(e) == cost) {
+                neighbours.push_back(local[dest_id]);
+            }
+        }
+        begins[k + 1] = neighbours.size();
+    }
+    unsigned num_components = find_components();
+
+    // Paths enter a component from the source itself, from a cheaper
+    // airport or from an earlier component of the group.
+    entered.assign(size, false);
+    for (unsigned k = 0; k < size; k++) {
+        int id = members[k];
+        entered[k] = id == src_id;
+        for (unsigned e = reverse_csr.get_begin(id); e < reverse_csr.get_end(id) && !entered[k];
+                e++) {
+            int prev_id = reverse_csr.get_dest(e);
+            if (prev_id != id && stamps[prev_id] == epoch &&
+                    costs[prev_id] + reverse_csr.get_weight(e) == cost) {
+                entered[k] = !in_group(prev_id) || component[local[prev_id]] != component[k];
+            }
+        }
+    }
+
+    // Components are numbered in reverse topological order. Each is
+    // searched from its entries first, in the order of the group.
+    visited.assign(size, false);
+    unsigned long next = first;
+    for (unsigned c = num_components; c-- > 0; ) {
+        for (int pass = 0; pass < 2; pass++) {
+            for (unsigned k = 0; k < size; k++) {
+                if (component[k] != c || visited[k] || (pass == 0 && !entered[k])) {
+                    continue;
+                }
+                visited[k] = true;
+                queue.assign(1, k);
+                for (unsigned long head = 0; head < queue.size(); head++) {
+                    unsigned current = queue[head];
+                    order[next++] = members[current];
+                    for (unsigned i = begins[current]; i < begins[current + 1]; i++) {
+                        unsigned neighbour = neighbours[i];
+                        if (component[neighbour] == c && !visited[neighbour]) {
+                            visited[neighbour] = true;
+                            queue.push_back(neighbour);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+unsigned PathOrder::find_components() {
+    unsigned size = members.size(), count = 0, num_components = 0;
+    index.assign(size, UNVISITED);
+    low.resize(size);
+    component.resize(size);
+    on_stack.assign(size, false);
+    stack.clear();
+
+    for (unsigned root = 0; root < size; root++) {
+        if (index[root] != UNVISITED) {
+            continue;
+        }
+        index[root] = low[root] = count++;
+        stack.push_back(root);
+        on_stack[root] = true;
+        calls.assign(1, {root, begins[root]});
+
+        while (!calls.empty()) {
+            unsigned current = calls.back().first;
+            unsigned &i = calls.back().second;
+            if (i < begins[current + 1]) {
+                unsigned next = neighbours[i++];
+                if (index[next] == UNVISITED) {
+                    index[next] = low[next] = count++;
+                    stack.push_back(next);
+                    on_stack[next] = true;
+                    calls.emplace_back(next, begins[next]);
+                } else if (on_stack[next]) {
+                    low[current] = std::min(low[current], index[next]);
+                }
+                continue;
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) {
+                unsigned parent = calls.back().first;
+                low[parent] = std::min(low[parent], low[current]);
+            }
+            if (low[current] == index[current]) {
+                unsigned member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack[member] = false;
+                    component[member] = num_components;
+                } while (member != current);
+                num_components++;
+            }
+        }
+    }
+    return num_components;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file path_order.h
+ * Definition of shortest-path counting order class.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "csr.h"
+
+using namespace std;
+
+/**
+ * Order in which airports reached by a shortest-path search have their
+ * shortest paths counted, for Brandes' Algorithm and path sampling.
+ *
+ * Airports are ordered by cost, which alone decides nothing between
+ * airports of equal cost joined by zero-cost routes. Those are ordered so
+ * that the routes lead forward: the strongly connected components of the
+ * zero-cost routes between them come in topological order, and the
+ * airports of one component in breadth-first order from where shortest
+ * paths enter it. A route on a shortest path is then only counted from an
+ * airport to a later one, which skips self-loops, routes back to the
+ * source and routes going around a cycle of zero-cost routes, so every
+ * path crosses such a cycle once.
+ * @author Vaibhav Gupta
+ */
+class PathOrder {
+    public:
+        /**
+         * Reorders airports of equal cost as described above and ranks
+         * every airport by its position.
+         * @param csr Reference to CSR graph the costs were computed along.
+         * @param reverse_csr Reference to reverse CSR graph of the same graph.
+         * @param costs Reference to costs from the source, indexed by airport
+         * ID, read only for airports of the order.
+         * @param src_id ID of source airport, which stays first.
+         * @param order Reference to vector of reached airport IDs sorted by
+         * cost, reordered in place.
+         */
+        void sort(const CSR &csr, const CSR &reverse_csr, const vector<double> &costs,
+            int src_id, vector<int> &order);
+
+        /**
+         * Returns if a route between two airports is counted, that is if
+         * the first airport is ordered before the second. Whether the route
+         * lies on a shortest path is left to the caller.
+         * @param from_id ID of airport the route leaves.
+         * @param to_id ID of airport of the order the route arrives at.
+         * @returns Boolean representing if the route is counted or not.
+         */
+        bool precedes(int from_id, int to_id) const;
+
+    private:
+        /**
+         * Helper function to reorder the airports of one cost.
+         * @param csr Reference to CSR graph.
+         * @param reverse_csr Reference to reverse CSR graph.
+         * @param costs Reference to costs from the source.
+         * @param src_id ID of source airport.
+         * @param order Reference to vector of airport IDs.
+         * @param first Index of first airport of the cost in the order.
+         * @param last Index past the last airport of the cost in the order.
+         */
+        void sort_group(const CSR &csr, const CSR &reverse_csr, const vector<double> &costs,
+            int src_id, vector<int> &order, unsigned long first, unsigned long last);
+
+        /**
+         * Helper function to number the strongly connected components of the
+         * zero-cost routes within a group with Tarjan's Algorithm, in reverse
+         * topological order.
+         * @returns Number of components.
+         */
+        unsigned find_components();
+
+        // Positions in the order, valid where the stamp is the current epoch.
+        vector<unsigned> ranks;
+        vector<unsigned> stamps;
+        unsigned epoch = 0;
+
+        // Airports of the group being sorted, the index of each airport in
+        // it, and the zero-cost routes between them as a CSR of indices.
+        vector<int> members;
+        vector<unsigned> local;
+        vector<unsigned> begins, neighbours;
+
+        // State of Tarjan's Algorithm and the breadth-first search.
+        vector<unsigned> index, low, component, stack, queue;
+        vector<pair<unsigned, unsigned>> calls;
+        vector<char> on_stack, entered, visited;
+};
+
+inline bool PathOrder::precedes(int from_id, int to_id) const {
+    return stamps[from_id] == epoch && ranks[from_id] < ranks[to_id];
+}
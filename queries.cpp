@@ -0,0 +1,63 @@
+/**
+ * @file queries.cpp
+ * Implementation of reusable graph queries.
+ */
+
+#include "queries.h"
+
+PathResult find_path(const Graph &graph, const vector<int> &dest_ids) {
+    PathResult result;
+    unsigned long num_legs;
+    result.routes = graph.dijkstra(dest_ids, &num_legs);
+    result.complete = num_legs + 1 >= dest_ids.size();
+
+    for (Route *route : result.routes) {
+        result.cost += route -> get_weight();
+    }
+    return result;
+}
+
+TreeResult find_tree(const Graph &graph, int start_id) {
+    TreeResult result;
+    result.mst.reset(new Graph());
+    result.routes = graph.prim_mst(*result.mst, start_id);
+
+    for (Airport *airport : result.mst -> get_airports()) {
+        if (airport != NULL) {
+            for (Route *route : airport -> get_routes()) {
+                result.cost += route -> get_weight();
+            }
+        }
+    }
+
+    // Airports missing from the tree are those it cannot reach.
+    CoverageResult coverage = find_coverage(graph, start_id);
+    result.missing = std::move(coverage.missing);
+    result.coverage = coverage.coverage;
+    return result;
+}
+
+CoverageResult find_coverage(const Graph &graph, int start_id) {
+    CoverageResult result;
+    result.missing = graph.find_unreachable(start_id);
+
+    unsigned long num_airports = graph.get_csr().num_airports();
+    result.num_reachable = num_airports - result.missing.size();
+    result.coverage = 100.0 * result.num_reachable / num_airports;
+    return result;
+}
+
+ForestResult find_forest(const Graph &graph) {
+    ForestResult result;
+    result.mst.reset(new Graph());
+    result.routes = graph.spanning_forest(*result.mst, result.components);
+
+    for (const ForestComponent &component : result.components) {
+        result.cost += component.cost;
+    }
+    return result;
+}
+
+bool is_airport(const Graph &graph, int id) {
+    return graph.get_airport(id) != NULL;
+}
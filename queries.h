@@ -0,0 +1,119 @@
+/**
+ * @file queries.h
+ * Definition of reusable graph queries.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "graph.h"
+
+using namespace std;
+
+/**
+ * Result of a shortest-path query through a sequence of airports.
+ */
+struct PathResult {
+    // Routes of the path to the most reachable destination.
+    vector<Route*> routes;
+
+    // Whether the path reaches the final destination.
+    bool complete = false;
+
+    // Total cost of the routes.
+    double cost = 0;
+};
+
+/**
+ * Result of a minimum spanning tree query from a starting airport.
+ */
+struct TreeResult {
+    // Graph holding the tree, which owns its routes.
+    unique_ptr<Graph> mst;
+
+    // Routes of the tree in the order they were added.
+    vector<Route*> routes;
+
+    // IDs of airports that are not reachable from the starting airport.
+    vector<int> missing;
+
+    // Total cost of the routes.
+    double cost = 0;
+
+    // Percentage of all airports contained in the tree.
+    double coverage = 0;
+};
+
+/**
+ * Result of a coverage query from a starting airport.
+ */
+struct CoverageResult {
+    // Number of airports reachable from the starting airport, including it.
+    unsigned long num_reachable = 0;
+
+    // IDs of airports that are not reachable from the starting airport.
+    vector<int> missing;
+
+    // Percentage of all airports reachable from the starting airport.
+    double coverage = 0;
+};
+
+/**
+ * Result of a minimum spanning forest query over every airport.
+ */
+struct ForestResult {
+    // Graph holding the forest, which owns its routes.
+    unique_ptr<Graph> mst;
+
+    // Routes of the forest in the order they were added.
+    vector<Route*> routes;
+
+    // Trees of the forest in order of their smallest airport ID.
+    vector<ForestComponent> components;
+
+    // Total cost of the routes.
+    double cost = 0;
+};
+
+/**
+ * Finds the shortest path from one airport to the next in sequential order.
+ * @param graph Reference to graph to search.
+ * @param dest_ids Reference to vector of airport IDs to visit.
+ * @returns Routes of the path and whether it is complete.
+ */
+PathResult find_path(const Graph &graph, const vector<int> &dest_ids);
+
+/**
+ * Finds the largest minimum spanning tree from a starting airport.
+ * @param graph Reference to graph to search.
+ * @param start_id ID of starting airport.
+ * @returns Routes of the tree along with its cost and coverage.
+ */
+TreeResult find_tree(const Graph &graph, int start_id);
+
+/**
+ * Finds the airports a minimum spanning tree from a starting airport would
+ * contain, from the strongly connected components of the graph instead of
+ * growing the tree.
+ * @param graph Reference to graph to search.
+ * @param start_id ID of starting airport.
+ * @returns Number of reachable airports along with the missing airports.
+ */
+CoverageResult find_coverage(const Graph &graph, int start_id);
+
+/**
+ * Finds the minimum spanning forest covering every airport.
+ * @param graph Reference to graph to search.
+ * @returns Routes of the forest along with the cost of each tree.
+ */
+ForestResult find_forest(const Graph &graph);
+
+/**
+ * Returns if an airport ID exists in a graph.
+ * @param graph Reference to graph.
+ * @param id Airport ID to check.
+ * @returns Boolean representing if the airport exists or not.
+ */
+bool is_airport(const Graph &graph, int id);
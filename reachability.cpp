@@ -0,0 +1,174 @@
+/**
+ * @file reachability.cpp
+ * Implementation of strongly connected component reachability index class.
+ */
+
+#include <algorithm>
+
+#include "reachability.h"
+
+static const unsigned UNVISITED = static_cast<unsigned>(-1);
+
+void ReachabilityIndex::build(const CSR &csr) {
+    unsigned long n = csr.num_airports();
+    component.assign(n, UNVISITED);
+    sizes.clear();
+
+    // Tarjan's Algorithm with an explicit stack of airports being searched
+    // and the next route of each, so long chains cannot overflow the stack.
+    vector<unsigned> index(n, UNVISITED), lowlink(n);
+    vector<int> members;
+    vector<pair<int, unsigned>> calls;
+    unsigned next_index = 0;
+    for (unsigned long root = 0; root < n; root++) {
+        if (index[root] != UNVISITED) {
+            continue;
+        }
+        calls.emplace_back(root, csr.get_begin(root));
+        index[root] = lowlink[root] = next_index++;
+        members.push_back(root);
+
+        while (!calls.empty()) {
+            int current = calls.back().first;
+            unsigned &e = calls.back().second;
+            if (e < csr.get_end(current)) {
+                int next_id = csr.get_dest(e++);
+                if (index[next_id] == UNVISITED) {
+                    index[next_id] = lowlink[next_id] = next_index++;
+                    members.push_back(next_id);
+                    calls.emplace_back(next_id, csr.get_begin(next_id));
+                } else if (component[next_id] == UNVISITED) {
+                    lowlink[current] = std::min(lowlink[current], index[next_id]);
+                }
+                continue;
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) {
+                int caller = calls.back().first;
+                lowlink[caller] = std::min(lowlink[caller], lowlink[current]);
+            }
+            if (lowlink[current] == index[current]) {
+                unsigned id = sizes.size();
+                sizes.push_back(0);
+                int member;
+                do {
+                    member = members.back();
+                    members.pop_back();
+                    component[member] = id;
+                    sizes[id]++;
+                } while (member != current);
+            }
+        }
+    }
+
+    // Routes between components, each listed once per pair.
+    unsigned long num_components = sizes.size();
+    vector<vector<int>> airports(num_components);
+    for (unsigned long i = 0; i < n; i++) {
+        airports[component[i]].push_back(i);
+    }
+    dag_offsets.assign(1, 0);
+    dag_targets.clear();
+    vector<unsigned> last_source(num_components, UNVISITED);
+    for (unsigned c = 0; c < num_components; c++) {
+        for (int id : airports[c]) {
+            for (unsigned e = csr.get_begin(id); e < csr.get_end(id); e++) {
+                unsigned target = component[csr.get_dest(e)];
+                if (target != c && last_source[target] != c) {
+                    last_source[target] = c;
+                    dag_targets.push_back(target);
+                }
+            }
+        }
+        dag_offsets.push_back(dag_targets.size());
+    }
+
+    // Every component reached is numbered below the one reaching it, so
+    // the closure of each component is final before it is needed.
+    closure.clear();
+    closure_words = (num_components + 63) / 64;
+    if (num_components <= MAX_CLOSURE_COMPONENTS) {
+        closure.assign(num_components * closure_words, 0);
+        for (unsigned c = 0; c < num_components; c++) {
+            uint64_t *row = &closure[c * closure_words];
+            row[c / 64] |= (uint64_t)1 << (c % 64);
+            for (unsigned e = dag_offsets[c]; e < dag_offsets[c + 1]; e++) {
+                const uint64_t *target_row = &closure[dag_targets[e] * closure_words];
+                for (unsigned long w = 0; w <= dag_targets[e] / 64; w++) {
+                    row[w] |= target_row[w];
+                }
+            }
+        }
+    }
+}
+
+bool ReachabilityIndex::search(unsigned src, unsigned dest, SearchContext &context) const {
+    context.start_marks(sizes.size());
+    vector<unsigned> &stack = context.get_stack();
+    stack.push_back(src);
+    context.mark(src);
+    while (!stack.empty()) {
+        unsigned current = stack.back();
+        stack.pop_back();
+        for (unsigned e = dag_offsets[current]; e < dag_offsets[current + 1]; e++) {
+            unsigned target = dag_targets[e];
+            if (target == dest) {
+                return true;
+            }
+            if (target > dest && context.mark(target)) {
+                stack.push_back(target);
+            }
+        }
+    }
+    return false;
+}
+
+void ReachabilityIndex::mark(unsigned src, vector<char> &visited) const {
+    vector<unsigned> stack(1, src);
+    visited[src] = true;
+    while (!stack.empty()) {
+        unsigned current = stack.back();
+        stack.pop_back();
+        for (unsigned e = dag_offsets[current]; e < dag_offsets[current + 1]; e++) {
+            unsigned target = dag_targets[e];
+            if (!visited[target]) {
+                visited[target] = true;
+                stack.push_back(target);
+            }
+        }
+    }
+}
+
+vector<int> ReachabilityIndex::find_unreachable(int src_id) const {
+    unsigned src = component[src_id];
+    vector<char> visited(sizes.size(), false);
+    if (!closure.empty()) {
+        const uint64_t *row = &closure[src * closure_words];
+        for (unsigned c = 0; c < sizes.size(); c++) {
+            visited[c] = (row[c / 64] >> (c % 64)) & 1;
+        }
+    } else {
+        mark(src, visited);
+    }
+
+    vector<int> unreachable;
+    for (unsigned long i = 0; i < component.size(); i++) {
+        if (!visited[component[i]]) {
+            unreachable.push_back(i);
+        }
+    }
+    return unreachable;
+}
+
+unsigned long ReachabilityIndex::num_components() const {
+    return sizes.size();
+}
+
+unsigned long ReachabilityIndex::largest_component() const {
+    return sizes.empty() ? 0 : *std::max_element(sizes.begin(), sizes.end());
+}
+
+bool ReachabilityIndex::has_closure() const {
+    return !closure.empty();
+}
@@ -0,0 +1,138 @@
+/**
+ * @file reachability.h
+ * Definition of strongly connected component reachability index class.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "csr.h"
+#include "search.h"
+
+using namespace std;
+
+/**
+ * Index answering whether any path leads from one airport to another,
+ * without searching the routes.
+ *
+ * Airports are grouped into strongly connected components with Tarjan's
+ * Algorithm, so every airport of a component reaches every other one.
+ * Components are numbered in the order Tarjan's Algorithm completes them,
+ * which places every component after all components it reaches, and the
+ * routes between components form the condensation DAG. When there are
+ * few enough components, the set of components each one reaches is
+ * stored as a bitset computed in component order, and any query is a
+ * single bit test. Otherwise queries that the numbering or a shared
+ * component cannot answer search the condensation DAG, skipping every
+ * component numbered below the destination's, with the marks and stack of
+ * the caller's search context so that they allocate nothing.
+ * @author Vaibhav Gupta
+ */
+class ReachabilityIndex {
+    public:
+        // Most components whose closure is stored, taking 2MB.
+        static const unsigned long MAX_CLOSURE_COMPONENTS = 4096;
+
+        /**
+         * Builds the index of a graph, replacing any previous index.
+         * @param csr Reference to CSR graph.
+         */
+        void build(const CSR &csr);
+
+        /**
+         * Returns if a path leads from one airport to another. Every
+         * airport reaches itself.
+         * @param src_id ID of starting airport.
+         * @param dest_id ID of destination airport.
+         * @param context Reference to search context of the calling thread,
+         * used when the closure is not stored.
+         * @returns Boolean representing if the destination is reachable.
+         */
+        bool reaches(int src_id, int dest_id, SearchContext &context) const;
+
+        /**
+         * Finds every airport that no path from an airport leads to.
+         * @param src_id ID of starting airport.
+         * @returns IDs of unreachable airports in increasing order.
+         */
+        vector<int> find_unreachable(int src_id) const;
+
+        /**
+         * Returns the strongly connected component of an airport.
+         * @param id Airport ID.
+         * @returns Component index, below those of components reaching it.
+         */
+        unsigned get_component(int id) const;
+
+        /**
+         * Returns the number of strongly connected components.
+         * @returns Number of components, each airport without a cycle
+         * through it being its own.
+         */
+        unsigned long num_components() const;
+
+        /**
+         * Returns the number of airports of the largest component.
+         * @returns Number of airports.
+         */
+        unsigned long largest_component() const;
+
+        /**
+         * Returns if the set of components reached by every component is
+         * stored, so that every query is a bit test.
+         * @returns Boolean representing if the closure is stored or not.
+         */
+        bool has_closure() const;
+
+    private:
+        /**
+         * Helper function to search the condensation DAG from one component
+         * for another numbered below it.
+         * @param src Component to start from.
+         * @param dest Component to find.
+         * @param context Reference to search context to mark components in.
+         * @returns Boolean representing if the component was reached.
+         */
+        bool search(unsigned src, unsigned dest, SearchContext &context) const;
+
+        /**
+         * Helper function to mark every component reached from a component.
+         * @param src Component to start from.
+         * @param visited Reference to flag of each component to set.
+         */
+        void mark(unsigned src, vector<char> &visited) const;
+
+        vector<unsigned> component;
+        vector<unsigned> sizes;
+
+        // Components reached by a route from each component, stored
+        // consecutively without duplicates.
+        vector<unsigned> dag_offsets;
+        vector<unsigned> dag_targets;
+
+        // Bits of the components reached by each component, closure_words
+        // 64-bit words per component, empty when there are too many.
+        vector<uint64_t> closure;
+        unsigned long closure_words;
+};
+
+inline unsigned ReachabilityIndex::get_component(int id) const {
+    return component[id];
+}
+
+inline bool ReachabilityIndex::reaches(int src_id, int dest_id,
+        SearchContext &context) const {
+    unsigned src = component[src_id], dest = component[dest_id];
+    if (src == dest) {
+        return true;
+    }
+    if (src < dest) {
+        return false;
+    }
+    if (!closure.empty()) {
+        return (closure[src * closure_words + dest / 64] >> (dest % 64)) & 1;
+    }
+    return search(src, dest, context);
+}
@@ -7,10 +7,11 @@
 
 #include "route.h"
 
-Route::Route(Airport *src, Airport *dest, string label, double weight) {
+Route::Route(Airport *src, Airport *dest, const string &label, int airline, double weight) {
     this -> src = src;
     this -> dest = dest;
-    this -> label = label;
+    this -> label = &label;
+    this -> airline = airline;
     this -> weight = weight;
 }
 
@@ -22,14 +23,22 @@ Airport* Route::get_dest() const {
     return dest;
 }
 
-string Route::get_label() const {
-    return label;
+const string &Route::get_label() const {
+    return *label;
+}
+
+int Route::get_airline() const {
+    return airline;
 }
 
 double Route::get_weight() const {
     return weight;
 }
 
+void Route::set_weight(double weight) {
+    this -> weight = weight;
+}
+
 std::ostream &operator<<(std::ostream &os, const Route *route) {
     return os << route -> get_src() << " --- " << route -> get_label() << " [" 
         << route -> get_weight() << "]" << " --> " << route -> get_dest(); 
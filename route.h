@@ -22,11 +22,13 @@ class Route {
         * Constructor to create route based on flight.
         * @param src Pointer to source airport flight departs from.
         * @param dest Pointer to destination airport flight arrives to.
-        * @param label Name of flight airline.
+        * @param label Reference to interned name of flight airline, which
+        * must outlive the route.
+        * @param airline Airline ID of the interned name.
         * @param weight Cost of traveling from source airport to destination 
         * airport through airline.
         */
-        Route(Airport *src, Airport *dest, string label, double weight);
+        Route(Airport *src, Airport *dest, const string &label, int airline, double weight);
 
         /**
          * Returns pointer to source airport.
@@ -42,19 +44,32 @@ class Route {
 
         /**
          * Returns label of route.
-         * @returns Label of route.
+         * @returns Reference to label of route.
          */
-        string get_label() const;
+        const string &get_label() const;
+
+        /**
+         * Returns airline ID of route.
+         * @returns Airline ID in the dictionary of its graph.
+         */
+        int get_airline() const;
 
         /**
          * Returns cost of route.
          * @returns Cost of route.
          */
         double get_weight() const;
+
+        /**
+         * Sets cost of route.
+         * @param weight New cost of route.
+         */
+        void set_weight(double weight);
     
     private:
         Airport *src, *dest;
-        string label;
+        const string *label;
+        int airline;
         double weight;
 };
 
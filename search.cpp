@@ -0,0 +1,56 @@
+/**
+ * @file search.cpp
+ * Implementation of reusable search context class.
+ */
+
+#include <algorithm>
+
+#include "search.h"
+
+SearchContext::SearchContext() {
+    epoch = 0;
+    mark_epoch = 0;
+    num_settled = 0;
+    num_scanned = 0;
+}
+
+void SearchContext::append_path(const CSR &csr, int src_id, int dest_id) {
+    append_path(csr, predecessor, src_id, dest_id);
+}
+
+void SearchContext::append_path(const CSR &csr, const vector<unsigned> &incoming,
+        int src_id, int dest_id) {
+    unsigned long leg_start = path.size();
+    for (int current = dest_id; current != src_id; current = csr.get_src(incoming[current])) {
+        path.push_back(incoming[current]);
+    }
+    std::reverse(path.begin() + leg_start, path.end());
+}
+
+void SearchContext::clear_path() {
+    path.clear();
+}
+
+const vector<unsigned> &SearchContext::get_path() const {
+    return path;
+}
+
+HeapCounters SearchContext::get_heap_counters() const {
+    HeapCounters total = reverse != NULL ? reverse -> get_heap_counters() : HeapCounters();
+    for (const HeapCounters *counters : {&std::get<BinaryHeap>(heaps).get_counters(),
+            &std::get<QuaternaryHeap>(heaps).get_counters(),
+            &std::get<PairingHeap>(heaps).get_counters(),
+            &std::get<LazyHeap>(heaps).get_counters()}) {
+        total.pushes += counters -> pushes;
+        total.pops += counters -> pops;
+        total.decrease_keys += counters -> decrease_keys;
+    }
+    return total;
+}
+
+SearchContext &SearchContext::get_reverse() {
+    if (reverse == NULL) {
+        reverse.reset(new SearchContext());
+    }
+    return *reverse;
+}
@@ -0,0 +1,266 @@
+/**
+ * @file search.h
+ * Definition of reusable search context class.
+ */
+
+#pragma once
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "heap.h"
+#include "csr.h"
+
+using namespace std;
+
+// Point-to-point search algorithms selectable by the graph.
+enum class SearchType { DIJKSTRA, BIDIRECTIONAL, ALT, CH, LABELS, DELTA_STEPPING };
+
+/**
+ * Reusable state of shortest-path searches over a CSR graph.
+ *
+ * Settled airports are stamped with the epoch of the current search and
+ * costs live in epoch-stamped heaps, so starting a new search is O(1)
+ * instead of clearing or reallocating arrays for every airport. Once the
+ * arrays have grown to the size of the graph, searches and the paths they
+ * produce allocate nothing. A context must only be used by one thread at
+ * a time.
+ * @author Vaibhav Gupta
+ */
+class SearchContext {
+    public:
+        // Constructor to create an empty context, sized by the first search.
+        SearchContext();
+
+        /**
+         * Starts a new search from a source airport, forgetting the settled
+         * airports and costs of the previous search.
+         * @param num_airports Number of airports in the graph.
+         * @param src_id ID of source airport.
+         * @returns Reference to priority queue of the search, containing
+         * only the source airport.
+         */
+        template <class Queue>
+        Queue &start(unsigned long num_airports, int src_id);
+
+        /**
+         * Marks an airport as settled by the current search.
+         * @param id Airport ID.
+         */
+        void settle(int id);
+
+        /**
+         * Returns if an airport was settled by the current search.
+         * @param id Airport ID.
+         * @returns Boolean representing if airport is settled or not.
+         */
+        bool is_settled(int id) const;
+
+        /**
+         * Records the route through which an airport was last reached.
+         * @param id Airport ID.
+         * @param route Route index of incoming route.
+         */
+        void set_predecessor(int id, unsigned route);
+
+        /**
+         * Records the cost of the best path found so far to an airport, for
+         * searches whose heap is keyed by something other than that cost.
+         * @param id Airport ID.
+         * @param cost Cost of path from the source airport.
+         */
+        void set_distance(int id, double cost);
+
+        /**
+         * Returns the cost recorded by set_distance().
+         * @param id Airport ID reached by the current search.
+         * @returns Cost of path from the source airport.
+         */
+        double get_distance(int id) const;
+
+        /**
+         * Returns the number of airports settled by every search of this
+         * context and its reverse context, used to compare how much of the
+         * graph searches explore.
+         * @returns Number of airports settled.
+         */
+        unsigned long get_num_settled() const;
+
+        /**
+         * Counts routes examined while settling an airport.
+         * @param num_routes Number of routes scanned.
+         */
+        void scan(unsigned long num_routes);
+
+        /**
+         * Returns the number of routes scanned by every search of this
+         * context and its reverse context.
+         * @returns Number of routes scanned.
+         */
+        unsigned long get_num_scanned() const;
+
+        /**
+         * Returns the operations performed by the heaps of this context and
+         * its reverse context, summed over every heap type.
+         * @returns Heap counters.
+         */
+        HeapCounters get_heap_counters() const;
+
+        /**
+         * Returns the route through which an airport was last reached.
+         * @param id Airport ID reached by the current search.
+         * @returns Route index of incoming route.
+         */
+        unsigned get_predecessor(int id) const;
+
+        /**
+         * Appends the route indices of the path from the source airport of
+         * the current search to a settled airport onto the path.
+         * @param csr Reference to CSR graph that was searched.
+         * @param src_id ID of source airport.
+         * @param dest_id ID of settled destination airport.
+         */
+        void append_path(const CSR &csr, int src_id, int dest_id);
+
+        /**
+         * Appends the route indices of a path onto the path by following
+         * the incoming routes of a stored shortest-path tree.
+         * @param csr Reference to CSR graph that was searched.
+         * @param incoming Reference to incoming route index of each
+         * airport in the tree.
+         * @param src_id ID of source airport of the tree.
+         * @param dest_id ID of destination airport reached by the tree.
+         */
+        void append_path(const CSR &csr, const vector<unsigned> &incoming,
+            int src_id, int dest_id);
+
+        /**
+         * Appends a single route index onto the path.
+         * @param route Route index.
+         */
+        void append_route(unsigned route);
+
+        /**
+         * Empties the path built by append_path(), keeping its memory.
+         */
+        void clear_path();
+
+        /**
+         * Returns the route indices of the path built by append_path().
+         * @returns Reference to vector of route indices in travel order.
+         */
+        const vector<unsigned> &get_path() const;
+
+        /**
+         * Starts marking items, such as the components visited by a
+         * reachability query, forgetting the marks of the previous query.
+         * @param num_items Number of items that can be marked.
+         */
+        void start_marks(unsigned long num_items);
+
+        /**
+         * Marks an item for the current query.
+         * @param item Index of item.
+         * @returns Boolean representing if the item was not marked before.
+         */
+        bool mark(unsigned long item);
+
+        /**
+         * Returns a stack of items kept between queries, so that queries
+         * walking a graph of items allocate nothing once it has grown.
+         * @returns Reference to empty stack.
+         */
+        vector<unsigned> &get_stack();
+
+        /**
+         * Returns a second context owned by this one, used for the backward
+         * half of bidirectional searches. It is created on first use.
+         * @returns Reference to reverse context.
+         */
+        SearchContext &get_reverse();
+
+    private:
+        tuple<BinaryHeap, QuaternaryHeap, PairingHeap, LazyHeap> heaps;
+        vector<unsigned> settled;
+        vector<unsigned> predecessor;
+        vector<double> distance;
+        vector<unsigned> path;
+        unsigned epoch;
+        vector<unsigned> marks, stack;
+        unsigned mark_epoch;
+        unsigned long num_settled;
+        unsigned long num_scanned;
+        unique_ptr<SearchContext> reverse;
+};
+
+template <class Queue>
+Queue &SearchContext::start(unsigned long num_airports, int src_id) {
+    advance_epoch(settled, epoch, num_airports);
+    predecessor.resize(num_airports);
+    distance.resize(num_airports);
+
+    Queue &heap = std::get<Queue>(heaps);
+    heap.reset(num_airports, src_id);
+    return heap;
+}
+
+inline void SearchContext::settle(int id) {
+    settled[id] = epoch;
+    num_settled++;
+}
+
+inline bool SearchContext::is_settled(int id) const {
+    return settled[id] == epoch;
+}
+
+inline void SearchContext::set_predecessor(int id, unsigned route) {
+    predecessor[id] = route;
+}
+
+inline unsigned SearchContext::get_predecessor(int id) const {
+    return predecessor[id];
+}
+
+inline void SearchContext::set_distance(int id, double cost) {
+    distance[id] = cost;
+}
+
+inline double SearchContext::get_distance(int id) const {
+    return distance[id];
+}
+
+inline unsigned long SearchContext::get_num_settled() const {
+    return num_settled + (reverse != NULL ? reverse -> get_num_settled() : 0);
+}
+
+inline void SearchContext::scan(unsigned long num_routes) {
+    if (METRICS_COMPILED) {
+        num_scanned += num_routes;
+    }
+}
+
+inline unsigned long SearchContext::get_num_scanned() const {
+    return num_scanned + (reverse != NULL ? reverse -> get_num_scanned() : 0);
+}
+
+inline void SearchContext::start_marks(unsigned long num_items) {
+    advance_epoch(marks, mark_epoch, num_items);
+}
+
+inline bool SearchContext::mark(unsigned long item) {
+    if (marks[item] == mark_epoch) {
+        return false;
+    }
+    marks[item] = mark_epoch;
+    return true;
+}
+
+inline vector<unsigned> &SearchContext::get_stack() {
+    stack.clear();
+    return stack;
+}
+
+inline void SearchContext::append_route(unsigned route) {
+    path.push_back(route);
+}
@@ -0,0 +1,506 @@
+/**
+ * @file server.cpp
+ * Implementation of query server class.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "server.h"
+#include "queries.h"
+
+// Number of airports listed by a centrality request without airports.
+static const unsigned long TOP_CENTRALITIES = 10;
+
+// Maximum number of airports listed by a search request.
+static const unsigned long SEARCH_RESULTS = 10;
+
+// Wait before accepting again once descriptors or memory run out, for
+// open connections to close.
+static const chrono::milliseconds ACCEPT_BACKOFF(100);
+
+/**
+ * Query, airport IDs and search text of a parsed request.
+ */
+struct Request {
+    string query;
+    vector<int> airports;
+    string text;
+};
+
+/**
+ * Minimal reader for the flat JSON objects accepted as requests, whose
+ * values are strings, numbers or arrays of integers.
+ */
+class JSONReader {
+    public:
+        JSONReader(const string &text) : text(text), pos(0) {}
+
+        bool read_request(Request &request, string &error) {
+            if (!consume('{')) {
+                error = "expected JSON object";
+                return false;
+            }
+            if (consume('}')) {
+                return at_end(error);
+            }
+
+            do {
+                string key;
+                if (!read_string(key) || !consume(':')) {
+                    error = "expected key";
+                    return false;
+                }
+
+                if (key == "query") {
+                    if (!read_string(request.query)) {
+                        error = "query must be a string";
+                        return false;
+                    }
+                } else if (key == "text") {
+                    if (!read_string(request.text)) {
+                        error = "text must be a string";
+                        return false;
+                    }
+                } else if (key == "airport") {
+                    int id;
+                    if (!read_id(id)) {
+                        error = "airport must be an integer";
+                        return false;
+                    }
+                    request.airports.push_back(id);
+                } else if (key == "airports") {
+                    if (!read_ids(request.airports)) {
+                        error = "airports must be an array of integers";
+                        return false;
+                    }
+                } else if (!skip_value()) {
+                    error = "invalid value for " + key;
+                    return false;
+                }
+            } while (consume(','));
+
+            if (!consume('}')) {
+                error = "expected '}'";
+                return false;
+            }
+            return at_end(error);
+        }
+
+    private:
+        void skip_space() {
+            while (pos < text.size() && isspace((unsigned char)text[pos])) {
+                pos++;
+            }
+        }
+
+        bool consume(char c) {
+            skip_space();
+            if (pos < text.size() && text[pos] == c) {
+                pos++;
+                return true;
+            }
+            return false;
+        }
+
+        bool at_end(string &error) {
+            skip_space();
+            if (pos != text.size()) {
+                error = "unexpected text after JSON object";
+                return false;
+            }
+            return true;
+        }
+
+        bool read_string(string &value) {
+            if (!consume('"')) {
+                return false;
+            }
+            value.clear();
+            while (pos < text.size() && text[pos] != '"') {
+                if (text[pos] == '\\' && pos + 1 < text.size()) {
+                    pos++;
+                }
+                value += text[pos++];
+            }
+            return consume('"');
+        }
+
+        bool read_number(double &value) {
+            skip_space();
+            const char *start = text.c_str() + pos;
+            char *end;
+            value = strtod(start, &end);
+            if (end == start) {
+                return false;
+            }
+            pos += end - start;
+            return true;
+        }
+
+        bool read_id(int &id) {
+            double value;
+            if (!read_number(value) || value != std::floor(value) || 
+                    std::fabs(value) > numeric_limits<int>::max()) {
+                return false;
+            }
+            id = value;
+            return true;
+        }
+
+        bool read_ids(vector<int> &ids) {
+            if (!consume('[')) {
+                return false;
+            }
+            if (consume(']')) {
+                return true;
+            }
+            do {
+                int id;
+                if (!read_id(id)) {
+                    return false;
+                }
+                ids.push_back(id);
+            } while (consume(','));
+            return consume(']');
+        }
+
+        bool skip_value() {
+            skip_space();
+            if (pos < text.size() && text[pos] == '"') {
+                string ignored;
+                return read_string(ignored);
+            } else if (pos < text.size() && text[pos] == '[') {
+                vector<int> ignored;
+                return read_ids(ignored);
+            }
+            for (const string literal : {"true", "false", "null"}) {
+                if (text.compare(pos, literal.size(), literal) == 0) {
+                    pos += literal.size();
+                    return true;
+                }
+            }
+            double ignored;
+            return read_number(ignored);
+        }
+
+        const string &text;
+        unsigned long pos;
+};
+
+/**
+ * Helper function to parse a text request of a query name followed by
+ * airport IDs separated by spaces, or by the text to find for searches.
+ * @param line Request text.
+ * @param request Reference to request to fill.
+ * @param error Reference to string to store a parse error in.
+ * @returns Boolean representing if the request was parsed or not.
+ */
+static bool parse_text(const string &line, Request &request, string &error) {
+    stringstream tokens(line);
+    tokens >> request.query;
+    if (request.query == "search") {
+        std::getline(tokens >> std::ws, request.text);
+        return true;
+    }
+
+    string token;
+    while (tokens >> token) {
+        int id;
+        if (!CSVReader::parse_int(token, id)) {
+            error = "invalid airport ID '" + token + "'";
+            return false;
+        }
+        request.airports.push_back(id);
+    }
+    return true;
+}
+
+/**
+ * Helper function to write a string as a JSON string literal.
+ * @param out Reference to stream to write to.
+ * @param value String to write.
+ */
+static void write_string(ostream &out, string_view value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * Helper function to write routes as a JSON array.
+ * @param out Reference to stream to write to.
+ * @param routes Reference to vector of routes.
+ */
+static void write_routes(ostream &out, const vector<Route*> &routes) {
+    out << "[";
+    for (unsigned long i = 0; i < routes.size(); i++) {
+        out << (i > 0 ? "," : "") << "{\"src\":" << routes[i] -> get_src() -> get_id()
+            << ",\"dest\":" << routes[i] -> get_dest() -> get_id() << ",\"airline\":";
+        write_string(out, routes[i] -> get_label());
+        out << ",\"cost\":" << routes[i] -> get_weight() << "}";
+    }
+    out << "]";
+}
+
+/**
+ * Helper function to return a JSON error response.
+ * @param message Error message.
+ * @returns JSON error response.
+ */
+static string error_response(const string &message) {
+    stringstream out;
+    out << "{\"ok\":false,\"error\":";
+    write_string(out, message);
+    out << "}";
+    return out.str();
+}
+
+/**
+ * Helper function to check if a socket file was left by a server that is
+ * no longer listening, which refuses connections.
+ * @param address Reference to address of socket.
+ * @returns Boolean representing if the socket can be replaced or not.
+ */
+static bool is_stale_socket(const sockaddr_un &address) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return false;
+    }
+    bool refused = connect(fd, (const sockaddr*)&address, sizeof(address)) == -1 &&
+        errno == ECONNREFUSED;
+    close(fd);
+    return refused;
+}
+
+QueryServer::QueryServer(const Graph &graph) : graph(graph) {}
+
+void QueryServer::serve(istream &in, ostream &out) {
+    string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line == "quit") {
+            break;
+        } else if (!line.empty()) {
+            out << handle(line) << '\n' << flush;
+        }
+    }
+}
+
+bool QueryServer::serve_socket(const string &socket_path) {
+    sockaddr_un address = sockaddr_un();
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path too long: " << socket_path << endl;
+        return false;
+    }
+    socket_path.copy(address.sun_path, socket_path.size());
+
+    // Only the socket of a server that exited is replaced, never another
+    // file or the socket of a live server.
+    struct stat info;
+    if (lstat(socket_path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            cerr << "Could not listen on " << socket_path << ": Not a socket" << endl;
+            return false;
+        } else if (!is_stale_socket(address)) {
+            cerr << "Could not listen on " << socket_path << ": Address in use" << endl;
+            return false;
+        }
+        unlink(socket_path.c_str());
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == -1 || bind(listener, (sockaddr*)&address, sizeof(address)) == -1 ||
+            listen(listener, SOMAXCONN) == -1) {
+        perror(("Could not listen on " + socket_path).c_str());
+        if (listener != -1) {
+            close(listener);
+        }
+        return false;
+    }
+    cerr << "Listening on " << socket_path << endl;
+
+    // Connections aborted before being accepted are skipped, and running
+    // out of descriptors or memory is waited out, reported once per spell.
+    bool exhausted = false;
+    while (true) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) {
+                continue;
+            } else if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                if (!exhausted) {
+                    perror("Could not accept connection, retrying");
+                    exhausted = true;
+                }
+                this_thread::sleep_for(ACCEPT_BACKOFF);
+                continue;
+            }
+            perror("Could not accept connection");
+            close(listener);
+            return false;
+        }
+        exhausted = false;
+        thread(&QueryServer::serve_connection, this, fd).detach();
+    }
+}
+
+string QueryServer::handle(const string &request_text) {
+    Request request;
+    string error;
+    unsigned long start = request_text.find_first_not_of(" \t");
+    bool parsed = start != string::npos && request_text[start] == '{' ?
+        JSONReader(request_text).read_request(request, error) :
+        parse_text(request_text, request, error);
+    if (!parsed) {
+        return error_response(error);
+    }
+
+    for (int id : request.airports) {
+        if (!is_airport(graph, id)) {
+            return error_response("unknown airport ID " + to_string(id));
+        }
+    }
+
+    stringstream out;
+    out.precision(10);
+    if (request.query == "path") {
+        if (request.airports.size() < 2) {
+            return error_response("path requires at least two airports");
+        }
+
+        PathResult path = find_path(graph, request.airports);
+        out << "{\"ok\":true,\"query\":\"path\",\"complete\":"
+            << (path.complete ? "true" : "false") << ",\"cost\":" << path.cost << ",\"routes\":";
+        write_routes(out, path.routes);
+        out << "}";
+    } else if (request.query == "mst") {
+        if (request.airports.size() != 1) {
+            return error_response("mst requires one starting airport");
+        }
+
+        TreeResult tree = find_tree(graph, request.airports[0]);
+        out << "{\"ok\":true,\"query\":\"mst\",\"airports\":" << tree.routes.size() + 1
+            << ",\"coverage\":" << tree.coverage << ",\"cost\":" << tree.cost << ",\"missing\":[";
+        for (unsigned long i = 0; i < tree.missing.size(); i++) {
+            out << (i > 0 ? "," : "") << tree.missing[i];
+        }
+        out << "],\"routes\":";
+        write_routes(out, tree.routes);
+        out << "}";
+    } else if (request.query == "centrality") {
+        const vector<double> &scores = get_centralities();
+        vector<int> ids = request.airports;
+        if (ids.empty()) {
+            for (unsigned long i = 0; i < scores.size(); i++) {
+                ids.push_back(i);
+            }
+            unsigned long top = std::min(TOP_CENTRALITIES, ids.size());
+            std::partial_sort(ids.begin(), ids.begin() + top, ids.end(),
+                [&](int a, int b) { return scores[a] > scores[b]; });
+            ids.resize(top);
+        }
+
+        vector<Airport*> airports = graph.get_airports();
+        out << "{\"ok\":true,\"query\":\"centrality\",\"scores\":[";
+        for (unsigned long i = 0; i < ids.size(); i++) {
+            out << (i > 0 ? "," : "") << "{\"airport\":" << ids[i] << ",\"name\":";
+            write_string(out, airports[ids[i]] -> get_name());
+            out << ",\"centrality\":" << scores[ids[i]] << "}";
+        }
+        out << "]}";
+    } else if (request.query == "search") {
+        if (request.text.empty()) {
+            return error_response("search requires text");
+        }
+
+        vector<Airport*> airports = graph.get_airports();
+        vector<int> ids = graph.search_airports(request.text, SEARCH_RESULTS);
+        out << "{\"ok\":true,\"query\":\"search\",\"airports\":[";
+        for (unsigned long i = 0; i < ids.size(); i++) {
+            out << (i > 0 ? "," : "") << "{\"airport\":" << ids[i] << ",\"name\":";
+            write_string(out, airports[ids[i]] -> get_name());
+            out << ",\"city\":";
+            write_string(out, airports[ids[i]] -> get_city());
+            out << "}";
+        }
+        out << "]}";
+    } else if (request.query == "stats") {
+        PathCacheStats stats = graph.get_path_cache_stats();
+        out << "{\"ok\":true,\"query\":\"stats\",\"path_cache\":{\"hits\":" << stats.hits
+            << ",\"misses\":" << stats.misses << ",\"evictions\":" << stats.evictions
+            << ",\"entries\":" << stats.entries << ",\"bytes\":" << stats.bytes
+            << ",\"budget\":" << stats.budget << "},\"metrics\":";
+        graph.get_metrics().write_json(out);
+        out << "}";
+    } else {
+        return error_response("unknown query '" + request.query +
+            "', expected path, mst, centrality, search or stats");
+    }
+    return out.str();
+}
+
+void QueryServer::serve_connection(int fd) {
+    string buffer;
+    char chunk[4096];
+    bool open = true;
+    while (open) {
+        long received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            break;
+        }
+        buffer.append(chunk, received);
+
+        unsigned long newline;
+        while (open && (newline = buffer.find('\n')) != string::npos) {
+            string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line == "quit") {
+                open = false;
+            } else if (!line.empty()) {
+                string response = handle(line) + '\n';
+                for (unsigned long sent = 0; open && sent < response.size(); ) {
+                    long written = send(fd, response.data() + sent, response.size() - sent,
+                        MSG_NOSIGNAL);
+                    open = written > 0;
+                    sent += written > 0 ? written : 0;
+                }
+            }
+        }
+    }
+    close(fd);
+}
+
+const vector<double> &QueryServer::get_centralities() {
+    std::call_once(centralities_computed, [this]() {
+        centralities = graph.brandes();
+    });
+    return centralities;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file server.h
+ * Definition of query server class.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+
+using namespace std;
+
+/**
+ * Long-running server that answers queries against a graph loaded once.
+ *
+ * Requests are newline-delimited, either as text such as "path 200 124",
+ * "mst 200", "centrality 200", "search chicago" and "stats", or as JSON
+ * objects such as {"query": "path", "airports": [200, 124]}. Each request
+ * is answered with one line of JSON, written as soon as it is computed.
+ * @author Vaibhav Gupta
+ */
+class QueryServer {
+    public:
+        /**
+         * Constructor to create a server for a graph.
+         * @param graph Reference to initialized graph, which must outlive
+         * the server.
+         */
+        QueryServer(const Graph &graph);
+
+        /**
+         * Answers requests read from a stream until it ends or a
+         * "quit" request is read.
+         * @param in Reference to stream to read requests from.
+         * @param out Reference to stream to write responses to.
+         */
+        void serve(istream &in, ostream &out);
+
+        /**
+         * Listens on a Unix domain socket and answers the requests of each
+         * connection on its own thread. Only returns on error.
+         * @param socket_path File path of socket, which may only exist as
+         * the socket of a server no longer listening, and is then replaced.
+         * @returns False if the socket could not be created.
+         */
+        bool serve_socket(const string &socket_path);
+
+        /**
+         * Answers a single request.
+         * @param request Request without its newline.
+         * @returns JSON response without a newline.
+         */
+        string handle(const string &request);
+
+    private:
+        /**
+         * Helper function to answer the requests of one socket connection.
+         * @param fd File descriptor of connection, closed when done.
+         */
+        void serve_connection(int fd);
+
+        /**
+         * Helper function to return the centrality of every airport,
+         * computing it on first use.
+         * @returns Reference to centrality of each airport.
+         */
+        const vector<double> &get_centralities();
+
+        const Graph &graph;
+        vector<double> centralities;
+        once_flag centralities_computed;
+};
@@ -0,0 +1,284 @@
+/**
+ * @file snapshot.cpp
+ * Implementation of binary graph snapshot classes.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+#include "snapshot.h"
+
+static const char MAGIC[8] = {'A', 'I', 'R', 'G', 'R', 'A', 'P', 'H'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * Fixed-size header at the start of every snapshot. Positions are byte
+ * offsets from the start of the file.
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    DatasetFingerprint dataset;
+    uint64_t num_airports, num_routes, num_airlines;
+    uint64_t offsets_pos, srcs_pos, dests_pos, weights_pos, airline_ids_pos;
+    uint64_t string_index_pos, strings_pos, strings_size;
+    uint64_t file_size;
+};
+
+/**
+ * Helper function to return the modification time of a file in
+ * nanoseconds, so edits within the same second change the fingerprint.
+ * @param info Reference to status of the file.
+ * @returns Nanoseconds since the epoch.
+ */
+static uint64_t mtime_nanoseconds(const struct stat &info) {
+    return (uint64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+}
+
+DatasetFingerprint DatasetFingerprint::of(const string &airports_path,
+        const string &routes_path) {
+    DatasetFingerprint fingerprint;
+    struct stat airports_info, routes_info;
+    if (stat(airports_path.c_str(), &airports_info) == 0 &&
+            stat(routes_path.c_str(), &routes_info) == 0) {
+        fingerprint.airports_size = airports_info.st_size;
+        fingerprint.airports_mtime = mtime_nanoseconds(airports_info);
+        fingerprint.airports_inode = airports_info.st_ino;
+        fingerprint.routes_size = routes_info.st_size;
+        fingerprint.routes_mtime = mtime_nanoseconds(routes_info);
+        fingerprint.routes_inode = routes_info.st_ino;
+    }
+    return fingerprint;
+}
+
+bool DatasetFingerprint::empty() const {
+    return airports_size == 0 && routes_size == 0;
+}
+
+bool DatasetFingerprint::matches(const DatasetFingerprint &other) const {
+    return empty() || (airports_size == other.airports_size &&
+        airports_mtime == other.airports_mtime && airports_inode == other.airports_inode &&
+        routes_size == other.routes_size && routes_mtime == other.routes_mtime &&
+        routes_inode == other.routes_inode);
+}
+
+/**
+ * Helper function to append an array to a snapshot file at the next
+ * 8-byte boundary.
+ * @param file Reference to output file.
+ * @param data Pointer to array.
+ * @param bytes Size of array in bytes.
+ * @returns Byte offset the array was written at.
+ */
+static uint64_t write_section(ofstream &file, const void *data, uint64_t bytes) {
+    static const char padding[8] = {0};
+    uint64_t pos = file.tellp();
+    if (pos % 8 != 0) {
+        file.write(padding, 8 - pos % 8);
+        pos += 8 - pos % 8;
+    }
+    file.write(static_cast<const char*>(data), bytes);
+    return pos;
+}
+
+bool Snapshot::write(const string &file_path, const CSR &csr,
+        const vector<Airport*> &airports, const DatasetFingerprint &dataset) {
+    SnapshotHeader header = SnapshotHeader();
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.dataset = dataset;
+    header.num_airports = csr.num_airports();
+    header.num_routes = csr.num_routes();
+    header.num_airlines = csr.num_airlines();
+
+    // Names, then cities, then airline names, each indexed by its start.
+    string strings;
+    vector<uint64_t> string_index;
+    for (unsigned long i = 0; i < csr.num_airports(); i++) {
+        string_index.push_back(strings.size());
+        strings += airports[i] != NULL ? airports[i] -> get_name() : "";
+    }
+    for (unsigned long i = 0; i < csr.num_airports(); i++) {
+        string_index.push_back(strings.size());
+        strings += airports[i] != NULL ? airports[i] -> get_city() : "";
+    }
+    for (unsigned long i = 0; i < csr.num_airlines(); i++) {
+        string_index.push_back(strings.size());
+        strings += csr.get_airline_name(i);
+    }
+    string_index.push_back(strings.size());
+
+    const string temp_path = file_path + ".tmp";
+    ofstream file(temp_path, ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    header.offsets_pos = write_section(file, csr.get_offsets(),
+        (csr.num_airports() + 1) * sizeof(unsigned));
+    header.srcs_pos = write_section(file, csr.get_srcs(), csr.num_routes() * sizeof(int));
+    header.dests_pos = write_section(file, csr.get_dests(), csr.num_routes() * sizeof(int));
+    header.weights_pos = write_section(file, csr.get_weights(),
+        csr.num_routes() * sizeof(double));
+    header.airline_ids_pos = write_section(file, csr.get_airline_ids(),
+        csr.num_routes() * sizeof(int));
+    header.string_index_pos = write_section(file, string_index.data(),
+        string_index.size() * sizeof(uint64_t));
+    header.strings_pos = write_section(file, strings.data(), strings.size());
+    header.strings_size = strings.size();
+    header.file_size = file.tellp();
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return std::rename(temp_path.c_str(), file_path.c_str()) == 0;
+}
+
+bool Snapshot::open(const string &file_path) {
+    header = NULL;
+    if (!file.open(file_path) || file.size() < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    const SnapshotHeader *candidate = reinterpret_cast<const SnapshotHeader*>(file.data());
+    if (memcmp(candidate -> magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            candidate -> version != VERSION || candidate -> byte_order != BYTE_ORDER_MARK ||
+            candidate -> file_size != file.size()) {
+        file.close();
+        return false;
+    }
+
+    // Every section must be aligned and lie within the file before any of it is read.
+    uint64_t airports = candidate -> num_airports, routes = candidate -> num_routes;
+    uint64_t strings = 2 * airports + candidate -> num_airlines + 1;
+    uint64_t ends[] = {
+        candidate -> offsets_pos + (airports + 1) * sizeof(unsigned),
+        candidate -> srcs_pos + routes * sizeof(int),
+        candidate -> dests_pos + routes * sizeof(int),
+        candidate -> weights_pos + routes * sizeof(double),
+        candidate -> airline_ids_pos + routes * sizeof(int),
+        candidate -> string_index_pos + strings * sizeof(uint64_t),
+        candidate -> strings_pos + candidate -> strings_size
+    };
+    uint64_t positions[] = {
+        candidate -> offsets_pos, candidate -> srcs_pos, candidate -> dests_pos,
+        candidate -> weights_pos, candidate -> airline_ids_pos, candidate -> string_index_pos
+    };
+    for (uint64_t end : ends) {
+        if (end > file.size()) {
+            file.close();
+            return false;
+        }
+    }
+    for (uint64_t pos : positions) {
+        if (pos % 8 != 0) {
+            file.close();
+            return false;
+        }
+    }
+
+    header = candidate;
+    if (!validate()) {
+        header = NULL;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+DatasetFingerprint Snapshot::get_dataset() const {
+    return header -> dataset;
+}
+
+unsigned long Snapshot::num_airports() const {
+    return header -> num_airports;
+}
+
+unsigned long Snapshot::num_routes() const {
+    return header -> num_routes;
+}
+
+unsigned long Snapshot::num_airlines() const {
+    return header -> num_airlines;
+}
+
+const unsigned *Snapshot::get_offsets() const {
+    return section<unsigned>(header -> offsets_pos);
+}
+
+const int *Snapshot::get_srcs() const {
+    return section<int>(header -> srcs_pos);
+}
+
+const int *Snapshot::get_dests() const {
+    return section<int>(header -> dests_pos);
+}
+
+const double *Snapshot::get_weights() const {
+    return section<double>(header -> weights_pos);
+}
+
+const int *Snapshot::get_airline_ids() const {
+    return section<int>(header -> airline_ids_pos);
+}
+
+string_view Snapshot::get_name(int id) const {
+    return get_string(id);
+}
+
+string_view Snapshot::get_city(int id) const {
+    return get_string(header -> num_airports + id);
+}
+
+string_view Snapshot::get_airline_name(int airline) const {
+    return get_string(2 * header -> num_airports + airline);
+}
+
+string_view Snapshot::get_string(unsigned long idx) const {
+    const uint64_t *index = section<uint64_t>(header -> string_index_pos);
+    const char *strings = section<char>(header -> strings_pos);
+    return string_view(strings + index[idx], index[idx + 1] - index[idx]);
+}
+
+bool Snapshot::validate() const {
+    const unsigned *offsets = get_offsets();
+    const int *srcs = get_srcs(), *dests = get_dests(), *airline_ids = get_airline_ids();
+    if (offsets[0] != 0 || offsets[num_airports()] != num_routes()) {
+        return false;
+    }
+    for (unsigned long i = 0; i < num_airports(); i++) {
+        if (offsets[i] > offsets[i + 1]) {
+            return false;
+        }
+        for (unsigned e = offsets[i]; e < offsets[i + 1]; e++) {
+            if ((unsigned long)srcs[e] != i || dests[e] < 0 ||
+                    (unsigned long)dests[e] >= num_airports() || airline_ids[e] < 0 ||
+                    (unsigned long)airline_ids[e] >= num_airlines()) {
+                return false;
+            }
+        }
+    }
+
+    const uint64_t *index = section<uint64_t>(header -> string_index_pos);
+    unsigned long num_strings = 2 * num_airports() + num_airlines();
+    for (unsigned long i = 0; i < num_strings; i++) {
+        if (index[i] > index[i + 1]) {
+            return false;
+        }
+    }
+    return index[0] == 0 && index[num_strings] == header -> strings_size;
+}
+
+template <typename T>
+const T *Snapshot::section(uint64_t pos) const {
+    return reinterpret_cast<const T*>(file.data() + pos);
+}
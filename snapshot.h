@@ -0,0 +1,189 @@
+/**
+ * @file snapshot.h
+ * Definition of binary graph snapshot classes.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "csr.h"
+#include "mapped_file.h"
+
+using namespace std;
+
+/**
+ * Identifies the version of the CSV dataset a snapshot was written from
+ * by the size, modification time in nanoseconds and inode of each file,
+ * so edits within the same second and files replaced by renaming are both
+ * told apart.
+ * @author Vaibhav Gupta
+ */
+struct DatasetFingerprint {
+    uint64_t airports_size = 0, airports_mtime = 0, airports_inode = 0;
+    uint64_t routes_size = 0, routes_mtime = 0, routes_inode = 0;
+
+    /**
+     * Returns fingerprint of the current airport and route datasets.
+     * @param airports_path File path of airport dataset.
+     * @param routes_path File path of route dataset.
+     * @returns Fingerprint of the datasets, empty if either is missing.
+     */
+    static DatasetFingerprint of(const string &airports_path, const string &routes_path);
+
+    /**
+     * Returns if the fingerprint identifies no dataset, which happens
+     * when the CSV files are not available.
+     * @returns Boolean representing if the fingerprint is empty or not.
+     */
+    bool empty() const;
+
+    /**
+     * Returns if a snapshot written from another dataset can be used in
+     * place of this one. An empty fingerprint accepts any dataset.
+     * @param other Fingerprint stored in a snapshot.
+     * @returns Boolean representing if the datasets match or not.
+     */
+    bool matches(const DatasetFingerprint &other) const;
+};
+
+struct SnapshotHeader;
+
+/**
+ * Versioned binary snapshot of the graph that is memory-mapped and used
+ * in place, without parsing.
+ *
+ * The file holds a fixed header, the CSR arrays of the graph, and a
+ * string table of airport names, cities and airline names. All sections
+ * are 8-byte aligned and stored in native byte order, which the header
+ * records so snapshots from a different architecture are rejected.
+ * @author Vaibhav Gupta
+ */
+class Snapshot {
+    public:
+        // Version of the file layout, increased on every incompatible change.
+        static const uint32_t VERSION = 2;
+
+        /**
+         * Writes a snapshot of a graph. The file is written under a temporary
+         * name and renamed, so readers never see a partial snapshot.
+         * @param file_path File path to write.
+         * @param csr Reference to CSR snapshot of the graph.
+         * @param airports Reference to vector of pointers to airports.
+         * @param dataset Fingerprint of the dataset the graph was read from.
+         * @returns Boolean representing if the snapshot was written or not.
+         */
+        static bool write(const string &file_path, const CSR &csr,
+            const vector<Airport*> &airports, const DatasetFingerprint &dataset);
+
+        /**
+         * Maps and validates a snapshot file.
+         * @param file_path File path to open.
+         * @returns Boolean representing if the snapshot is usable or not.
+         */
+        bool open(const string &file_path);
+
+        /**
+         * Returns fingerprint of the dataset the snapshot was written from.
+         * @returns Dataset fingerprint.
+         */
+        DatasetFingerprint get_dataset() const;
+
+        /**
+         * Returns number of airports in the snapshot.
+         * @returns Number of airports.
+         */
+        unsigned long num_airports() const;
+
+        /**
+         * Returns number of routes in the snapshot.
+         * @returns Number of routes.
+         */
+        unsigned long num_routes() const;
+
+        /**
+         * Returns number of airlines in the snapshot.
+         * @returns Number of airlines.
+         */
+        unsigned long num_airlines() const;
+
+        /**
+         * Returns pointer to the mapped route offsets of every airport.
+         * @returns Pointer to num_airports() + 1 offsets.
+         */
+        const unsigned *get_offsets() const;
+
+        /**
+         * Returns pointer to the mapped source airport ID of every route.
+         * @returns Pointer to num_routes() source IDs.
+         */
+        const int *get_srcs() const;
+
+        /**
+         * Returns pointer to the mapped destination airport ID of every route.
+         * @returns Pointer to num_routes() destination IDs.
+         */
+        const int *get_dests() const;
+
+        /**
+         * Returns pointer to the mapped cost of every route.
+         * @returns Pointer to num_routes() costs.
+         */
+        const double *get_weights() const;
+
+        /**
+         * Returns pointer to the mapped airline ID of every route.
+         * @returns Pointer to num_routes() airline IDs.
+         */
+        const int *get_airline_ids() const;
+
+        /**
+         * Returns name of an airport.
+         * @param id Airport ID.
+         * @returns View of name of airport in the mapped file.
+         */
+        string_view get_name(int id) const;
+
+        /**
+         * Returns city of an airport.
+         * @param id Airport ID.
+         * @returns View of city of airport in the mapped file.
+         */
+        string_view get_city(int id) const;
+
+        /**
+         * Returns name of an airline.
+         * @param airline Airline ID.
+         * @returns View of name of airline in the mapped file.
+         */
+        string_view get_airline_name(int airline) const;
+
+    private:
+        /**
+         * Helper function to return an entry of the string table.
+         * @param idx Index of string.
+         * @returns View of string at index.
+         */
+        string_view get_string(unsigned long idx) const;
+
+        /**
+         * Helper function to check that every offset and ID in the
+         * mapped arrays is in range.
+         * @returns Boolean representing if the arrays are consistent or not.
+         */
+        bool validate() const;
+
+        /**
+         * Helper function to return a pointer to a section of the file.
+         * @param pos Byte offset of section.
+         * @returns Pointer to section.
+         */
+        template <typename T>
+        const T *section(uint64_t pos) const;
+
+        MappedFile file;
+        const SnapshotHeader *header = NULL;
+};
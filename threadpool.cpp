@@ -0,0 +1,135 @@
+/**
+ * @file threadpool.cpp
+ * Implementation of thread pool class.
+ */
+
+#include <algorithm>
+
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(unsigned num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, thread::hardware_concurrency());
+    }
+
+    ranges.reset(new Range[num_threads]);
+    task = NULL;
+    generation = 0;
+    active = 0;
+    stopping = false;
+
+    for (unsigned i = 1; i < num_threads; i++) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(unsigned long n, const function<void(unsigned long)> &task) {
+    parallel_for(n, [&task](unsigned long i, unsigned) { task(i); });
+}
+
+void ThreadPool::parallel_for(unsigned long n,
+        const function<void(unsigned long, unsigned)> &task) {
+    if (n == 0) {
+        return;
+    }
+    if (workers.empty() || n == 1) {
+        for (unsigned long i = 0; i < n; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    {
+        unique_lock<mutex> guard(lock);
+        this -> task = &task;
+        for (unsigned t = 0; t < size(); t++) {
+            ranges[t].begin = n * t / size();
+            ranges[t].end = n * (t + 1) / size();
+        }
+        active = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    run_iterations(0);
+
+    unique_lock<mutex> guard(lock);
+    done.wait(guard, [this]() { return active == 0; });
+    this -> task = NULL;
+}
+
+unsigned ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::work(unsigned index) {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        run_iterations(index);
+
+        unique_lock<mutex> guard(lock);
+        if (--active == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run_iterations(unsigned index) {
+    Range &own = ranges[index];
+    do {
+        while (true) {
+            unsigned long i;
+            {
+                unique_lock<mutex> guard(own.lock);
+                if (own.begin == own.end) {
+                    break;
+                }
+                i = own.begin++;
+            }
+            (*task)(i, index);
+        }
+    } while (steal(index));
+}
+
+bool ThreadPool::steal(unsigned index) {
+    for (unsigned offset = 1; offset < size(); offset++) {
+        Range &victim = ranges[(index + offset) % size()];
+        unsigned long begin, end;
+        {
+            unique_lock<mutex> guard(victim.lock);
+            if (victim.begin == victim.end) {
+                continue;
+            }
+            end = victim.end;
+            begin = victim.end - (victim.end - victim.begin + 1) / 2;
+            victim.end = begin;
+        }
+
+        Range &own = ranges[index];
+        unique_lock<mutex> guard(own.lock);
+        own.begin = begin;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file threadpool.h
+ * Definition of thread pool class.
+ */
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+/**
+ * Fixed set of worker threads that run the iterations of a loop
+ * in parallel. The calling thread also takes part in every loop.
+ *
+ * Each thread starts with its own contiguous range of iterations and,
+ * once that runs out, steals the back half of the remaining range of
+ * another thread, so uneven iterations stay balanced without
+ * every claim contending on one shared counter.
+ * @author Vaibhav Gupta
+ */
+class ThreadPool {
+    public:
+        /**
+         * Constructor to create a thread pool.
+         * @param num_threads Number of threads including the caller,
+         * 0 for one per core.
+         */
+        ThreadPool(unsigned num_threads = 0);
+
+        // Destructor to stop and join worker threads.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+
+        /**
+         * Runs a task for every index in [0, n) and waits for all of
+         * them to complete. Indices are claimed dynamically, so tasks
+         * of uneven length are balanced between threads.
+         * @param n Number of iterations.
+         * @param task Function called with each iteration index.
+         */
+        void parallel_for(unsigned long n, const function<void(unsigned long)> &task);
+
+        /**
+         * Runs a task for every index in [0, n) like parallel_for(), also
+         * passing the index of the thread running it so that tasks can
+         * reuse per-thread scratch state.
+         * @param n Number of iterations.
+         * @param task Function called with each iteration index and a
+         * thread index in [0, size()), which no other thread uses at
+         * the same time.
+         */
+        void parallel_for(unsigned long n,
+            const function<void(unsigned long, unsigned)> &task);
+
+        /**
+         * Returns number of threads that run tasks, including the caller.
+         * @returns Number of threads.
+         */
+        unsigned size() const;
+
+    private:
+        /**
+         * Iterations [begin, end) not yet claimed by one thread, padded
+         * to a cache line so neighbouring ranges do not share one.
+         */
+        struct alignas(64) Range {
+            mutex lock;
+            unsigned long begin = 0;
+            unsigned long end = 0;
+        };
+
+        /**
+         * Helper function run by each worker thread.
+         * @param index Thread index of worker.
+         */
+        void work(unsigned index);
+
+        /**
+         * Helper function to claim and run iterations of the current loop,
+         * first from the thread's own range and then from other threads.
+         * @param index Thread index of caller.
+         */
+        void run_iterations(unsigned index);
+
+        /**
+         * Helper function to move the back half of the remaining range of
+         * another thread into a thread's own range.
+         * @param index Thread index of thief.
+         * @returns Boolean representing if any iterations were stolen or not.
+         */
+        bool steal(unsigned index);
+
+        vector<thread> workers;
+        unique_ptr<Range[]> ranges;
+        mutex lock;
+        condition_variable wake, done;
+
+        const function<void(unsigned long, unsigned)> *task;
+        unsigned long generation;
+        unsigned active;
+        bool stopping;
+};